@@ -7,6 +7,34 @@
 #define LED_STRIP_GPIO 5
 #endif
 
+// Number of parallel LED data outputs (1, 2 or 4). The panel chain is split
+// into equal contiguous spans, one per output, in chain order: output 0 on
+// LED_STRIP_GPIO, then LED_STRIP_GPIO_2..4. Each span must start on a tile
+// boundary, so wire each 8x32 tile (or tile group) to its own pin.
+#ifndef APP_LED_OUTPUTS
+#define APP_LED_OUTPUTS 1
+#endif
+#ifndef LED_STRIP_GPIO_2
+#define LED_STRIP_GPIO_2 18
+#endif
+#ifndef LED_STRIP_GPIO_3
+#define LED_STRIP_GPIO_3 19
+#endif
+#ifndef LED_STRIP_GPIO_4
+#define LED_STRIP_GPIO_4 21
+#endif
+
+// Hand finished frames to a dedicated LED output task on core 1 (double
+// buffered) instead of calling FastLED.show() from the scroll loop.
+#ifndef APP_LED_OUTPUT_TASK
+#define APP_LED_OUTPUT_TASK 1
+#endif
+
+// Per-refresh parse scratch reserved once at boot (RSS payload + JSON tree).
+#ifndef APP_RSS_SCRATCH_BYTES
+#define APP_RSS_SCRATCH_BYTES (96 * 1024)
+#endif
+
 constexpr uint16_t APP_MATRIX_WIDTH = 128;
 constexpr uint8_t APP_MATRIX_HEIGHT = 8;
 constexpr uint8_t APP_DEFAULT_BRIGHTNESS = 72;
@@ -38,7 +38,9 @@ struct AppSettings {
   char rssUrl[APP_MAX_URL_LEN + 1];
   bool rssNprEnabled;
   bool rssRandomEnabled;
+  bool rssLivePriorityEnabled;
   bool rssSportsEnabled;
+  bool rssSportsBatchEnabled;
   char rssSportsBaseUrl[APP_MAX_URL_LEN + 1];
   bool rssSportMlbEnabled;
   bool rssSportNhlEnabled;
@@ -50,10 +52,35 @@ struct AppSettings {
   char otaManifestUrl[APP_MAX_URL_LEN + 1];
 };
 
+enum class RssSourceKind : uint8_t {
+  News = 0,
+  Sport,
+  Weather,
+};
+
+enum class RssLeague : uint8_t {
+  None = 0,
+  Mlb,
+  Nhl,
+  Ncaaf,
+  Nfl,
+  Nba,
+  Big10,
+};
+
+enum class RssDisplayMode : uint8_t {
+  TitleThenDescription = 0,  // title segment, then description segment
+  SingleSegment,             // title + description in one segment (scores)
+};
+
 struct RssSource {
   char name[APP_RSS_SOURCE_NAME_LEN + 1];
   char url[APP_MAX_URL_LEN + 1];
   bool enabled;
+  RssSourceKind kind;
+  RssLeague league;
+  RssDisplayMode displayMode;
+  bool batched;  // refreshed through the shared multi-league sports request
 };
 
 struct RssItem {
@@ -65,6 +92,11 @@ struct RssItem {
 enum RssItemFlags : uint8_t {
   RssItemFlagNone = 0,
   RssItemFlagLive = 0x01,
+  RssItemFlagFinal = 0x02,
+  RssItemFlagScheduled = 0x04,
+  RssItemFlagPostponed = 0x08,
+  RssItemFlagStateMask = 0x0F,
+  RssItemFlagClassified = 0x80,  // set once classifyRssItem() has run
 };
 
 #endif
@@ -0,0 +1,64 @@
+#ifndef CLOCK_KEEPER_H
+#define CLOCK_KEEPER_H
+
+#include <Arduino.h>
+#include <sys/time.h>
+#include <time.h>
+
+struct ClockStats {
+  bool synced;
+  bool restored;  // time base came from RTC memory after a soft reset
+  bool waiting;   // an SNTP request is out without a reply yet
+  uint32_t syncs;
+  int32_t lastOffsetMs;  // server time minus our estimate at the last sync
+  float driftPpm;
+  uint32_t resyncIntervalMs;
+  uint32_t lastSyncEpoch;
+};
+
+// Wall clock for the time interstitial. startSync() (re)starts lwIP's SNTP
+// client and returns at once; its completion callback only stamps the server
+// time, and poll() folds that into the time base on the caller's task.
+// Between syncs the time is extrapolated from millis() corrected by the drift
+// measured across earlier syncs, and the resync interval doubles while each
+// sync lands close to the estimate. The base is mirrored into RTC memory so
+// a soft reset keeps a valid clock without waiting for the network.
+class ClockKeeper {
+public:
+  ClockKeeper();
+
+  // Sets the zone and restores the RTC-memory base; true when restored.
+  bool begin(const char* tz);
+  void startSync(const char* server1, const char* server2, const char* server3);
+  // Applies a completed sync; returns true when one was applied.
+  bool poll();
+
+  bool synced() const;
+  bool waiting() const;
+  time_t now() const;
+  // 0 once a resync is due; only meaningful when synced().
+  uint32_t msUntilResync(uint32_t nowMs) const;
+  void stats(ClockStats& outStats) const;
+
+private:
+  static void onTimeSync(struct timeval* tv);
+  int64_t estimateEpochMs(uint32_t atMs) const;
+  bool restore();
+  void persist() const;
+
+  const char* _tz;
+  bool _synced;
+  bool _restored;
+  bool _waiting;
+  bool _baseMeasured;  // base is an SNTP reply, so drift can be measured from it
+  int64_t _baseEpochMs;
+  uint32_t _baseMs;
+  uint32_t _resyncDueMs;
+  float _driftPpm;
+  uint32_t _resyncIntervalMs;
+  uint32_t _syncs;
+  int32_t _lastOffsetMs;
+  uint32_t _lastSyncEpoch;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <Arduino.h>
+
+// Standard CRC-32 (IEEE 802.3, reflected 0xEDB88320). Pass the previous
+// return value as `crc` to checksum data incrementally; start from 0.
+uint32_t crc32Update(uint32_t crc, const void* data, size_t length);
+
+inline uint32_t crc32Compute(const void* data, size_t length) {
+  return crc32Update(0, data, length);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef DELTA_PATCHER_H
+#define DELTA_PATCHER_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+#include "Inflater.h"
+
+// Applies an "MCDELTA1" firmware patch while it downloads. The patch is a
+// 16-byte header (magic, new size, old size) followed by a zlib stream of
+// bsdiff-style records: u32 add, u32 copy, i32 seek (little-endian), then
+// `add` bytes added to the old image and `copy` literal bytes. Old bytes come
+// from the source partition; new bytes go to `write` in order.
+class DeltaPatcher {
+public:
+  using WriteFn = bool (*)(const uint8_t* data, size_t length, void* context);
+
+  static constexpr size_t kHeaderSize = 16;
+
+  DeltaPatcher();
+
+  bool begin(const esp_partition_t* source, WriteFn write, void* context);
+  void end();
+  bool feed(const uint8_t* data, size_t length);
+
+  bool finished() const;
+  uint32_t newSize() const;
+  uint32_t written() const;
+  const char* error() const;
+
+private:
+  enum class Stage : uint8_t {
+    Header,
+    Control,
+    Add,
+    Copy,
+    Done,
+    Failed,
+  };
+
+  static bool onInflated(const uint8_t* data, size_t length, void* context);
+  bool consume(const uint8_t* data, size_t length);
+  bool emitAdd(const uint8_t* diff, size_t length);
+  bool fail(const char* message);
+
+  Inflater _inflater;
+  const esp_partition_t* _source;
+  WriteFn _write;
+  void* _context;
+  Stage _stage;
+  uint8_t _header[kHeaderSize];
+  uint8_t _control[12];
+  size_t _pending;
+  uint32_t _newSize;
+  uint32_t _oldSize;
+  uint32_t _written;
+  int64_t _oldPos;
+  uint32_t _addLeft;
+  uint32_t _copyLeft;
+  int32_t _seek;
+  const char* _error;
+};
+
+#endif
@@ -4,6 +4,22 @@
 #include <Arduino.h>
 #include <FastLED.h>
 #include <FastLED_NeoMatrix.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+struct DisplayFrameStats {
+  uint32_t frames;
+  uint32_t lastOutputUs;
+  uint32_t maxOutputUs;
+  uint32_t avgOutputUs;
+  uint32_t expectedOutputUs;
+  uint32_t slowFrames;
+  uint32_t showWaits;
+  uint32_t maxShowWaitUs;
+  bool outputTask;
+  uint8_t outputs;
+};
 
 class DisplayPanel {
 public:
@@ -16,20 +32,41 @@ public:
   void drawTextAt(int16_t x, const char* text, uint16_t color);
   void drawTextAtColored(int16_t x, const char* text, const uint16_t* colors,
                          size_t colorCount, uint16_t fallbackColor);
+  // Publishes the drawn frame. With the output task running this only waits
+  // for the previous frame to leave the wire, copies, and returns.
   void show();
+  // Frame-safe replacement for FastLED.delay(): never re-shows from the caller.
+  void delay(uint32_t ms);
 
   uint16_t width() const;
   uint8_t height() const;
   uint16_t color(uint8_t r, uint8_t g, uint8_t b) const;
+  void frameStats(DisplayFrameStats& outStats) const;
 
 private:
+  static void outputTask(void* param);
+  void outputLoop();
+  void outputFrame();
+
   uint16_t _width;
   uint8_t _height;
   uint16_t _numLeds;
   uint8_t _brightness;
 
   CRGB* _leds;
+  CRGB* _frontLeds;
   FastLED_NeoMatrix* _matrix;
+  TaskHandle_t _outputTask;
+  SemaphoreHandle_t _frameFree;
+
+  volatile uint32_t _frames;
+  volatile uint32_t _lastOutputUs;
+  volatile uint32_t _maxOutputUs;
+  uint64_t _totalOutputUs;
+  uint32_t _expectedOutputUs;
+  volatile uint32_t _slowFrames;
+  uint32_t _showWaits;
+  uint32_t _maxShowWaitUs;
 };
 
 #endif
@@ -0,0 +1,54 @@
+#ifndef INFLATER_H
+#define INFLATER_H
+
+#include <Arduino.h>
+
+struct tinfl_decompressor_tag;
+
+// Streaming DEFLATE decoder on top of the ROM tinfl. Input can arrive in
+// arbitrary pieces; decoded bytes are handed to `output` as they leave the
+// 32 KB history window. Buffers are heap-allocated in begin() and released in
+// end(), so an idle Inflater costs nothing. Gzip members (RFC 1952) have
+// their header skipped here; the CRC-32/size trailer is not checked.
+class Inflater {
+public:
+  enum class Format : uint8_t {
+    Raw,
+    Zlib,
+    Gzip,
+  };
+
+  enum class Result : uint8_t {
+    NeedsInput,
+    Done,
+    Error,
+    Aborted,
+  };
+
+  using OutputFn = bool (*)(const uint8_t* data, size_t length, void* context);
+
+  Inflater();
+  ~Inflater();
+  Inflater(const Inflater&) = delete;
+  Inflater& operator=(const Inflater&) = delete;
+
+  bool begin(Format format);
+  void end();
+  Result write(const uint8_t* data, size_t length, OutputFn output, void* context);
+  uint32_t totalOut() const;
+
+private:
+  // Returns the number of header bytes consumed, or -1 on a malformed header.
+  int consumeGzipHeader(const uint8_t* data, size_t length);
+
+  tinfl_decompressor_tag* _decompressor;
+  uint8_t* _window;
+  size_t _windowOffset;
+  uint32_t _flags;
+  uint32_t _totalOut;
+  uint8_t _gzipStage;
+  uint8_t _gzipFlags;
+  uint16_t _gzipRemaining;
+};
+
+#endif
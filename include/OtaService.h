@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <esp_partition.h>
 
 #include "WifiService.h"
 
@@ -50,10 +51,15 @@ private:
   static int nextVersionToken(const String& value, size_t& pos);
   static String normalizeManifestUrl(String url);
   static String normalizeHttpUrl(String url);
-  static String normalizeMd5Hex(String value);
+  static String normalizeHexDigest(String value);
   bool fetchManifest(const String& manifestUrl);
   bool installAvailableFirmwareUpdate();
   bool installAvailableLittleFsUpdate();
+  bool installDeltaFirmwareUpdate(const esp_partition_t* partition);
+  bool selectDeltaEntry(JsonVariant entry);
+  bool downloadImage(const char* label, const esp_partition_t* partition,
+                     const String& url, uint32_t expectedSize,
+                     const String& md5Hex, const String& sha256Hex);
   bool backupSettingsForLittleFsUpdate();
   void persistCurrentLittleFsVersion(const String& version);
   void clearPendingSettingsBackupFlag();
@@ -71,6 +77,9 @@ private:
   String _firmwareMd5;
   String _firmwareSha256;
   uint32_t _firmwareSize;
+  String _deltaUrl;
+  uint32_t _deltaSize;
+  bool _lastInstallUsedDelta;
   bool _hasPendingFirmwareUpdate;
   String _currentLittleFsVersion;
   String _availableLittleFsVersion;
@@ -81,6 +90,10 @@ private:
   bool _hasPendingLittleFsUpdate;
   String _lastError;
   uint32_t _lastCheckedMs;
+  uint32_t _downloadOffset;
+  uint32_t _downloadSize;
+  uint32_t _downloadResumeCount;
+  bool _lastImageSha256Verified;
 };
 
 #endif
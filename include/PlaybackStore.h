@@ -0,0 +1,53 @@
+#ifndef PLAYBACK_STORE_H
+#define PLAYBACK_STORE_H
+
+#include <Arduino.h>
+
+#include "RssCache.h"
+
+// Where the headline rotation stood after a displayed segment.
+struct PlaybackCheckpoint {
+  uint32_t sourcesHash;  // source URLs in order; cursors index into that list
+  uint8_t orderedSourceIndex;
+  uint8_t orderedItemIndex;
+  uint8_t interstitialCursor;
+  uint8_t itemsSinceInterstitial;
+  uint8_t colorRotationIndex;
+  RssCycleSnapshot cycle;
+};
+
+enum class PlaybackOrigin : uint8_t { None, Rtc, Flash };
+
+struct PlaybackStats {
+  PlaybackOrigin restoredFrom;
+  bool resumed;  // the restored checkpoint matched the sources and was applied
+  uint32_t flashWrites;
+};
+
+// Keeps the latest checkpoint in RTC memory, which a software reset (OTA
+// install, crash, watchdog) leaves intact, and copies it to a small LittleFS
+// file at most every kFlushIntervalMs when it has changed, for power cycles.
+// record() is cheap enough for every segment; flushDue() may stall on flash
+// and belongs on the producer task.
+class PlaybackStore {
+public:
+  static constexpr uint32_t kFlushIntervalMs = 15UL * 60UL * 1000UL;
+
+  PlaybackStore();
+
+  // RTC copy first, then the flash copy; true when either checks out.
+  bool restore(PlaybackCheckpoint& outCheckpoint);
+  void record(const PlaybackCheckpoint& checkpoint);
+  // Returns true when the flash copy was rewritten.
+  bool flushDue(uint32_t nowMs);
+  void stats(PlaybackStats& outStats) const;
+
+private:
+  PlaybackOrigin _restoredFrom;
+  bool _recorded;
+  uint32_t _lastFlushMs;
+  uint32_t _flashWrites;
+  PlaybackCheckpoint _flushed;  // what the flash copy holds
+};
+
+#endif
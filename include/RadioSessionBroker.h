@@ -0,0 +1,94 @@
+#ifndef RADIO_SESSION_BROKER_H
+#define RADIO_SESSION_BROKER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "SettingsStore.h"
+#include "WifiService.h"
+
+struct RadioWindowReport {
+  uint32_t openedMs;
+  uint32_t connectMs;
+  uint32_t awakeMs;
+  uint32_t holdMs;
+  uint8_t jobCount;
+  uint8_t jobsOk;
+  bool associated;
+  bool connected;
+  char jobs[48];
+};
+
+// Owns STA bring-up/tear-down for background network work. Subsystems submit
+// jobs with a deadline; a wake window opens when the earliest deadline passes
+// and runs every job due within kCoalesceMs, so one association serves them
+// all. With radio control disabled (config mode) windows use whatever
+// connection is already up and never touch the radio.
+class RadioSessionBroker {
+public:
+  // `connected` is false when the window could not bring STA up; jobs should
+  // then back off instead of retrying immediately.
+  using JobFn = bool (*)(bool connected, void* context);
+  // Polled while a window is held open; true once the awaited reply is in.
+  using HoldFn = bool (*)(void* context);
+
+  static constexpr uint32_t kCoalesceMs = 3UL * 60UL * 1000UL;
+  static constexpr size_t kMaxJobs = 8;
+  static constexpr size_t kReportWindows = 6;
+
+  RadioSessionBroker(SettingsStore& settingsStore, WifiService& wifiService);
+
+  void begin();
+  void setRadioControlEnabled(bool enabled);
+
+  // Re-submitting a pending job (same fn + context) keeps the earlier deadline.
+  bool submit(const char* name, JobFn fn, void* context, uint32_t deadlineMs);
+  bool windowDue(uint32_t nowMs) const;
+  // Runs all jobs due within the coalescing horizon in one session. Nested
+  // calls from inside a job reuse the open session. Returns jobs that succeeded.
+  size_t runWindow();
+  // Called from a job that started asynchronous network work (SNTP): keeps
+  // the session up after the remaining jobs until `done` reports completion
+  // or maxMs passes. One hold per window; a later call replaces it.
+  void holdWindow(uint32_t maxMs, HoldFn done, void* context);
+
+  bool recentWindow(size_t age, RadioWindowReport& outReport) const;
+  void appendStatus(JsonObject obj) const;
+
+private:
+  struct Job {
+    const char* name;
+    JobFn fn;
+    void* context;
+    uint32_t deadlineMs;
+    bool pending;
+  };
+
+  size_t takeDueJobs(uint32_t horizonMs, Job* outJobs, size_t maxJobs);
+  void noteJob(const char* name, bool ok);
+  void waitForHold();
+  void finishWindow(bool associationAttempted);
+
+  SettingsStore& _settingsStore;
+  WifiService& _wifiService;
+  SemaphoreHandle_t _jobMutex;
+  SemaphoreHandle_t _windowMutex;
+  bool _radioControlEnabled;
+  Job _jobs[kMaxJobs];
+  uint8_t _windowDepth;
+  HoldFn _holdDone;
+  void* _holdContext;
+  uint32_t _holdUntilMs;
+  RadioWindowReport _current;
+  RadioWindowReport _reports[kReportWindows];
+  size_t _reportHead;
+  uint32_t _windows;
+  uint32_t _associations;
+  uint32_t _failedAssociations;
+  uint32_t _jobsRun;
+  uint32_t _awakeMsTotal;
+};
+
+#endif
@@ -11,6 +11,40 @@ struct RssCacheMetadata {
   uint32_t updatedEpoch;
 };
 
+struct RssCacheStats {
+  uint32_t hits;    // record lookups served from the RAM tier
+  uint32_t misses;  // record lookups that had to read the log
+  uint32_t evictions;
+  uint32_t hotBytes;
+  uint32_t budgetBytes;
+  uint8_t hotSources;
+  bool psram;
+  uint32_t logBytes;
+  uint32_t deadBytes;  // superseded records awaiting compaction
+  uint32_t compactions;
+};
+
+// No-repeat cycle progress in the fixed form a playback checkpoint keeps.
+struct RssCycleSnapshot {
+  bool valid;
+  uint32_t signature;  // sources, item counts and update times the bits belong to
+  uint8_t shownBits[APP_MAX_RSS_SOURCES][(APP_MAX_RSS_ITEMS + 7) / 8];
+};
+
+// Per-source item cache. LittleFS holds a single append-only log
+// (/cache/log.bin): each store() appends one CRC-protected record with the
+// source's items packed (offset table, then flags + NUL-terminated title and
+// description per item), and an in-RAM index maps URL hashes to their latest
+// record, so headers and counts never touch flash. Superseded records are
+// dropped by compaction, which copies the live records into a fresh log once
+// they are outnumbered by dead bytes; begin() rebuilds the index with one
+// scan of a log that compaction keeps small, and compacts away a torn tail.
+//
+// A RAM tier in front of the log keeps whole sources in the same packed form
+// so item lookups and headline picks are memory reads. Its budget is taken
+// from PSRAM when present, otherwise from a share of free heap at begin().
+// store() always refreshes the tier, evicting least-recently-used sources;
+// a read miss only loads the source if it fits without evicting another.
 class RssCache {
 public:
   RssCache();
@@ -28,19 +62,34 @@ public:
                               RssItem& outItem, size_t& outSourceIndex,
                               bool& outCycleReset, uint8_t* outFlags = nullptr);
 
+  // The running no-repeat cycle, and putting one back after a restart. The
+  // restore only applies when the sources and their cached records are the
+  // ones the snapshot was taken against.
+  void cycleSnapshot(RssCycleSnapshot& outSnapshot) const;
+  bool restoreCycle(const RssSource* sources, size_t sourceCount,
+                    const RssCycleSnapshot& snapshot);
+
+  void stats(RssCacheStats& outStats) const;
+
 private:
-  struct CacheHeader {
+  // Room for sources that were removed from settings but are still in the log.
+  static constexpr size_t kLogIndexEntries = APP_MAX_RSS_SOURCES * 2;
+
+  struct LogRecordHeader {
     uint32_t magic;
-    uint16_t version;
-    uint16_t reserved;
-    uint32_t itemCount;
+    uint32_t urlHash;
     uint32_t updatedEpoch;
+    uint16_t itemCount;
+    uint16_t payloadBytes;  // followed by the payload and a CRC-32 trailer
   };
 
-  struct CacheRecord {
-    char title[APP_RSS_TITLE_LEN + 1];
-    char description[APP_RSS_DESC_LEN + 1];
-    uint8_t flags;
+  struct LogEntry {
+    bool used;
+    uint16_t itemCount;
+    uint16_t payloadBytes;
+    uint32_t urlHash;
+    uint32_t offset;  // record start in the log
+    uint32_t updatedEpoch;
   };
 
   struct CycleSourceState {
@@ -49,16 +98,40 @@ private:
     uint8_t* shownBits;
   };
 
+  struct HotSource {
+    uint32_t urlHash;
+    uint32_t itemCount;
+    uint32_t updatedEpoch;
+    uint32_t lastUsed;
+    // Record payload (see above); nullptr marks a free slot.
+    uint8_t* blob;
+    size_t blobBytes;
+  };
+
+  bool scanLog();
+  bool compactLog();
+  void removeLegacyFiles();
+  void indexRecord(const LogRecordHeader& header, uint32_t offset);
+  const LogEntry* findEntry(const char* sourceUrl) const;
+  static uint32_t recordBytes(uint16_t payloadBytes);
+  bool readLogItem(const LogEntry& entry, uint32_t itemIndex, RssItem& outItem) const;
+
+  HotSource* findHot(uint32_t urlHash) const;
+  HotSource* findHotCounted(uint32_t urlHash) const;
+  HotSource* admitHot(const LogEntry& entry) const;
+  HotSource* insertHot(uint32_t urlHash, uint32_t itemCount, uint32_t updatedEpoch,
+                       uint8_t* blob, size_t blobBytes) const;
+  bool reserveHot(size_t bytes, uint32_t keepHash, bool mayEvict) const;
+  void dropHot(HotSource& hot) const;
+  void freeHot();
+  uint8_t* allocHot(size_t bytes) const;
+
   void invalidateCycleState();
   void freeCycleState();
   bool ensureCycleState(const RssSource* sources, size_t sourceCount);
   void restartCycleState();
 
-  bool readHeader(const char* sourceUrl, CacheHeader& outHeader) const;
-  bool readRecord(const char* sourceUrl, uint32_t itemIndex,
-                  CacheRecord& outRecord) const;
-  static uint8_t inferItemFlags(const RssItem& item);
-  static bool containsCaseInsensitive(const char* haystack, const char* needle);
+  bool loadRecord(const char* sourceUrl, uint32_t itemIndex, RssItem& outItem) const;
 
   bool _cycleValid;
   uint32_t _cycleSignature;
@@ -66,6 +139,18 @@ private:
   uint32_t _cycleTotalItems;
   uint32_t _cycleRemainingItems;
   CycleSourceState _cycleSources[APP_MAX_RSS_SOURCES];
+  LogEntry _index[kLogIndexEntries];
+  uint32_t _logBytes;
+  uint32_t _deadBytes;
+  uint32_t _compactions;
+  mutable HotSource _hot[APP_MAX_RSS_SOURCES];
+  mutable size_t _hotBytes;
+  mutable uint32_t _hotTick;
+  mutable uint32_t _hits;
+  mutable uint32_t _misses;
+  mutable uint32_t _evictions;
+  size_t _hotBudget;
+  bool _hotPsram;
 };
 
 #endif
@@ -0,0 +1,22 @@
+#ifndef RSS_CLASSIFIER_H
+#define RSS_CLASSIFIER_H
+
+#include <Arduino.h>
+
+#include "AppTypes.h"
+
+// Game state of a status/headline string in one pass over a generated
+// multi-pattern automaton (see scripts/gen_status_automaton.py). Returns at
+// most one of RssItemFlagLive/Final/Scheduled/Postponed, or RssItemFlagNone.
+uint8_t classifyRssStatus(const char* text);
+
+// Classifies a parsed item once at ingest. Returns the item's flags with the
+// game state resolved over title + description and RssItemFlagClassified set,
+// so cache reads and playback never rescan item text.
+uint8_t classifyRssItem(const RssItem& item);
+
+inline bool rssItemIsClassified(uint8_t flags) {
+  return (flags & RssItemFlagClassified) != 0;
+}
+
+#endif
@@ -5,26 +5,69 @@
 
 #include "AppTypes.h"
 
+class ScratchArena;
+
+// Called once per non-empty section of a batch response; the section's items
+// are in the fetch's outItems buffer until the callback returns.
+using RssSectionFn = void (*)(const char* key, uint16_t itemCount, void* context);
+
+// Transient failures may clear on a retry (transport errors, 408/429/5xx, a
+// corrupt compressed body); permanent ones will not (bad URL, other HTTP
+// statuses, a body with nothing parseable).
+enum class RssFetchError : uint8_t { None, Transient, Permanent };
+
 struct RssFetchResult {
   bool success;
   uint16_t itemCount;
   int httpStatus;
   String error;
+  uint32_t wireBytes;  // body bytes received (compressed when gzip)
+  uint32_t bodyBytes;  // decoded bytes handed to the parsers
+  bool compressed;
+  bool truncated;  // decoded body hit kRssMaxResponseBytes / scratch space
+  bool digest;     // body was an MCDG digest from scripts/feed_digest.py
+  uint8_t sections;  // non-empty sections delivered by fetchSections()
+  RssFetchError errorClass;
+  bool hostFailure;  // host did not answer usefully; feeds RssHostBreaker
+  uint8_t attempts;
 };
 
 class RssFetcher {
 public:
   RssFetcher();
 
+  // Per-fetch scratch (payload, parse temporaries, JSON tree) comes from the
+  // arena when set; the caller resets it once the fetched items are consumed.
+  void setScratchArena(ScratchArena* arena);
+
+  // Retries stop early on a permanent failure.
   RssFetchResult fetch(const char* url, RssItem* outItems, size_t maxItems,
                        uint8_t maxAttempts = 3, uint32_t timeoutMs = 10000,
                        uint32_t backoffMs = 800) const;
+  // Batch variant: the body is split on "@@section <key>" lines and each
+  // section is parsed like a single feed. itemCount is the total.
+  RssFetchResult fetchSections(const char* url, RssItem* outItems, size_t maxItems,
+                               RssSectionFn onSection, void* context,
+                               uint8_t maxAttempts = 3, uint32_t timeoutMs = 10000,
+                               uint32_t backoffMs = 800) const;
 
 private:
-  uint16_t parseRssXml(const String& xml, RssItem* outItems,
+  RssFetchResult fetchInto(const char* url, RssItem* outItems, size_t maxItems,
+                           RssSectionFn onSection, void* context, uint8_t maxAttempts,
+                           uint32_t timeoutMs, uint32_t backoffMs) const;
+  uint16_t parsePayload(const char* url, const char* payload, size_t length,
+                        RssItem* outItems, size_t maxItems, RssFetchResult& result) const;
+  uint16_t parseSections(const char* url, const char* payload, size_t length,
+                         RssItem* outItems, size_t maxItems, RssSectionFn onSection,
+                         void* context, RssFetchResult& result) const;
+  uint16_t parseRssXml(const char* xml, size_t length, RssItem* outItems,
                        size_t maxItems) const;
-  uint16_t parseJsonFeed(const String& payload, RssItem* outItems,
+  uint16_t parseJsonFeed(const char* payload, size_t length, RssItem* outItems,
                          size_t maxItems) const;
+  uint16_t parseDigest(const char* payload, size_t length, RssItem* outItems,
+                       size_t maxItems) const;
+
+  ScratchArena* _arena;
 };
 
 #endif
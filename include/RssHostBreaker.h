@@ -0,0 +1,54 @@
+#ifndef RSS_HOST_BREAKER_H
+#define RSS_HOST_BREAKER_H
+
+#include <Arduino.h>
+
+#include "AppTypes.h"
+
+enum class RssBreakerState : uint8_t { Closed, Open, HalfOpen };
+
+struct RssHostBreakerEntry {
+  char host[48];
+  RssBreakerState state;
+  uint8_t failures;  // consecutive fetches the host did not answer
+  uint16_t trips;
+  uint32_t openedMs;
+  uint32_t cooldownMs;
+};
+
+// Per-host circuit breaker for feed fetches. A host that fails to answer
+// (connect/DNS/timeout, 5xx, 429) on consecutive fetches opens its breaker,
+// and every source on that host is skipped until the cool-down ends. The
+// next fetch is then a single half-open probe: success closes the breaker,
+// failure reopens it with a doubled cool-down. Hosts are keyed by the URL
+// authority, so all six league URLs on the sports backend share one entry.
+class RssHostBreaker {
+public:
+  RssHostBreaker();
+
+  void reset();
+
+  // False while the host's breaker is open. Once the cool-down has passed the
+  // breaker turns half-open and this request goes through as the probe
+  // (outProbe set); further requests wait for the probe's result.
+  bool allow(const char* url, uint32_t nowMs, bool& outProbe);
+  // hostFailure: the host did not answer usefully. Any other outcome, even a
+  // 404 or an unparseable body, proves the host is up.
+  void record(const char* url, bool hostFailure, uint32_t nowMs);
+  uint32_t msUntilRetry(const char* url, uint32_t nowMs) const;
+
+  size_t count() const;
+  bool entry(size_t index, RssHostBreakerEntry& outEntry) const;
+
+  static const char* stateName(RssBreakerState state);
+
+private:
+  static bool hostOf(const char* url, char* outHost, size_t outHostLen);
+  int find(const char* host) const;
+  int findOrAdd(const char* host);
+
+  RssHostBreakerEntry _entries[APP_MAX_RSS_SOURCES];
+  size_t _count;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef RSS_REFRESH_SCHEDULER_H
+#define RSS_REFRESH_SCHEDULER_H
+
+#include <Arduino.h>
+
+#include "AppTypes.h"
+
+struct RssSourceSchedule {
+  uint32_t dueMs;
+  uint32_t intervalMs;
+  uint32_t contentHash;
+  uint32_t lastCheckMs;
+  uint16_t checks;
+  uint16_t changes;
+  uint8_t failures;
+  bool live;
+};
+
+// Per-source refresh timing kept in a min-heap keyed by next-due time. Each
+// source's interval adapts to how often its content hash changes: halved on
+// change, grown by half when unchanged, with tighter bounds while a source
+// carries live games. Failures back off exponentially.
+class RssRefreshScheduler {
+public:
+  RssRefreshScheduler();
+
+  void reset(size_t sourceCount, uint32_t firstDueMs);
+  void markAllDue(uint32_t dueMs);
+  // Live priority pins live sources to the shortest live interval.
+  void setLivePriority(bool enabled);
+
+  bool isDue(size_t index, uint32_t nowMs) const;
+  size_t collectDue(uint32_t nowMs, size_t* outIndices, size_t maxIndices) const;
+  uint32_t msUntilNextDue(uint32_t nowMs) const;
+
+  // Returns true when the content differs from the last successful fetch.
+  bool recordSuccess(size_t index, uint32_t nowMs, uint32_t contentHash, bool live);
+  // Permanent failures (404, unparseable feed) wait the full retry maximum.
+  void recordFailure(size_t index, uint32_t nowMs, bool permanent = false);
+  // Moves the due time without counting a check or failure (breaker skips).
+  void postpone(size_t index, uint32_t dueMs);
+
+  bool entry(size_t index, RssSourceSchedule& outEntry) const;
+
+private:
+  bool earlier(size_t heapA, size_t heapB) const;
+  void reschedule(size_t index, uint32_t dueMs);
+  void swapNodes(size_t heapA, size_t heapB);
+  void siftUp(size_t heapPos);
+  void siftDown(size_t heapPos);
+
+  RssSourceSchedule _entries[APP_MAX_RSS_SOURCES];
+  uint8_t _heap[APP_MAX_RSS_SOURCES];
+  uint8_t _heapPos[APP_MAX_RSS_SOURCES];
+  size_t _count;
+  uint32_t _liveMaxIntervalMs;
+};
+
+#endif
@@ -2,23 +2,59 @@
 #define RSS_RUNTIME_H
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include <time.h>
 
 #include "AppTypes.h"
+#include "ClockKeeper.h"
+#include "PlaybackStore.h"
+#include "RadioSessionBroker.h"
 #include "RssCache.h"
 #include "RssFetcher.h"
+#include "RssHostBreaker.h"
+#include "RssRefreshScheduler.h"
+#include "RssScoreBoard.h"
+#include "ScratchArena.h"
 #include "SettingsStore.h"
 #include "WifiService.h"
 
+struct RssPipelineStats {
+  uint8_t queued;
+  uint8_t capacity;
+  uint32_t served;
+  uint32_t underruns;
+  uint32_t lastDequeueUs;
+  uint32_t maxDequeueUs;
+  uint32_t lastBuildMs;
+  uint32_t maxBuildMs;
+  uint16_t liveItems;
+  uint8_t pendingScoreUpdates;
+  uint32_t scoreUpdates;
+  uint8_t retryBudgetLeft;  // retries left in the current refresh cycle
+  uint32_t breakerSkips;
+};
+
 class RssRuntime {
 public:
-  RssRuntime(SettingsStore& settingsStore, WifiService& wifiService);
+  RssRuntime(SettingsStore& settingsStore, WifiService& wifiService,
+             RadioSessionBroker& radioBroker);
 
   bool begin();
   void onSettingsChanged(const AppSettings& settings);
+  // Suspended, the producer parks between segments and network jobs and
+  // leaves the cache and flash alone (OTA install). waitProducerIdle() returns
+  // true once it has, or false after timeoutMs.
   void setSuspended(bool suspended);
-  void setRadioControlEnabled(bool enabled);
-  void tick();
+  bool waitProducerIdle(uint32_t timeoutMs) const;
+  // When disabled, the lookahead producer builds from cache only and never
+  // touches the radio; an open window stops after its current job. Disabling
+  // does not wait: poll networkIdle() before taking over WiFi (boot task,
+  // config-mode transitions).
+  void setSegmentNetworkEnabled(bool enabled);
+  bool networkIdle() const;
   void forceRefreshSoon();
 
   bool hasEnabledSources() const;
@@ -27,47 +63,137 @@ public:
   bool refreshAllNow();
   void queueStartupWeather();
 
+  // Non-blocking beyond a short bounded wait: pops the next segment prepared
+  // by the background producer.
   bool nextSegment(String& outText, uint8_t& outR, uint8_t& outG,
                    uint8_t& outB);
+  void pipelineStats(RssPipelineStats& outStats) const;
 
   size_t sourceCount() const;
   const RssSource* sources() const;
   bool sourceMetadata(size_t sourceIndex, RssCacheMetadata& outMetadata) const;
+  bool sourceSchedule(size_t sourceIndex, RssSourceSchedule& outSchedule) const;
+  size_t hostBreakerCount() const;
+  bool hostBreakerEntry(size_t index, RssHostBreakerEntry& outEntry) const;
+  void cacheStats(RssCacheStats& outStats) const;
+  void clockStats(ClockStats& outStats) const;
+  void playbackStats(PlaybackStats& outStats) const;
 
 private:
-  static constexpr uint32_t kRefreshIntervalMs = 15UL * 60UL * 1000UL;
-  static constexpr uint32_t kRefreshRetryMs = 60UL * 1000UL;
+  static constexpr uint8_t kLookaheadSegments = 3;
+  static constexpr size_t kSegmentTextLen = APP_RSS_TITLE_LEN + APP_RSS_DESC_LEN + 64;
+  static constexpr uint8_t kMaxPendingScoreUpdates = 4;
+  static constexpr size_t kWeatherMessageLen = 255;
+
+  struct QueuedSegment {
+    char text[kSegmentTextLen + 1];
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint32_t generation;
+    PlaybackCheckpoint checkpoint;  // rotation state once this segment is shown
+  };
+
+  struct PendingScoreUpdate {
+    uint8_t sourceIndex;
+    uint8_t itemIndex;
+  };
+
+  struct SportsBatchRefresh {
+    RssRuntime* self;
+    uint32_t generation;
+    uint32_t sectionMask;  // batched sources that got a section
+    bool storedAny;
+  };
+
+  static void producerTask(void* param);
+  void producerLoop();
+  bool prefetchNetworkWork();
+  bool buildSegment(String& outText, uint8_t& outR, uint8_t& outG, uint8_t& outB);
+  bool buildScoreUpdate(String& outText, uint8_t& outR, uint8_t& outG,
+                        uint8_t& outB);
+  void invalidateLookahead();
+  void advanceOrderedSource();
 
-  bool shouldRefreshNow() const;
-  void scheduleNextRefresh(bool success);
-  void rebuildSources(const AppSettings& settings);
+  bool rebuildSources(const AppSettings& settings);
   bool refreshCache();
-  bool refreshSource(size_t sourceIndex);
-  bool refreshSourceWithManagedRadio(size_t sourceIndex);
+  void submitNetworkJobs(uint32_t nowMs);
+  static bool sourcesJob(bool connected, void* context);
+  static bool weatherJob(bool connected, void* context);
+  static bool clockJob(bool connected, void* context);
+  static bool clockReplyIn(void* context);
+  bool windowCancelled() const;
+  bool refreshDueSources(bool connected);
+  bool refreshSource(size_t sourceIndex, uint32_t generation);
+  bool admitFetch(const char* url, uint8_t& outAttempts);
+  void settleFetch(const char* url, const RssFetchResult& result);
+  bool refreshSportsBatch(uint32_t generation);
+  static void onSportsSection(const char* key, uint16_t itemCount, void* context);
+  bool ingestFetchedItems(size_t sourceIndex, uint32_t generation, uint16_t itemCount);
+  bool hashCachedItems(size_t sourceIndex, uint32_t& outHash) const;
+  void logRefreshHeap(size_t largestBefore, uint32_t minFreeBefore) const;
+  void logFetchBody(const RssFetchResult& result) const;
+  void seedScoreBoard(size_t sourceIndex);
+  void diffScores(size_t sourceIndex, size_t itemCount);
   bool pickNextItem();
+  bool pickNextItemRandom();
   bool pickNextItemOrdered();
+  bool pickLiveItem();
   bool nextInterstitialSegment(String& outText, uint8_t& outR, uint8_t& outG,
                                uint8_t& outB);
   bool buildTimeMessage(String& outText);
   bool buildWeatherMessage(String& outText);
   bool refreshWeather();
-  bool refreshWeatherWithManagedRadio();
+  uint32_t weatherDeadlineMs(uint32_t nowMs) const;
+  uint32_t clockDeadlineMs(uint32_t nowMs) const;
   void markItemDisplayed();
-  void trySyncClockFromNtp(bool force);
   void resetPlayback();
+  uint32_t sourcesHash() const;
+  void capturePlayback(PlaybackCheckpoint& outCheckpoint) const;
+  void resumePlayback();
   void colorForSource(size_t sourceIndex, uint8_t& outR, uint8_t& outG,
                       uint8_t& outB) const;
 
   SettingsStore& _settingsStore;
   WifiService& _wifiService;
+  RadioSessionBroker& _radioBroker;
   RssFetcher _fetcher;
+  ScratchArena _scratch;
   RssCache _cache;
 
   RssSource _sources[APP_MAX_RSS_SOURCES];
   size_t _sourceCount;
-  bool _suspended;
-  bool _radioControlEnabled;
-  uint32_t _nextRefreshMs;
+  // Bumped whenever _sources is rebuilt. Fetches run without the state lock,
+  // so they carry the generation they started with and drop stale results.
+  uint32_t _sourcesGeneration;
+  volatile bool _suspended;
+  volatile bool _producerParked;
+  bool _windowRefreshed;
+  bool _producerWindow;  // the producer's own window is running jobs
+  volatile bool _segmentNetworkEnabled;
+  SemaphoreHandle_t _stateMutex;
+  SemaphoreHandle_t _networkMutex;
+  QueueHandle_t _segmentQueue;
+  TaskHandle_t _producerTask;
+  volatile uint32_t _segmentGeneration;
+  bool _orderedRefreshRequested;
+  uint32_t _segmentsServed;
+  uint32_t _segmentUnderruns;
+  uint32_t _lastDequeueUs;
+  uint32_t _maxDequeueUs;
+  uint32_t _lastBuildMs;
+  uint32_t _maxBuildMs;
+  RssRefreshScheduler _scheduler;
+  RssScoreBoard _scoreBoard;
+  RssHostBreaker _hostBreaker;
+  uint8_t _retryBudget;
+  uint32_t _breakerSkips;
+  PendingScoreUpdate _pendingScores[kMaxPendingScoreUpdates];
+  uint8_t _pendingScoreCount;
+  uint32_t _scoreUpdates;
+  uint32_t _headlinesSinceLive;
+  bool _livePriorityEnabled;
+  char _sportsBatchUrl[APP_MAX_URL_LEN + 1];  // empty unless batch mode is on
 
   bool _cacheReady;
   bool _randomEnabled;
@@ -75,11 +201,13 @@ private:
   bool _showTitleNext;
   uint32_t _itemsSinceInterstitial;
   uint8_t _interstitialCursor;
-  bool _clockSynced;
-  time_t _clockSyncEpoch;
-  uint32_t _clockSyncMillis;
+  ClockKeeper _clock;
+  PlaybackStore _playbackStore;
+  PlaybackCheckpoint _resumeCheckpoint;
+  bool _resumePending;  // apply _resumeCheckpoint before the first build
+  bool _playbackResumed;
   uint32_t _lastClockSyncAttemptMs;
-  String _weatherMessage;
+  char _weatherMessage[kWeatherMessageLen + 1];
   bool _weatherReady;
   bool _pendingStartupWeather;
   uint32_t _weatherLastFetchMs;
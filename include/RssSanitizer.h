@@ -4,5 +4,8 @@
 #include <Arduino.h>
 
 String sanitizeRssText(const String& input);
+// Same cleanup on a writable buffer; every pass only shrinks the text, so no
+// allocation is needed. Returns the new length and NUL-terminates.
+size_t sanitizeRssTextInPlace(char* text, size_t length);
 
 #endif
@@ -0,0 +1,48 @@
+#ifndef RSS_SCORE_BOARD_H
+#define RSS_SCORE_BOARD_H
+
+#include <Arduino.h>
+
+#include "AppTypes.h"
+
+// Compact per-source snapshot of the last fetch of each score feed. Every
+// item is reduced to two hashes of its title with color tags skipped: the
+// non-digit characters (team names) identify the game, the digits are the score. Diffing a
+// fresh fetch is one pass over the items with no flash reads.
+class RssScoreBoard {
+public:
+  RssScoreBoard();
+
+  void reset();
+  bool hasSnapshot(size_t sourceIndex) const;
+  // Rebuilds a snapshot from cached records one item at a time (after boot).
+  void seedItem(size_t sourceIndex, size_t itemIndex, const RssItem& item);
+
+  // Replaces the snapshot for a source. When a previous snapshot exists, item
+  // indices whose game matched but whose score changed are written to
+  // outChanged (games live or final in both snapshots). Returns the number
+  // written.
+  size_t update(size_t sourceIndex, const RssItem* items, size_t itemCount,
+                uint8_t* outChanged, size_t maxChanged);
+
+  // Round-robin over live items across all sources.
+  bool nextLive(size_t& outSourceIndex, uint32_t& outItemIndex);
+  size_t liveCount() const;
+
+private:
+  struct Entry {
+    uint32_t game;
+    uint32_t score;
+    uint8_t flags;
+  };
+
+  static void hashTitle(const char* title, uint32_t& outGame, uint32_t& outScore);
+
+  Entry _entries[APP_MAX_RSS_SOURCES][APP_MAX_RSS_ITEMS];
+  uint8_t _counts[APP_MAX_RSS_SOURCES];
+  bool _seeded[APP_MAX_RSS_SOURCES];
+  uint8_t _liveSource;
+  uint8_t _liveItem;
+};
+
+#endif
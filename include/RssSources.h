@@ -8,5 +8,12 @@
 size_t buildRssSources(const AppSettings& settings, RssSource* outSources,
                        size_t maxSources);
 bool hasEnabledRssSources(const AppSettings& settings);
+// One backend request covering every batched league:
+// espn_scores_rss.php?sports=mlb,nhl,...&format=json. The response is split
+// into per-league sections ("@@section <key>" lines, see RssFetcher).
+bool buildRssSportsBatchUrl(const AppSettings& settings, const RssSource* sources,
+                            size_t sourceCount, char* outUrl, size_t outUrlLen);
+const char* rssLeagueKey(RssLeague league);
+const char* rssSourceKindName(RssSourceKind kind);
 
 #endif
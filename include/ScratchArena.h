@@ -0,0 +1,65 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Bump allocator over one block reserved at boot. Per-refresh scratch (HTTP
+// payload, parse temporaries, the JsonDocument tree) is carved from it and
+// dropped in one reset(), so refresh cycles never fragment the shared heap.
+// Not thread-safe: one owner (the refresh path) at a time.
+class ScratchArena {
+public:
+  ScratchArena();
+  ~ScratchArena();
+
+  bool reserve(size_t capacity);
+  bool reserved() const;
+
+  void* allocate(size_t size);
+  // Grows or shrinks the most recent allocation in place when possible.
+  void* reallocate(void* ptr, size_t size);
+  bool owns(const void* ptr) const;
+  // Upper bound on an owned block's size: bytes from ptr to the arena top.
+  size_t spanFrom(const void* ptr) const;
+  void reset();
+  // rewind(mark()) drops everything allocated after the mark and keeps older
+  // blocks (e.g. the payload while its sections are parsed one by one).
+  size_t mark() const;
+  void rewind(size_t mark);
+
+  // Tail buffer for streaming writes of unknown length: write into tail(),
+  // then commitTail() the bytes used.
+  char* tail(size_t& outAvailable);
+  void commitTail(size_t used);
+
+  size_t capacity() const;
+  size_t used() const;
+  size_t highWater() const;
+  uint32_t fallbackAllocs() const;
+  void noteFallback();
+
+private:
+  uint8_t* _base;
+  size_t _capacity;
+  size_t _used;
+  size_t _last;
+  size_t _highWater;
+  uint32_t _fallbackAllocs;
+};
+
+// ArduinoJson allocator over a ScratchArena. deallocate() is a no-op for arena
+// memory; requests the arena cannot satisfy fall back to the heap.
+class ScratchJsonAllocator : public ArduinoJson::Allocator {
+public:
+  explicit ScratchJsonAllocator(ScratchArena& arena);
+
+  void* allocate(size_t size) override;
+  void deallocate(void* ptr) override;
+  void* reallocate(void* ptr, size_t newSize) override;
+
+private:
+  ScratchArena& _arena;
+};
+
+#endif
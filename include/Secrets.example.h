@@ -4,6 +4,7 @@
 // Copy this file to include/Secrets.h and set your private values.
 // include/Secrets.h is ignored by git.
 
+// mode=xml is optional; the default JSON response works too.
 #define APP_WEATHER_API_URL \
   "https://api.openweathermap.org/data/2.5/weather?id=4997384&appid=YOUR_API_KEY_HERE&mode=xml&units=imperial"
 
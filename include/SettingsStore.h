@@ -7,21 +7,43 @@
 
 class SettingsStore {
 public:
+  static constexpr uint32_t kCommitDebounceMs = 1500;
+
+  SettingsStore();
+
   bool begin();
+  void tick();
 
   AppSettings& mutableSettings();
   const AppSettings& settings() const;
 
   bool load();
-  bool save() const;
+  bool save();
+  // Transaction-style edit: mutate via mutableSettings() (live in RAM), then
+  // commit(). Commits landing inside the debounce window share one flash write.
+  void commit(uint32_t debounceMs = kCommitDebounceMs);
+  bool flush();
+  bool hasPendingSave() const;
+  uint32_t flashWriteCount() const;
+  uint32_t commitCount() const;
   void loadDefaults();
   bool factoryReset();
 
 private:
   bool loadDefaultMessagesFromFile();
+  bool writeJsonAtomic();
+  // Binary AppSettings image + CRC32 used as the boot fast path; the JSON file
+  // stays authoritative for import/export and schema migration.
+  bool loadSnapshot(uint32_t& outJsonLoadUs);
+  bool writeSnapshot();
   void sanitize();
 
   AppSettings _settings;
+  bool _savePending;
+  uint32_t _saveDueMs;
+  uint32_t _flashWriteCount;
+  uint32_t _commitCount;
+  uint32_t _jsonLoadUs;
 };
 
 #endif
@@ -0,0 +1,76 @@
+#ifndef WEATHER_EXTRACTOR_H
+#define WEATHER_EXTRACTOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+enum class WeatherField : uint8_t {
+  City,
+  Temperature,
+  Humidity,
+  Pressure,
+  WindSpeed,
+  WindDirection,
+  Clouds,
+  Count
+};
+
+// Single-pass sink for an OpenWeather current-weather response, fed straight
+// from HTTPClient::writeToStream(). The first non-space byte picks the
+// format. XML (mode=xml) is tokenized tag by tag as the chunks arrive and
+// only the wanted attribute values are kept, so the body is never buffered.
+// A JSON body (about 500 bytes) is collected in a fixed buffer and read in
+// finish() through an ArduinoJson filter that keeps just the wanted fields.
+class WeatherExtractor : public Stream {
+public:
+  enum class Format : uint8_t { Unknown, Xml, Json };
+
+  static constexpr size_t kValueLen = 39;
+  static constexpr size_t kJsonBodyBytes = 1024;
+
+  WeatherExtractor();
+
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* data, size_t size) override;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+  // Parses a collected JSON body (the filter and tree come from `allocator`
+  // when given). Returns true when at least one field was found.
+  bool finish(ArduinoJson::Allocator* allocator);
+
+  Format format() const;
+  size_t received() const;
+  bool truncated() const;
+  // Empty string when the field was not in the response.
+  const char* value(WeatherField field) const;
+
+private:
+  enum class XmlState : uint8_t { Text, TagName, Attributes, AttrName, Equals, Value, SkipValue };
+
+  bool parseJson(JsonDocument& filter, JsonDocument& doc);
+  void setJsonValue(WeatherField field, JsonVariantConst value);
+  void feedXml(char c);
+  void endAttrName();
+  void storeValue(WeatherField field, const char* text, size_t length);
+  void setValue(WeatherField field, const char* text);
+
+  Format _format;
+  XmlState _state;
+  char _tag[16];
+  uint8_t _tagLen;
+  char _attr[8];
+  uint8_t _attrLen;
+  char _quote;
+  int8_t _target;  // field the current attribute value goes to, or -1
+  char _pending[kValueLen + 1];
+  uint8_t _pendingLen;
+  char _values[static_cast<size_t>(WeatherField::Count)][kValueLen + 1];
+  char _json[kJsonBodyBytes];
+  size_t _jsonLen;
+  size_t _received;
+  bool _truncated;
+};
+
+#endif
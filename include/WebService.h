@@ -10,6 +10,8 @@
 class WebServer;
 class RssRuntime;
 class OtaService;
+class RadioSessionBroker;
+class DisplayPanel;
 
 class WebService {
 public:
@@ -30,6 +32,8 @@ public:
   void setOnExitConfigRequested(VoidCallback cb);
   void setRssRuntime(RssRuntime* rssRuntime);
   void setOtaService(OtaService* otaService);
+  void setRadioBroker(RadioSessionBroker* radioBroker);
+  void setDisplayPanel(DisplayPanel* displayPanel);
 
 private:
   void registerRoutes();
@@ -62,6 +66,8 @@ private:
   WifiService& _wifiService;
   RssRuntime* _rssRuntime;
   OtaService* _otaService;
+  RadioSessionBroker* _radioBroker;
+  DisplayPanel* _displayPanel;
   SettingsChangedCallback _onSettingsChanged;
   VoidCallback _onWifiConnectRequested;
   VoidCallback _onFactoryResetRequested;
@@ -2,6 +2,9 @@
 #define WIFI_SERVICE_H
 
 #include <Arduino.h>
+#include <WiFi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
 
 #include "AppTypes.h"
 
@@ -16,6 +19,8 @@ enum class WifiRuntimeMode {
 
 class WifiService {
 public:
+  using ConnectCallback = void (*)(bool connected, void* context);
+
   WifiService();
   ~WifiService();
 
@@ -23,6 +28,12 @@ public:
   void tick();
 
   bool startForSettings(const AppSettings& settings);
+  // Starts an STA connection and returns at once. Progress is driven by WiFi
+  // events plus tick() (or a blocking connectSta()); `onDone` fires once.
+  bool beginConnectSta(const char* ssid, const char* password,
+                       uint32_t timeoutMs = 15000, uint8_t maxRetries = 3,
+                       ConnectCallback onDone = nullptr, void* context = nullptr);
+  // Blocking wrapper for background tasks: waits on connection events.
   bool connectSta(const char* ssid, const char* password,
                   uint32_t timeoutMs = 15000, uint8_t maxRetries = 3);
   void startAp(const char* ssid = "ManCave", const char* password = "");
@@ -33,17 +44,68 @@ public:
 
   WifiRuntimeMode mode() const;
   bool isConnected() const;
+  bool connectInProgress() const;
+  uint32_t lastConnectMs() const;
+  bool hasCachedBssid() const;
+  bool lastConnectReusedLease() const;
   String ip() const;
   String ssid() const;
   const char* modeString() const;
 
 private:
+  static void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info);
+  static void onConfigConnectDone(bool connected, void* context);
+  void loadLinkCache();
+  void persistLinkCache();
+  void rememberLink();
+  void advanceConnect();
+  void startAttempt();
+  void finishConnect(bool connected);
   void startCaptiveDns(IPAddress apIp);
   void stopCaptiveDns();
 
   WifiRuntimeMode _mode;
   DNSServer* _dns;
   bool _dnsRunning;
+
+  EventGroupHandle_t _events;
+  char _ssid[APP_MAX_SSID_LEN + 1];
+  char _password[APP_MAX_PASS_LEN + 1];
+  uint32_t _connectStartMs;
+  uint32_t _attemptStartMs;
+  uint32_t _attemptTimeoutMs;
+  uint32_t _retryAtMs;
+  uint8_t _attempt;
+  uint8_t _maxRetries;
+  bool _retryPending;
+  bool _attemptUsedHint;
+  bool _attemptUsedLease;
+  bool _staticIpApplied;
+  ConnectCallback _onConnectDone;
+  void* _connectContext;
+  uint32_t _lastConnectMs;
+
+  // Fast-reconnect hint: AP and DHCP lease of the last successful join,
+  // persisted in NVS so the first join after boot can use it too.
+  struct LinkCache {
+    uint8_t version;
+    char ssid[APP_MAX_SSID_LEN + 1];
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t netmask;
+    uint32_t dns;
+  };
+  LinkCache _link;
+  bool _linkValid;
+  bool _leaseValid;
+  volatile uint8_t _eventBssid[6];
+  volatile uint8_t _eventChannel;
+  volatile uint32_t _eventIp;
+  volatile uint32_t _eventGateway;
+  volatile uint32_t _eventNetmask;
+  volatile uint8_t _disconnectReason;
 };
 
 #endif
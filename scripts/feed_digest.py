@@ -0,0 +1,665 @@
+#!/usr/bin/env python3
+"""Build MCDG feed digests: pre-parsed, pre-classified RSS items for panels.
+
+Usage:
+  python scripts/feed_digest.py --source npr=https://feeds.npr.org/1001/rss.xml \
+      --source mlb="https://host/espn_scores_rss.php?sport=mlb&format=json" --out-dir digests
+  python scripts/feed_digest.py --dump digests/mlb.mcdg
+  python scripts/feed_digest.py --serve 8002 --upstream https://host/
+
+Each source is fetched and parsed the way RssFetcher does it (RSS <item>
+title/description or the sports JSON shapes), run through a port of
+sanitizeRssTextInPlace(), classified with the table from
+gen_status_automaton.py, and written as one digest the device copies into
+its item records without any text parsing.
+
+Digest layout (see RssFetcher::parseDigest):
+  "MCDG" | u8 version | u8 item_count | u16 reserved | u32 generated_epoch
+  item = u8 flags | u8 title_len | u8 description_len | title | description
+Flags are final RssItemFlags (classified bit 0x80 set); text is display ASCII
+capped at the device field size.
+
+`--serve` runs the venue companion: GET <path>?<query> fetches
+<upstream><path>?<query> (point the device sports base URL here), and
+GET /digest?url=<feed url> fetches any other feed (use it as the NPR URL).
+Digests are cached for --ttl seconds so every panel shares one upstream fetch.
+A batch sports response (`@@section <league>` bodies) comes back with the same
+section lines, each followed by that league's digest.
+"""
+
+import argparse
+import gzip
+import http.server
+import json
+import os
+import re
+import socketserver
+import struct
+import sys
+import threading
+import time
+import urllib.parse
+import urllib.request
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gen_status_automaton as automaton  # noqa: E402
+
+MAGIC = b"MCDG"
+VERSION = 1
+HEADER = struct.Struct("<4sBBHI")
+ITEM = struct.Struct("<BBB")
+SECTION = b"@@section "  # batch sports section line, see RssFetcher::parseSections
+
+# Keep in sync with include/AppTypes.h.
+MAX_ITEMS = 30
+TITLE_LEN = 200
+DESC_LEN = 200
+FLAG_LIVE = 0x01
+FLAG_FINAL = 0x02
+FLAG_SCHEDULED = 0x04
+FLAG_POSTPONED = 0x08
+FLAG_CLASSIFIED = 0x80
+
+MAX_RESPONSE_BYTES = 64 * 1024
+JSON_WALK_MAX_DEPTH = 5
+SPACE = b" \t\n\v\f\r"
+
+# --- sanitizeRssTextInPlace() port (src/RssSanitizer.cpp) -------------------
+
+ENTITIES = {
+    b"&amp;": b"&", b"&lt;": b"<", b"&gt;": b">", b"&quot;": b"\"",
+    b"&apos;": b"'", b"&nbsp;": b" ", b"&mdash;": b"-", b"&ndash;": b"-",
+    b"&rsquo;": b"'", b"&lsquo;": b"'", b"&rdquo;": b"\"", b"&ldquo;": b"\"",
+    b"&hellip;": b"...", b"&copy;": b"(c)", b"&reg;": b"(R)",
+    b"&trade;": b"(TM)", b"&deg;": b"deg",
+}
+
+NUMERIC_PUNCTUATION = {
+    0x2013: b"-", 0x2014: b"-", 0x2018: b"'", 0x2019: b"'", 0x201C: b"\"",
+    0x201D: b"\"", 0x2022: b"*", 0x2026: b"...",
+}
+
+UTF8_PUNCTUATION = {
+    0x93: b"-", 0x94: b"-", 0x98: b"'", 0x99: b"'", 0x9C: b"\"", 0x9D: b"\"",
+    0xA2: b"*", 0xA6: b"...",
+}
+
+
+def strtol_prefix(digits, base):
+    match = re.match(rb"\s*[+-]?[0-9a-fA-F]*" if base == 16 else rb"\s*[+-]?[0-9]*", digits)
+    try:
+        return int(match.group(0), base)
+    except ValueError:
+        return 0
+
+
+def decode_numeric_entity(entity):
+    if len(entity) < 4 or entity[1:2] != b"#":
+        return None
+    pos, base = 2, 10
+    if entity[pos:pos + 1] in (b"x", b"X"):
+        base, pos = 16, pos + 1
+    digits = entity[pos:-1]
+    if not digits or len(digits) >= 12:
+        return None
+    codepoint = strtol_prefix(digits, base)
+    if 32 <= codepoint <= 126:
+        return bytes([codepoint])
+    return NUMERIC_PUNCTUATION.get(codepoint, b"?")
+
+
+def decode_entities(text):
+    out = bytearray()
+    i = 0
+    while i < len(text):
+        if text[i] != 0x26:  # '&'
+            out.append(text[i])
+            i += 1
+            continue
+        semi = text.find(b";", i)
+        entity_len = semi - i + 1 if semi >= 0 else 0
+        if semi < 0 or entity_len > 13:
+            out.append(text[i])
+            i += 1
+            continue
+        entity = text[i:semi + 1]
+        decoded = ENTITIES.get(entity)
+        if decoded is None:
+            decoded = decode_numeric_entity(entity)
+        if decoded is None:
+            out.append(text[i])
+            i += 1
+        else:
+            out += decoded
+            i += entity_len
+    return bytes(out)
+
+
+def strip_html_tags(text):
+    out = bytearray()
+    in_tag = False
+    for ch in text:
+        if ch == 0x3C:  # '<'
+            in_tag = True
+        elif ch == 0x3E and in_tag:  # '>'
+            in_tag = False
+        elif not in_tag:
+            out.append(ch)
+    return bytes(out)
+
+
+def utf8_to_display_ascii(text):
+    out = bytearray()
+    i = 0
+    last_space = False
+    while i < len(text):
+        b0 = text[i]
+        if 32 <= b0 <= 126:
+            if b0 != 0x20:
+                out.append(b0)
+                last_space = False
+            elif not last_space:
+                out.append(b0)
+                last_space = True
+            i += 1
+            continue
+        if b0 < 0xC0:
+            i += 1
+            continue
+        if b0 & 0xE0 == 0xC0:
+            seq = 2
+        elif b0 & 0xF0 == 0xE0:
+            seq = 3
+        elif b0 & 0xF8 == 0xF0:
+            seq = 4
+        else:
+            i += 1
+            continue
+        if i + seq - 1 >= len(text):
+            break
+        if seq == 3 and b0 == 0xE2 and text[i + 1] == 0x80:
+            out += UTF8_PUNCTUATION.get(text[i + 2], b"")
+            last_space = False
+        i += seq
+    return bytes(out)
+
+
+def sanitize(text):
+    text = re.sub(rb"<!\[CDATA\[|\]\]>", b"", text)
+    text = decode_entities(text)
+    text = strip_html_tags(text)
+    text = decode_entities(text)
+    text = utf8_to_display_ascii(text)
+    return text.strip(SPACE)
+
+
+# --- classifyRssItem() (src/RssClassifier.cpp) ------------------------------
+
+DELTA, OUT = automaton.build()
+STATE_FLAGS = {"live": FLAG_LIVE, "final": FLAG_FINAL, "scheduled": FLAG_SCHEDULED,
+               "postponed": FLAG_POSTPONED, "none": 0}
+
+
+def classify_status(text):
+    # The device scans UTF-8 bytes; non-ASCII bytes all fold to a word break.
+    raw = text.encode("utf-8").decode("latin-1")
+    return STATE_FLAGS[automaton.resolve(automaton.scan(DELTA, OUT, raw))]
+
+
+def classify_item(title, description):
+    hits = automaton.scan(DELTA, OUT, title.decode("latin-1"))
+    hits |= automaton.scan(DELTA, OUT, description.decode("latin-1"))
+    return STATE_FLAGS[automaton.resolve(hits)] | FLAG_CLASSIFIED
+
+
+# --- RssFetcher parse port (src/RssFetcher.cpp) -----------------------------
+
+def parse_rss_xml(payload):
+    items = []
+    cursor = 0
+    while len(items) < MAX_ITEMS:
+        start = payload.find(b"<item", cursor)
+        if start < 0:
+            break
+        open_end = payload.find(b">", start)
+        if open_end < 0:
+            break
+        end = payload.find(b"</item>", open_end + 1)
+        if end < 0:
+            break
+        body = payload[open_end + 1:end]
+        title = sanitize(tag_content(body, b"title"))[:TITLE_LEN]
+        if title:
+            items.append((title, sanitize(tag_content(body, b"description"))[:DESC_LEN]))
+        cursor = end + 7
+    return items
+
+
+def tag_content(body, tag):
+    start = body.find(b"<" + tag + b">")
+    if start < 0:
+        return b""
+    start += len(tag) + 2
+    stop = body.find(b"</" + tag + b">", start)
+    return body[start:stop] if stop >= 0 else b""
+
+
+def json_to_string(value):
+    if value is None or isinstance(value, (dict, list)):
+        return ""
+    if isinstance(value, str):
+        return value
+    if isinstance(value, bool):
+        return "true" if value else "false"
+    if isinstance(value, int):
+        return str(value)
+    return "%.2f" % value
+
+
+def read_field(obj, key):
+    value = obj.get(key) if isinstance(obj, dict) else None
+    if value is None:
+        return ""
+    return json_to_string(value).strip(" \t\n\v\f\r")
+
+
+def first_field(obj, keys):
+    for key in keys:
+        value = read_field(obj, key)
+        if value:
+            return value
+    return ""
+
+
+def team_name(value):
+    if isinstance(value, str):
+        return value.strip(" \t\n\v\f\r")
+    if not isinstance(value, dict):
+        return ""
+    name = first_field(value, ("displayName", "shortDisplayName", "abbreviation", "name"))
+    if name or value.get("team") is None:
+        return name
+    return team_name(value["team"])
+
+
+def normalize_hex(raw):
+    value = raw.strip(" \t\n\v\f\r")
+    if value.startswith("#"):
+        value = value[1:]
+    if len(value) != 6 or any(c not in "0123456789abcdefABCDEF" for c in value):
+        return ""
+    return value.upper()
+
+
+def team_color(value):
+    if isinstance(value, str):
+        return normalize_hex(value)
+    if not isinstance(value, dict):
+        return ""
+    color = normalize_hex(first_field(value, ("teamColor", "color", "primaryColor")))
+    if color or value.get("team") is None:
+        return color
+    return team_color(value["team"])
+
+
+def score_text(value):
+    if value is None:
+        return ""
+    if isinstance(value, dict):
+        return first_field(value, ("score", "value", "points"))
+    return json_to_string(value).strip(" \t\n\v\f\r")
+
+
+def score_value(text):
+    match = re.search(r"[0-9]+", text)
+    return int(match.group(0)) if match else None
+
+
+def color_wrap(text, color):
+    return "[[#%s]]%s[[/]]" % (color, text)
+
+
+def sports_headline(away, home, away_color, home_color, away_score, home_score, show):
+    away_display = color_wrap(away, away_color) if away_color else away
+    home_display = color_wrap(home, home_color) if home_color else home
+    if not show or not away_score or not home_score:
+        return "%s at %s" % (away_display, home_display)
+    away_value, home_value = score_value(away_score), score_value(home_score)
+    if away_value is not None and home_value is not None and away_value != home_value:
+        away_score = color_wrap(away_score, "00FF00" if away_value > home_value else "FF0000")
+        home_score = color_wrap(home_score, "00FF00" if home_value > away_value else "FF0000")
+    return "%s %s at %s %s" % (away_display, away_score, home_display, home_score)
+
+
+def nested_status(obj):
+    if not isinstance(obj, dict):
+        return ""
+    status = first_field(obj, ("status", "state", "short_status", "game_status"))
+    if status:
+        return status
+    node = obj.get("status")
+    if not isinstance(node, dict):
+        return ""
+    status = first_field(node, ("description", "detail"))
+    if status:
+        return status
+    kind = node.get("type")
+    if isinstance(kind, dict):
+        return first_field(kind, ("shortDetail", "detail", "description", "state"))
+    return ""
+
+
+def espn_event(obj):
+    competitions = obj.get("competitions")
+    if not isinstance(competitions, list) or not competitions:
+        return None
+    competition = competitions[0] if isinstance(competitions[0], dict) else {}
+    competitors = competition.get("competitors")
+    if not isinstance(competitors, list) or len(competitors) < 2:
+        return None
+
+    sides = {}
+    seen = []
+    for competitor in competitors:
+        if not isinstance(competitor, dict):
+            continue
+        name = team_name(competitor.get("team")) or team_name(competitor)
+        color = team_color(competitor.get("team")) or team_color(competitor)
+        entry = (name, score_text(competitor.get("score")), color)
+        side = read_field(competitor, "homeAway").lower()
+        if side in ("away", "home"):
+            sides[side] = entry
+        if name and len(seen) < 2:
+            seen.append(entry)
+
+    away, home = sides.get("away", ("", "", "")), sides.get("home", ("", "", ""))
+    if not away[0] or not home[0]:
+        if len(seen) < 2:
+            return None
+        away, home = seen
+
+    status = nested_status(competition) or nested_status(obj)
+    state = classify_status(status)
+    live = bool(state & FLAG_LIVE)
+    if not live:
+        node = competition.get("status")
+        if isinstance(node, dict) and isinstance(node.get("type"), dict):
+            raw = read_field(node["type"], "state").lower()
+            if raw:
+                live = raw in ("in", "live")
+    show = bool(away[1] and home[1]) and not (state & FLAG_SCHEDULED and not live)
+    title = sports_headline(away[0], home[0], away[2], home[2], away[1], home[1], show)
+    return title, status
+
+
+def home_away_pair(obj):
+    def first_name(keys):
+        for key in keys:
+            name = team_name(obj.get(key))
+            if name:
+                return name
+        return ""
+
+    def first_color(keys):
+        for key in keys:
+            color = normalize_hex(read_field(obj, key))
+            if color:
+                return color
+        return ""
+
+    def first_score(keys):
+        for key in keys:
+            score = score_text(obj.get(key))
+            if score:
+                return score
+        return ""
+
+    away = first_name(("away_team", "away", "visitor", "team1"))
+    home = first_name(("home_team", "home", "host", "team2"))
+    away_color = first_color(("away_team_color", "awayColor", "visitor_color", "team1Color",
+                              "away_color"))
+    home_color = first_color(("home_team_color", "homeColor", "host_color", "team2Color",
+                              "home_color"))
+    if not away or not home:
+        teams = obj.get("teams")
+        if isinstance(teams, list) and len(teams) >= 2:
+            away = away or team_name(teams[0])
+            home = home or team_name(teams[1])
+            away_color = away_color or team_color(teams[0])
+            home_color = home_color or team_color(teams[1])
+    if not away or not home:
+        return None
+
+    away_score = first_score(("away_score", "awayScore", "visitor_score", "score_away",
+                              "team1_score", "away_points"))
+    home_score = first_score(("home_score", "homeScore", "host_score", "score_home",
+                              "team2_score", "home_points"))
+    if not away_score and isinstance(obj.get("away"), dict):
+        away_score = score_text(obj["away"].get("score"))
+        away_color = away_color or team_color(obj["away"])
+    if not home_score and isinstance(obj.get("home"), dict):
+        home_score = score_text(obj["home"].get("score"))
+        home_color = home_color or team_color(obj["home"])
+
+    detail = read_field(obj, "detail") or read_field(obj, "summary") or nested_status(obj)
+    state = classify_status(detail)
+    live = obj.get("isLive") is True or obj.get("live") is True or bool(state & FLAG_LIVE)
+    show = bool(away_score and home_score) and not (state & FLAG_SCHEDULED and not live)
+    return sports_headline(away, home, away_color, home_color, away_score, home_score,
+                           show), detail
+
+
+def json_item(obj):
+    parsed = espn_event(obj) or home_away_pair(obj)
+    if parsed is not None:
+        return parsed
+    title = first_field(obj, ("title", "headline", "matchup", "event", "game"))
+    if not title:
+        return None
+    parts = [first_field(obj, ("description", "summary", "details", "detail", "text")),
+             nested_status(obj), read_field(obj, "score")]
+    return title, " | ".join(part for part in parts if part)
+
+
+def collect_json(node, items, depth):
+    if len(items) >= MAX_ITEMS or node is None or depth > JSON_WALK_MAX_DEPTH:
+        return
+    if isinstance(node, list):
+        for child in node:
+            collect_json(child, items, depth + 1)
+            if len(items) >= MAX_ITEMS:
+                return
+        return
+    if not isinstance(node, dict):
+        return
+    parsed = json_item(node)
+    if parsed is not None:
+        title = sanitize(parsed[0].encode("utf-8"))[:TITLE_LEN]
+        if title:
+            items.append((title, sanitize(parsed[1].encode("utf-8"))[:DESC_LEN]))
+            if len(items) >= MAX_ITEMS:
+                return
+    for child in node.values():
+        if isinstance(child, (dict, list)):
+            collect_json(child, items, depth + 1)
+            if len(items) >= MAX_ITEMS:
+                return
+
+
+def parse_json_feed(payload):
+    try:
+        doc = json.loads(payload.decode("utf-8", "replace"))
+    except ValueError:
+        return []
+    items = []
+    collect_json(doc, items, 0)
+    return items
+
+
+def parse_payload(url, payload):
+    payload = payload[:MAX_RESPONSE_BYTES]
+    looks_json = payload.lstrip()[:1] in (b"{", b"[")
+    lower = url.lower()
+    prefer_json = looks_json or any(m in lower for m in ("format=json", ".json", "_json.php"))
+    if prefer_json:
+        return parse_json_feed(payload) or parse_rss_xml(payload)
+    return parse_rss_xml(payload) or (parse_json_feed(payload) if looks_json else [])
+
+
+# --- digest encode/decode ---------------------------------------------------
+
+def encode(items, generated=None):
+    out = bytearray(HEADER.pack(MAGIC, VERSION, len(items), 0,
+                                int(time.time() if generated is None else generated)))
+    for title, description in items:
+        out += ITEM.pack(classify_item(title, description), len(title), len(description))
+        out += title + description
+    return bytes(out)
+
+
+def decode(data):
+    magic, version, count, _, generated = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not an MCDG v%d digest" % VERSION)
+    pos = HEADER.size
+    items = []
+    for _ in range(count):
+        flags, title_len, desc_len = ITEM.unpack_from(data, pos)
+        pos += ITEM.size
+        title = data[pos:pos + title_len]
+        description = data[pos + title_len:pos + title_len + desc_len]
+        pos += title_len + desc_len
+        if len(title) != title_len or len(description) != desc_len:
+            raise ValueError("digest truncated")
+        items.append((flags, title, description))
+    return generated, items
+
+
+def fetch(url):
+    request = urllib.request.Request(url, headers={"Accept-Encoding": "gzip",
+                                                   "User-Agent": "feed_digest/1"})
+    with urllib.request.urlopen(request, timeout=15) as response:
+        body = response.read()
+        if response.headers.get("Content-Encoding", "").lower() in ("gzip", "x-gzip"):
+            body = gzip.decompress(body)
+    return body
+
+
+def digest_url(url):
+    payload = fetch(url)
+    if not payload.startswith(SECTION):
+        items = parse_payload(url, payload)
+        return encode(items), len(payload), len(items)
+
+    # Batch sports response: keep the sections, digest each league's body.
+    out = bytearray()
+    total = 0
+    for chunk in payload[len(SECTION):].split(b"\n" + SECTION):
+        key, _, body = chunk.partition(b"\n")
+        items = parse_payload(url, body)
+        if items:
+            out += SECTION + key.strip() + b"\n" + encode(items) + b"\n"
+            total += len(items)
+    return bytes(out), len(payload), total
+
+
+# --- companion server -------------------------------------------------------
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    upstream = ""
+    ttl = 30
+    cache = {}
+    lock = threading.Lock()
+
+    def do_GET(self):
+        parsed = urllib.parse.urlsplit(self.path)
+        if parsed.path == "/digest":
+            url = urllib.parse.parse_qs(parsed.query).get("url", [""])[0]
+        elif Handler.upstream:
+            url = urllib.parse.urljoin(Handler.upstream, self.path.lstrip("/"))
+        else:
+            url = ""
+        if not url.startswith(("http://", "https://")):
+            self.send_error(404)
+            return
+
+        with Handler.lock:
+            entry = Handler.cache.get(url)
+            fresh = entry is not None and time.time() - entry[0] < Handler.ttl
+            if not fresh:
+                try:
+                    digest, raw_size, count = digest_url(url)
+                except Exception as err:  # upstream failure: keep a stale digest
+                    self.log_message("upstream %s failed: %s", url, err)
+                    if entry is None:
+                        self.send_error(502)
+                        return
+                    digest, raw_size, count = entry[1:]
+                else:
+                    Handler.cache[url] = (time.time(), digest, raw_size, count)
+                    self.log_message("digest %s items=%d raw=%d digest=%d", url, count,
+                                     raw_size, len(digest))
+            else:
+                digest = entry[1]
+
+        body = digest
+        gzip_ok = "gzip" in self.headers.get("Accept-Encoding", "")
+        if gzip_ok:
+            body = gzip.compress(digest, 9)
+        self.send_response(200)
+        self.send_header("Content-Type", "application/x-mcdg")
+        if gzip_ok:
+            self.send_header("Content-Encoding", "gzip")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+
+def dump(path):
+    generated, items = decode(open(path, "rb").read())
+    print("generated=%s items=%d" % (time.strftime("%Y-%m-%d %H:%M:%S",
+                                                   time.gmtime(generated)), len(items)))
+    for flags, title, description in items:
+        print("0x%02x %s | %s" % (flags, title.decode("ascii", "replace"),
+                                  description.decode("ascii", "replace")))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--source", action="append", default=[], metavar="NAME=URL")
+    parser.add_argument("--out-dir", default="digests")
+    parser.add_argument("--dump", metavar="FILE")
+    parser.add_argument("--serve", type=int, metavar="PORT")
+    parser.add_argument("--host", default="")
+    parser.add_argument("--upstream", default="", help="base URL for non-/digest paths")
+    parser.add_argument("--ttl", type=int, default=30)
+    args = parser.parse_args()
+
+    if args.dump:
+        dump(args.dump)
+        return
+    if args.serve:
+        Handler.upstream = args.upstream
+        Handler.ttl = args.ttl
+        socketserver.TCPServer.allow_reuse_address = True
+        with socketserver.ThreadingTCPServer((args.host, args.serve), Handler) as server:
+            print("Serving digests on port %d (upstream %s)" % (args.serve,
+                                                                args.upstream or "none"))
+            server.serve_forever()
+        return
+    if not args.source:
+        parser.error("give at least one --source, --dump or --serve")
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    for spec in args.source:
+        name, _, url = spec.partition("=")
+        digest, raw_size, count = digest_url(url)
+        path = os.path.join(args.out_dir, name + ".mcdg")
+        with open(path, "wb") as f:
+            f.write(digest)
+        print("%s items=%d raw=%d digest=%d -> %s" % (name, count, raw_size, len(digest), path))
+
+
+if __name__ == "__main__":
+    main()
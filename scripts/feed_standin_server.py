@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""Local RSS/JSON feed stand-in server for gzip decoding and sports batching.
+
+Serves a directory over plain HTTP. When the request carries
+`Accept-Encoding: gzip` the file is sent gzip-compressed (optionally with
+chunked transfer encoding, the way CDNs usually deliver it); otherwise it is
+sent as-is. Each response logs the wire and plain sizes.
+
+Example:
+  curl -s -o feeds/npr.xml https://feeds.npr.org/1001/rss.xml
+  python scripts/feed_standin_server.py --root feeds --chunked
+Then add http://<host-ip>:8001/npr.xml as a custom feed URL on the device.
+
+`--corrupt` flips a byte inside the first compressed body so the device's
+"Compressed body corrupt" path (and its retry) can be watched.
+`--fail-status 503` answers every request with that status instead, for
+watching the device's host breaker (stop the server to test refused
+connections).
+
+It also stands in for the sports backend: `espn_scores_rss.php?sport=<key>`
+returns `<root>/<key>.json`, and the batch form `?sports=mlb,nhl,...` returns
+one body with an `@@section <key>` line before each league's JSON (leagues
+without a file are left out). Set the device sports base URL to
+http://<host-ip>:8001/ with --root scripts/fixtures/sports; every request is
+logged, so single vs batch refreshes can be compared.
+"""
+
+import argparse
+import gzip
+import http.server
+import os
+import socketserver
+import urllib.parse
+
+
+class Handler(http.server.SimpleHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # chunked transfer encoding needs 1.1
+    chunked = False
+    corrupt = False
+    corrupted = False
+    fail_status = 0
+
+    def do_GET(self):
+        if Handler.fail_status:
+            self.send_error(Handler.fail_status)
+            return
+        parsed = urllib.parse.urlsplit(self.path)
+        if parsed.path.endswith("espn_scores_rss.php"):
+            plain = self.sports_body(urllib.parse.parse_qs(parsed.query))
+            if plain is None:
+                self.send_error(404)
+                return
+            path = "scores.json"
+        else:
+            path = self.translate_path(self.path)
+            if not os.path.isfile(path):
+                return super().do_GET()
+            plain = open(path, "rb").read()
+
+        accept = self.headers.get("Accept-Encoding", "")
+        gzip_ok = "gzip" in [token.split(";")[0].strip() for token in accept.split(",")]
+        body = gzip.compress(plain, 9) if gzip_ok else plain
+        if gzip_ok and Handler.corrupt and not Handler.corrupted:
+            Handler.corrupted = True
+            body = bytearray(body)
+            body[len(body) // 2] ^= 0xFF
+            body = bytes(body)
+
+        self.send_response(200)
+        self.send_header("Content-Type", self.guess_type(path))
+        if gzip_ok:
+            self.send_header("Content-Encoding", "gzip")
+        if Handler.chunked:
+            self.send_header("Transfer-Encoding", "chunked")
+        else:
+            self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+
+        if Handler.chunked:
+            for start in range(0, len(body), 1460):
+                piece = body[start:start + 1460]
+                self.wfile.write(b"%x\r\n%s\r\n" % (len(piece), piece))
+            self.wfile.write(b"0\r\n\r\n")
+        else:
+            self.wfile.write(body)
+        self.log_message("%s wire=%d plain=%d (%.1fx)", "gzip" if gzip_ok else "identity",
+                         len(body), len(plain), len(plain) / max(1, len(body)))
+
+    def sports_body(self, query):
+        if "sports" in query:
+            body = b""
+            for key in query["sports"][0].split(","):
+                name = key.strip() + ".json"
+                if os.path.isfile(name):
+                    body += b"@@section %s\n%s\n" % (key.strip().encode(),
+                                                      open(name, "rb").read().strip())
+            self.log_message("batch sports=%s", query["sports"][0])
+            return body
+        name = query.get("sport", [""])[0] + ".json"
+        return open(name, "rb").read() if os.path.isfile(name) else None
+
+    def guess_type(self, path):
+        if path.endswith(".xml"):
+            return "application/rss+xml"
+        return super().guess_type(path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=8001)
+    parser.add_argument("--host", default="")
+    parser.add_argument("--root", default="feeds")
+    parser.add_argument("--chunked", action="store_true")
+    parser.add_argument("--corrupt", action="store_true")
+    parser.add_argument("--fail-status", type=int, default=0)
+    args = parser.parse_args()
+
+    Handler.chunked = args.chunked
+    Handler.corrupt = args.corrupt
+    Handler.fail_status = args.fail_status
+    os.chdir(args.root)
+    socketserver.TCPServer.allow_reuse_address = True
+    with socketserver.ThreadingTCPServer((args.host, args.port), Handler) as server:
+        print("Serving %s on port %d" % (os.getcwd(), args.port))
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""Generate the RSS game-status automaton table (src/RssStatusAutomaton.h).
+
+Usage:
+  python scripts/gen_status_automaton.py            # rewrite the header
+  python scripts/gen_status_automaton.py --check    # verify corpus + header
+  python scripts/gen_status_automaton.py --bench    # compare scan cost
+
+The marker list below is compiled into an Aho-Corasick automaton and flattened
+into a full DFA over a small symbol alphabet, so the device classifies a title
+or status string with one table lookup per character. Text is folded before
+lookup: letters are lowercased, digits and `:` `/` `-` keep their own symbol,
+and everything else is a word break. The walk starts and ends on a virtual
+break, so a marker like " ot " only matches the whole word.
+
+`--check` runs scripts/espn_status_corpus.txt (real ESPN status strings with
+the expected state) through the DFA and fails if the checked-in header is out
+of date. `--bench` reports per-character table steps against the
+character comparisons of the old lowercase + indexOf marker scans.
+"""
+
+import argparse
+import os
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HEADER = os.path.join(ROOT, "src", "RssStatusAutomaton.h")
+CORPUS = os.path.join(ROOT, "scripts", "espn_status_corpus.txt")
+
+# Hit bits; keep in sync with RssStatusHit in src/RssClassifier.cpp.
+HITS = [
+    "LIVE",
+    "FINAL",
+    "SCHEDULED",
+    "POSTPONED",
+    "AT",
+    "MERIDIEM",
+    "COLON",
+    "TIMEZONE",
+]
+
+PATTERNS = [
+    # In-game markers (ESPN shortDetail/detail, feed titles).
+    (" in progress", "LIVE"),
+    (" live ", "LIVE"),
+    (" live:", "LIVE"),
+    (" halftime", "LIVE"),
+    (" top ", "LIVE"),
+    (" bot ", "LIVE"),
+    (" bottom ", "LIVE"),
+    (" mid ", "LIVE"),
+    (" middle of ", "LIVE"),
+    (" end ", "LIVE"),
+    (" start of ", "LIVE"),
+    (" q1 ", "LIVE"),
+    (" q2 ", "LIVE"),
+    (" q3 ", "LIVE"),
+    (" q4 ", "LIVE"),
+    (" qtr", "LIVE"),
+    (" quarter", "LIVE"),
+    (" period", "LIVE"),
+    (" half ", "LIVE"),
+    (" overtime", "LIVE"),
+    (" ot ", "LIVE"),
+    (" 2ot ", "LIVE"),
+    ("- 1st ", "LIVE"),
+    ("- 2nd ", "LIVE"),
+    ("- 3rd ", "LIVE"),
+    ("- 4th ", "LIVE"),
+    ("- ot ", "LIVE"),
+    # Finished.
+    (" final", "FINAL"),
+    (" completed", "FINAL"),
+    # Will not be played as scheduled.
+    (" postponed", "POSTPONED"),
+    (" ppd ", "POSTPONED"),
+    (" cancelled", "POSTPONED"),
+    (" canceled", "POSTPONED"),
+    (" suspended", "POSTPONED"),
+    (" forfeit", "POSTPONED"),
+    # Explicit pre-game.
+    (" scheduled", "SCHEDULED"),
+    (" pre-game", "SCHEDULED"),
+    (" pregame", "SCHEDULED"),
+    (" tbd ", "SCHEDULED"),
+    # Start-time evidence, resolved in classifier code.
+    (" at ", "AT"),
+    (" am ", "MERIDIEM"),
+    (" pm ", "MERIDIEM"),
+    (":", "COLON"),
+    (" et ", "TIMEZONE"),
+    (" est ", "TIMEZONE"),
+    (" edt ", "TIMEZONE"),
+    (" ct ", "TIMEZONE"),
+    (" cst ", "TIMEZONE"),
+    (" cdt ", "TIMEZONE"),
+    (" mt ", "TIMEZONE"),
+    (" pt ", "TIMEZONE"),
+    (" pst ", "TIMEZONE"),
+    (" pdt ", "TIMEZONE"),
+]
+
+# Symbol 0 is the word break; then a-z, 0-9, ':', '/', '-'.
+SYMBOLS = " abcdefghijklmnopqrstuvwxyz0123456789:/-"
+
+
+def fold(ch):
+    ch = ch.lower()
+    index = SYMBOLS.find(ch)
+    return index if index > 0 else 0
+
+
+def build():
+    goto = [{}]
+    out = [0]
+    for text, hit in PATTERNS:
+        state = 0
+        for sym in (fold(c) for c in text):
+            if sym not in goto[state]:
+                goto.append({})
+                out.append(0)
+                goto[state][sym] = len(goto) - 1
+            state = goto[state][sym]
+        out[state] |= 1 << HITS.index(hit)
+
+    fail = [0] * len(goto)
+    order = []
+    queue = list(goto[0].values())
+    while queue:
+        state = queue.pop(0)
+        order.append(state)
+        for sym, nxt in goto[state].items():
+            queue.append(nxt)
+            f = fail[state]
+            while f and sym not in goto[f]:
+                f = fail[f]
+            fail[nxt] = goto[f].get(sym, 0) if goto[f].get(sym, 0) != nxt else 0
+            out[nxt] |= out[fail[nxt]]
+
+    delta = [[0] * len(SYMBOLS) for _ in goto]
+    for sym in range(len(SYMBOLS)):
+        delta[0][sym] = goto[0].get(sym, 0)
+    for state in order:
+        for sym in range(len(SYMBOLS)):
+            delta[state][sym] = goto[state].get(sym, delta[fail[state]][sym])
+    return delta, out
+
+
+def scan(delta, out, text):
+    state = delta[0][0]
+    hits = out[state]
+    for ch in text:
+        state = delta[state][fold(ch)]
+        hits |= out[state]
+    state = delta[state][0]
+    return hits | out[state]
+
+
+def resolve(hits):
+    bit = lambda name: hits & (1 << HITS.index(name))
+    if bit("POSTPONED"):
+        return "postponed"
+    if bit("FINAL"):
+        return "final"
+    if bit("LIVE"):
+        return "live"
+    if bit("SCHEDULED") or (bit("MERIDIEM") and bit("COLON")) or \
+            (bit("AT") and bit("TIMEZONE")):
+        return "scheduled"
+    return "none"
+
+
+def render(delta, out):
+    state_type = "uint8_t" if len(delta) <= 256 else "uint16_t"
+    lines = [
+        "// Generated by scripts/gen_status_automaton.py - do not edit.",
+        "#ifndef RSS_STATUS_AUTOMATON_H",
+        "#define RSS_STATUS_AUTOMATON_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "namespace rss_status {",
+        "typedef %s State;" % state_type,
+        "constexpr uint16_t kStateCount = %d;" % len(delta),
+        "constexpr uint8_t kSymbolCount = %d;" % len(SYMBOLS),
+        "",
+        "// Symbol per byte: 0 = word break, 1..26 = a..z, 27..36 = 0..9, 37 ':', 38 '/', 39 '-'.",
+        "const uint8_t kSymbol[256] = {",
+    ]
+    symbols = [fold(chr(b)) if b < 128 else 0 for b in range(256)]
+    for row in range(0, 256, 16):
+        lines.append("    " + ", ".join("%d" % s for s in symbols[row:row + 16]) + ",")
+    lines += ["};", "", "const State kNext[kStateCount][kSymbolCount] = {"]
+    for row in delta:
+        lines.append("    {" + ", ".join("%d" % s for s in row) + "},")
+    lines += ["};", "", "const uint8_t kHits[kStateCount] = {"]
+    for row in range(0, len(out), 16):
+        lines.append("    " + ", ".join("0x%02x" % h for h in out[row:row + 16]) + ",")
+    lines += ["};", "}  // namespace rss_status", "", "#endif", ""]
+    return "\n".join(lines)
+
+
+def load_corpus():
+    cases = []
+    with open(CORPUS) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not line or line.startswith("#"):
+                continue
+            expected, text = line.split("\t", 1)
+            cases.append((expected, text))
+    return cases
+
+
+def naive_cost(text):
+    # The old path: lowercase copies plus one indexOf per marker per string.
+    markers = ["top of", "bottom of", "halftime", "qtr", "quarter", "period",
+               "in progress", "live", "final", "completed", "scheduled",
+               "pre-game", "pregame", " at ", ":", " am", " pm", " est",
+               " edt", " et", " final", "final ", "final/", "postponed",
+               "cancelled", "canceled", "suspended", "in progress", "halftime",
+               "top ", "bottom ", "bot ", "end of ", "start of ", "q1", "q2",
+               "q3", "q4", "1st period", "2nd period", "3rd period",
+               "overtime", " ot "]
+    lower = text.lower()
+    steps = len(text) * 4
+    for marker in markers:
+        for start in range(len(lower)):
+            i = 0
+            while i < len(marker) and start + i < len(lower) and \
+                    lower[start + i] == marker[i]:
+                i += 1
+            steps += i + 1
+            if i == len(marker):
+                break
+    return steps
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true")
+    parser.add_argument("--bench", action="store_true")
+    args = parser.parse_args()
+
+    delta, out = build()
+    header = render(delta, out)
+
+    if args.check or args.bench:
+        cases = load_corpus()
+        failures = 0
+        for expected, text in cases:
+            got = resolve(scan(delta, out, text))
+            if got != expected:
+                failures += 1
+                print("MISMATCH expected=%s got=%s text=%r" % (expected, got, text))
+        current = open(HEADER).read() if os.path.exists(HEADER) else ""
+        if current != header:
+            failures += 1
+            print("%s is stale; rerun without --check" % os.path.relpath(HEADER, ROOT))
+        print("states=%d table=%d bytes corpus=%d failures=%d" %
+              (len(delta), len(delta) * len(SYMBOLS) * (1 if len(delta) <= 256 else 2),
+               len(cases), failures))
+
+        if args.bench:
+            steps = sum(len(t) + 2 for _, t in cases)
+            naive = sum(naive_cost(t) for _, t in cases)
+            started = time.perf_counter()
+            for _ in range(200):
+                for _, text in cases:
+                    scan(delta, out, text)
+            elapsed = time.perf_counter() - started
+            print("dfa steps=%d naive compares=%d (%.1fx) host=%.2f us/string" %
+                  (steps, naive, naive / max(1, steps),
+                   elapsed * 1e6 / (200 * len(cases))))
+        sys.exit(1 if failures else 0)
+
+    with open(HEADER, "w") as f:
+        f.write(header)
+    print("wrote %s (%d states)" % (os.path.relpath(HEADER, ROOT), len(delta)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Build an MCDELTA1 firmware patch for OTA delta updates.
+
+Usage:
+  python scripts/make_delta.py old_firmware.bin new_firmware.bin out.delta \
+      --from-version 0.2.4 --url https://host/OTA/firmware-0.2.4-to-0.2.5.delta
+
+Patch layout (see include/DeltaPatcher.h):
+  "MCDELTA1" | u32 new_size | u32 old_size | zlib(records)
+  record = u32 add_len | u32 copy_len | i32 seek | add_len diff bytes | copy_len literal bytes
+
+Uses `bsdiff4` (pip install bsdiff4) for the match search when available and
+falls back to a slower built-in greedy matcher otherwise. The patch is applied
+back to the old image and compared byte-for-byte before it is written.
+"""
+
+import argparse
+import bz2
+import json
+import struct
+import sys
+import zlib
+
+MAGIC = b"MCDELTA1"
+BLOCK = 16
+MIN_MATCH = 24
+
+
+def offtin(buf):
+    value = int.from_bytes(buf[:7], "little") | ((buf[7] & 0x7F) << 56)
+    return -value if buf[7] & 0x80 else value
+
+
+def records_from_bsdiff4(old, new):
+    import bsdiff4  # noqa: imported lazily so the fallback works without it
+
+    patch = bsdiff4.diff(old, new)
+    if patch[:8] != b"BSDIFF40":
+        raise ValueError("unexpected bsdiff4 output")
+    ctrl_len = offtin(patch[8:16])
+    diff_len = offtin(patch[16:24])
+    ctrl = bz2.decompress(patch[32:32 + ctrl_len])
+    diff = bz2.decompress(patch[32 + ctrl_len:32 + ctrl_len + diff_len])
+    extra = bz2.decompress(patch[32 + ctrl_len + diff_len:])
+
+    records = []
+    diff_pos = extra_pos = 0
+    for i in range(0, len(ctrl), 24):
+        add = offtin(ctrl[i:i + 8])
+        copy = offtin(ctrl[i + 8:i + 16])
+        seek = offtin(ctrl[i + 16:i + 24])
+        records.append((add, copy, seek, diff[diff_pos:diff_pos + add],
+                        extra[extra_pos:extra_pos + copy]))
+        diff_pos += add
+        extra_pos += copy
+    return records
+
+
+def find_matches(old, new):
+    index = {}
+    for pos in range(0, len(old) - BLOCK + 1, 4):
+        index.setdefault(old[pos:pos + BLOCK], pos)
+
+    matches = []
+    cursor = 0
+    pos = 0
+    while pos <= len(new) - BLOCK:
+        match = index.get(new[pos:pos + BLOCK])
+        if match is None:
+            pos += 1
+            continue
+        start_new, start_old = pos, match
+        while start_new > cursor and start_old > 0 and \
+                new[start_new - 1] == old[start_old - 1]:
+            start_new -= 1
+            start_old -= 1
+        end_new, end_old = pos + BLOCK, match + BLOCK
+        # Extend through small mismatches (relocated pointers/constants) the
+        # way bsdiff does: the diff bytes stay mostly zero and compress well.
+        misses = 0
+        while end_new < len(new) and end_old < len(old):
+            if new[end_new] != old[end_old]:
+                misses += 1
+                if misses > 8:
+                    break
+            elif misses:
+                misses -= 1
+            end_new += 1
+            end_old += 1
+        while end_new > start_new and new[end_new - 1] != old[end_old - 1]:
+            end_new -= 1
+            end_old -= 1
+        if end_new - start_new < MIN_MATCH:
+            pos += 1
+            continue
+        matches.append((start_new, start_old, end_new - start_new))
+        cursor = pos = end_new
+    return matches
+
+
+def records_greedy(old, new):
+    matches = find_matches(old, new)
+    records = []
+    first_new = matches[0][0] if matches else len(new)
+    first_old = matches[0][1] if matches else 0
+    if first_new or not matches:
+        records.append((0, first_new, first_old, b"", new[:first_new]))
+    elif first_old:
+        records.append((0, 0, first_old, b"", b""))
+
+    for i, (start_new, start_old, length) in enumerate(matches):
+        end_new = start_new + length
+        if i + 1 < len(matches):
+            next_new, next_old = matches[i + 1][0], matches[i + 1][1]
+        else:
+            next_new, next_old = len(new), start_old + length
+        diff = bytes((new[start_new + j] - old[start_old + j]) & 0xFF for j in range(length))
+        records.append((length, next_new - end_new, next_old - (start_old + length),
+                        diff, new[end_new:next_new]))
+    return records
+
+
+def encode(records, old_size, new_size):
+    body = bytearray()
+    for add, copy, seek, diff, extra in records:
+        body += struct.pack("<IIi", add, copy, seek)
+        body += diff
+        body += extra
+    return MAGIC + struct.pack("<II", new_size, old_size) + zlib.compress(bytes(body), 9)
+
+
+def apply(old, patch):
+    if patch[:8] != MAGIC:
+        raise ValueError("bad magic")
+    new_size, old_size = struct.unpack("<II", patch[8:16])
+    body = zlib.decompress(patch[16:])
+    out = bytearray()
+    old_pos = pos = 0
+    while len(out) < new_size:
+        add, copy, seek = struct.unpack("<IIi", body[pos:pos + 12])
+        pos += 12
+        for i in range(add):
+            o = old_pos + i
+            base = old[o] if 0 <= o < old_size else 0
+            out.append((base + body[pos + i]) & 0xFF)
+        pos += add
+        old_pos += add
+        out += body[pos:pos + copy]
+        pos += copy
+        old_pos += seek
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument("out")
+    parser.add_argument("--from-version", default="")
+    parser.add_argument("--url", default="")
+    args = parser.parse_args()
+
+    old = open(args.old, "rb").read()
+    new = open(args.new, "rb").read()
+    try:
+        records = records_from_bsdiff4(old, new)
+        engine = "bsdiff4"
+    except ImportError:
+        records = records_greedy(old, new)
+        engine = "greedy"
+
+    patch = encode(records, len(old), len(new))
+    if apply(old, patch) != new:
+        sys.exit("patch verification failed")
+    with open(args.out, "wb") as f:
+        f.write(patch)
+
+    entry = {
+        "from_version": args.from_version,
+        "url": args.url,
+        "size": len(patch),
+    }
+    print("engine=%s old=%d new=%d patch=%d (%.1f%%)" %
+          (engine, len(old), len(new), len(patch), 100.0 * len(patch) / max(1, len(new))),
+          file=sys.stderr)
+    print(json.dumps({"delta": entry}, indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Local OTA stand-in server for exercising the resumable download path.
+
+Serves a directory over plain HTTP with `Range: bytes=N-` support and writes a
+`manifest.json` describing the given firmware/littlefs images. `--drop-after`
+cuts the first full-image response after N bytes so the device has to resume.
+
+Example:
+  python scripts/ota_standin_server.py --firmware .pio/build/esp32doit-devkit-v1/firmware.bin \
+      --version 9.9.9 --drop-after 700000
+Then set the device manifest URL to http://<host-ip>:8000/manifest.json.
+
+`--fake-size N` writes a random N-byte `fake.bin` instead, which is useful to
+watch transfer/resume/SHA-256 logging (the device will reject it at the final
+boot-partition check, as intended).
+"""
+
+import argparse
+import hashlib
+import http.server
+import json
+import os
+import re
+import shutil
+import socketserver
+
+
+def describe(path, url):
+    data = open(path, "rb").read()
+    return {
+        "url": url,
+        "size": len(data),
+        "md5": hashlib.md5(data).hexdigest(),
+        "sha256": hashlib.sha256(data).hexdigest(),
+    }
+
+
+class Handler(http.server.SimpleHTTPRequestHandler):
+    drop_after = 0
+    dropped = False
+
+    def do_GET(self):
+        path = self.translate_path(self.path)
+        if not os.path.isfile(path) or path.endswith(".json"):
+            return super().do_GET()
+
+        size = os.path.getsize(path)
+        start = 0
+        match = re.match(r"bytes=(\d+)-$", self.headers.get("Range", ""))
+        if match:
+            start = int(match.group(1))
+            if start >= size:
+                self.send_error(416)
+                return
+            self.send_response(206)
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (start, size - 1, size))
+        else:
+            self.send_response(200)
+        self.send_header("Content-Type", "application/octet-stream")
+        self.send_header("Content-Length", str(size - start))
+        self.send_header("Accept-Ranges", "bytes")
+        self.end_headers()
+
+        limit = size - start
+        if Handler.drop_after and not Handler.dropped and start == 0:
+            Handler.dropped = True
+            limit = min(limit, Handler.drop_after)
+            self.log_message("dropping connection after %d bytes", limit)
+
+        with open(path, "rb") as f:
+            f.seek(start)
+            remaining = limit
+            while remaining > 0:
+                chunk = f.read(min(16384, remaining))
+                if not chunk:
+                    break
+                self.wfile.write(chunk)
+                remaining -= len(chunk)
+        if limit < size - start:
+            self.close_connection = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--host", default="")
+    parser.add_argument("--public-host", help="host:port used in manifest URLs")
+    parser.add_argument("--root", default="ota_standin")
+    parser.add_argument("--version", default="9.9.9")
+    parser.add_argument("--firmware")
+    parser.add_argument("--littlefs")
+    parser.add_argument("--littlefs-version", default="9.9.9")
+    parser.add_argument("--fake-size", type=int, default=0)
+    parser.add_argument("--drop-after", type=int, default=0)
+    args = parser.parse_args()
+
+    os.makedirs(args.root, exist_ok=True)
+    base = "http://%s" % (args.public_host or "localhost:%d" % args.port)
+    manifest = {"version": args.version}
+
+    firmware = args.firmware
+    if args.fake_size:
+        firmware = os.path.join(args.root, "fake.bin")
+        with open(firmware, "wb") as f:
+            f.write(os.urandom(args.fake_size))
+    if firmware:
+        name = os.path.basename(firmware)
+        if os.path.abspath(firmware) != os.path.abspath(os.path.join(args.root, name)):
+            shutil.copyfile(firmware, os.path.join(args.root, name))
+        manifest["firmware"] = describe(os.path.join(args.root, name), base + "/" + name)
+    if args.littlefs:
+        name = os.path.basename(args.littlefs)
+        shutil.copyfile(args.littlefs, os.path.join(args.root, name))
+        entry = describe(os.path.join(args.root, name), base + "/" + name)
+        entry["version"] = args.littlefs_version
+        manifest["littlefs"] = entry
+
+    with open(os.path.join(args.root, "manifest.json"), "w") as f:
+        json.dump(manifest, f, indent=2)
+    print(json.dumps(manifest, indent=2))
+
+    Handler.drop_after = args.drop_after
+    os.chdir(args.root)
+    socketserver.TCPServer.allow_reuse_address = True
+    with socketserver.ThreadingTCPServer((args.host, args.port), Handler) as server:
+        print("Serving %s on port %d" % (os.getcwd(), args.port))
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
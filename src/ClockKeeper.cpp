@@ -0,0 +1,230 @@
+#include "ClockKeeper.h"
+
+#include <esp_attr.h>
+#include <esp_sntp.h>
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "Crc32.h"
+
+namespace {
+constexpr uint32_t kRecordMagic = 0x434C4B31;  // "CLK1"
+constexpr time_t kMinValidEpoch = 1704067200;  // 2024-01-01
+constexpr uint32_t kInitialResyncMs = 6UL * 60UL * 60UL * 1000UL;
+constexpr uint32_t kMinResyncMs = 60UL * 60UL * 1000UL;
+constexpr uint32_t kMaxResyncMs = 48UL * 60UL * 60UL * 1000UL;
+// A sync this close to the estimate lets the interval grow; the display only
+// shows minutes, so a couple of seconds is plenty.
+constexpr int32_t kSteadyOffsetMs = 2000;
+// Shorter spans are dominated by network jitter rather than crystal drift.
+constexpr uint32_t kMinDriftSpanMs = 30UL * 60UL * 1000UL;
+constexpr float kDriftGain = 0.5f;
+constexpr float kMaxDriftPpm = 200.0f;
+
+struct ClockRecord {
+  uint32_t magic;
+  uint32_t lastSyncEpoch;
+  float driftPpm;
+  uint32_t resyncIntervalMs;
+  uint32_t syncs;
+  uint32_t crc;
+};
+
+// Survives software resets and panics; garbage after power-on, which the
+// magic/CRC check rejects.
+RTC_NOINIT_ATTR ClockRecord gClockRecord;
+
+// Written by the SNTP callback on the lwIP task, taken by poll().
+portMUX_TYPE gSyncMux = portMUX_INITIALIZER_UNLOCKED;
+bool gSyncReady = false;
+int64_t gSyncEpochMs = 0;
+uint32_t gSyncAtMs = 0;
+
+uint32_t recordCrc(const ClockRecord& record) {
+  return crc32Compute(&record, offsetof(ClockRecord, crc));
+}
+}  // namespace
+
+ClockKeeper::ClockKeeper()
+    : _tz(nullptr),
+      _synced(false),
+      _restored(false),
+      _waiting(false),
+      _baseMeasured(false),
+      _baseEpochMs(0),
+      _baseMs(0),
+      _resyncDueMs(0),
+      _driftPpm(0.0f),
+      _resyncIntervalMs(kInitialResyncMs),
+      _syncs(0),
+      _lastOffsetMs(0),
+      _lastSyncEpoch(0) {}
+
+bool ClockKeeper::begin(const char* tz) {
+  _tz = tz;
+  setenv("TZ", _tz, 1);
+  tzset();
+  sntp_set_time_sync_notification_cb(onTimeSync);
+  return restore();
+}
+
+void ClockKeeper::startSync(const char* server1, const char* server2,
+                            const char* server3) {
+  if (_waiting) {
+    Serial.println("[NTP] Previous request got no reply");
+  }
+  _waiting = true;
+  // Restarts the SNTP client, which sends its first request right away.
+  configTzTime(_tz, server1, server2, server3);
+}
+
+bool ClockKeeper::poll() {
+  portENTER_CRITICAL(&gSyncMux);
+  const bool ready = gSyncReady;
+  const int64_t serverMs = gSyncEpochMs;
+  const uint32_t atMs = gSyncAtMs;
+  gSyncReady = false;
+  portEXIT_CRITICAL(&gSyncMux);
+  if (!ready) {
+    return false;
+  }
+  _waiting = false;
+  if (serverMs / 1000 < kMinValidEpoch) {
+    Serial.println("[NTP] Sync failed: invalid epoch");
+    return false;
+  }
+
+  if (_synced) {
+    const int64_t offsetMs = serverMs - estimateEpochMs(atMs);
+    _lastOffsetMs = offsetMs > INT32_MAX   ? INT32_MAX
+                    : offsetMs < INT32_MIN ? INT32_MIN
+                                           : static_cast<int32_t>(offsetMs);
+    const uint32_t spanMs = atMs - _baseMs;
+    if (_baseMeasured && spanMs >= kMinDriftSpanMs) {
+      const float residualPpm = static_cast<float>(offsetMs) * 1e6f / spanMs;
+      _driftPpm = constrain(_driftPpm + residualPpm * kDriftGain, -kMaxDriftPpm,
+                            kMaxDriftPpm);
+    }
+    if (abs(_lastOffsetMs) <= kSteadyOffsetMs) {
+      _resyncIntervalMs =
+          _resyncIntervalMs < kMaxResyncMs / 2 ? _resyncIntervalMs * 2 : kMaxResyncMs;
+    } else {
+      _resyncIntervalMs =
+          _resyncIntervalMs / 2 > kMinResyncMs ? _resyncIntervalMs / 2 : kMinResyncMs;
+    }
+  }
+
+  _synced = true;
+  _restored = false;
+  _baseMeasured = true;
+  _baseEpochMs = serverMs;
+  _baseMs = atMs;
+  _resyncDueMs = atMs + _resyncIntervalMs;
+  _lastSyncEpoch = static_cast<uint32_t>(serverMs / 1000);
+  _syncs++;
+  persist();
+
+  Serial.print("[NTP] Sync ok epoch=");
+  Serial.print(_lastSyncEpoch);
+  Serial.print(" offset=");
+  Serial.print(_lastOffsetMs);
+  Serial.print("ms drift=");
+  Serial.print(_driftPpm);
+  Serial.print("ppm next=");
+  Serial.print(_resyncIntervalMs / 60000UL);
+  Serial.println("min");
+  return true;
+}
+
+bool ClockKeeper::synced() const { return _synced; }
+
+bool ClockKeeper::waiting() const { return _waiting; }
+
+time_t ClockKeeper::now() const {
+  return _synced ? static_cast<time_t>(estimateEpochMs(millis()) / 1000) : 0;
+}
+
+uint32_t ClockKeeper::msUntilResync(uint32_t nowMs) const {
+  const int32_t remaining = static_cast<int32_t>(_resyncDueMs - nowMs);
+  return remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+}
+
+void ClockKeeper::stats(ClockStats& outStats) const {
+  outStats.synced = _synced;
+  outStats.restored = _restored;
+  outStats.waiting = _waiting;
+  outStats.syncs = _syncs;
+  outStats.lastOffsetMs = _lastOffsetMs;
+  outStats.driftPpm = _driftPpm;
+  outStats.resyncIntervalMs = _resyncIntervalMs;
+  outStats.lastSyncEpoch = _lastSyncEpoch;
+}
+
+// Runs on the lwIP task right after SNTP has set the system time.
+void ClockKeeper::onTimeSync(struct timeval* tv) {
+  if (tv == nullptr) {
+    return;
+  }
+  const uint32_t atMs = millis();
+  portENTER_CRITICAL(&gSyncMux);
+  gSyncEpochMs = static_cast<int64_t>(tv->tv_sec) * 1000 + tv->tv_usec / 1000;
+  gSyncAtMs = atMs;
+  gSyncReady = true;
+  portEXIT_CRITICAL(&gSyncMux);
+}
+
+int64_t ClockKeeper::estimateEpochMs(uint32_t atMs) const {
+  const uint32_t elapsedMs = atMs - _baseMs;
+  return _baseEpochMs + elapsedMs +
+         static_cast<int64_t>(static_cast<double>(elapsedMs) * _driftPpm / 1e6);
+}
+
+// The system time itself rides through a software reset in the RTC, so the
+// record only has to vouch for it having come from a sync, and carries the
+// learned drift and interval across.
+bool ClockKeeper::restore() {
+  if (gClockRecord.magic != kRecordMagic || gClockRecord.crc != recordCrc(gClockRecord)) {
+    return false;
+  }
+  struct timeval tv = {};
+  gettimeofday(&tv, nullptr);
+  if (tv.tv_sec < kMinValidEpoch ||
+      tv.tv_sec < static_cast<time_t>(gClockRecord.lastSyncEpoch)) {
+    return false;
+  }
+
+  const uint32_t nowMs = millis();
+  const uint32_t ageS = static_cast<uint32_t>(tv.tv_sec - gClockRecord.lastSyncEpoch);
+  const uint32_t ageMs = ageS < kMaxResyncMs / 1000UL ? ageS * 1000UL : kMaxResyncMs;
+  _synced = true;
+  _restored = true;
+  _baseMeasured = false;
+  _baseEpochMs = static_cast<int64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+  _baseMs = nowMs;
+  _driftPpm = constrain(gClockRecord.driftPpm, -kMaxDriftPpm, kMaxDriftPpm);
+  _resyncIntervalMs = constrain(gClockRecord.resyncIntervalMs, kMinResyncMs, kMaxResyncMs);
+  _resyncDueMs = nowMs + (ageMs < _resyncIntervalMs ? _resyncIntervalMs - ageMs : 0);
+  _syncs = gClockRecord.syncs;
+  _lastSyncEpoch = gClockRecord.lastSyncEpoch;
+
+  Serial.print("[NTP] Restored time base epoch=");
+  Serial.print(static_cast<uint32_t>(tv.tv_sec));
+  Serial.print(" age=");
+  Serial.print(ageS);
+  Serial.print("s drift=");
+  Serial.print(_driftPpm);
+  Serial.println("ppm");
+  return true;
+}
+
+void ClockKeeper::persist() const {
+  ClockRecord record = {};
+  record.magic = kRecordMagic;
+  record.lastSyncEpoch = _lastSyncEpoch;
+  record.driftPpm = _driftPpm;
+  record.resyncIntervalMs = _resyncIntervalMs;
+  record.syncs = _syncs;
+  record.crc = recordCrc(record);
+  gClockRecord = record;
+}
@@ -0,0 +1,23 @@
+#include "Crc32.h"
+
+namespace {
+// Nibble table keeps flash use at 64 bytes while staying ~4x faster than a
+// bitwise loop; settings/cache records are at most a few KB.
+constexpr uint32_t kCrcNibbleTable[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+    0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+    0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+};
+}  // namespace
+
+uint32_t crc32Update(uint32_t crc, const void* data, size_t length) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= bytes[i];
+    crc = (crc >> 4) ^ kCrcNibbleTable[crc & 0x0Fu];
+    crc = (crc >> 4) ^ kCrcNibbleTable[crc & 0x0Fu];
+  }
+  return ~crc;
+}
@@ -0,0 +1,216 @@
+#include "DeltaPatcher.h"
+
+#include <string.h>
+
+namespace {
+const uint8_t kMagic[8] = {'M', 'C', 'D', 'E', 'L', 'T', 'A', '1'};
+constexpr size_t kOldChunkSize = 256;
+
+uint32_t readLe32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+         (static_cast<uint32_t>(data[2]) << 16) |
+         (static_cast<uint32_t>(data[3]) << 24);
+}
+}  // namespace
+
+DeltaPatcher::DeltaPatcher()
+    : _inflater(),
+      _source(nullptr),
+      _write(nullptr),
+      _context(nullptr),
+      _stage(Stage::Failed),
+      _header{},
+      _control{},
+      _pending(0),
+      _newSize(0),
+      _oldSize(0),
+      _written(0),
+      _oldPos(0),
+      _addLeft(0),
+      _copyLeft(0),
+      _seek(0),
+      _error("not started") {}
+
+bool DeltaPatcher::begin(const esp_partition_t* source, WriteFn write,
+                         void* context) {
+  end();
+  if (source == nullptr || write == nullptr) {
+    return fail("missing source partition or writer");
+  }
+  _source = source;
+  _write = write;
+  _context = context;
+  _stage = Stage::Header;
+  _pending = 0;
+  _newSize = 0;
+  _oldSize = 0;
+  _written = 0;
+  _oldPos = 0;
+  _addLeft = 0;
+  _copyLeft = 0;
+  _seek = 0;
+  _error = "";
+  return true;
+}
+
+void DeltaPatcher::end() { _inflater.end(); }
+
+bool DeltaPatcher::feed(const uint8_t* data, size_t length) {
+  if (_stage == Stage::Failed) {
+    return false;
+  }
+
+  if (_stage == Stage::Header) {
+    const size_t take = length < kHeaderSize - _pending ? length : kHeaderSize - _pending;
+    memcpy(_header + _pending, data, take);
+    _pending += take;
+    data += take;
+    length -= take;
+    if (_pending < kHeaderSize) {
+      return true;
+    }
+
+    if (memcmp(_header, kMagic, sizeof(kMagic)) != 0) {
+      return fail("bad patch magic");
+    }
+    _newSize = readLe32(_header + 8);
+    _oldSize = readLe32(_header + 12);
+    if (_newSize == 0 || _oldSize > _source->size) {
+      return fail("bad patch header");
+    }
+    if (!_inflater.begin(Inflater::Format::Zlib)) {
+      return fail("inflater allocation failed");
+    }
+    _pending = 0;
+    _stage = Stage::Control;
+  }
+
+  if (length == 0 || _stage == Stage::Done) {
+    return true;
+  }
+
+  const Inflater::Result result = _inflater.write(data, length, onInflated, this);
+  if (result == Inflater::Result::Error) {
+    return fail("patch stream corrupt");
+  }
+  if (result == Inflater::Result::Aborted) {
+    return false;
+  }
+  if (result == Inflater::Result::Done) {
+    _inflater.end();
+    if (_stage != Stage::Done) {
+      return fail("patch ended before image was complete");
+    }
+  }
+  return true;
+}
+
+bool DeltaPatcher::finished() const { return _stage == Stage::Done; }
+
+uint32_t DeltaPatcher::newSize() const { return _newSize; }
+
+uint32_t DeltaPatcher::written() const { return _written; }
+
+const char* DeltaPatcher::error() const { return _error; }
+
+bool DeltaPatcher::onInflated(const uint8_t* data, size_t length, void* context) {
+  return static_cast<DeltaPatcher*>(context)->consume(data, length);
+}
+
+bool DeltaPatcher::consume(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    if (_stage == Stage::Control) {
+      const size_t take = length < sizeof(_control) - _pending
+                              ? length
+                              : sizeof(_control) - _pending;
+      memcpy(_control + _pending, data, take);
+      _pending += take;
+      data += take;
+      length -= take;
+      if (_pending < sizeof(_control)) {
+        continue;
+      }
+
+      _pending = 0;
+      _addLeft = readLe32(_control);
+      _copyLeft = readLe32(_control + 4);
+      _seek = static_cast<int32_t>(readLe32(_control + 8));
+      if (static_cast<uint64_t>(_written) + _addLeft + _copyLeft > _newSize) {
+        return fail("patch record overruns image");
+      }
+      _stage = _addLeft > 0 ? Stage::Add : Stage::Copy;
+    } else if (_stage == Stage::Add) {
+      const size_t take = length < _addLeft ? length : _addLeft;
+      if (!emitAdd(data, take)) {
+        return false;
+      }
+      data += take;
+      length -= take;
+      _addLeft -= take;
+      if (_addLeft == 0) {
+        _stage = Stage::Copy;
+      }
+    } else if (_stage == Stage::Copy) {
+      const size_t take = length < _copyLeft ? length : _copyLeft;
+      if (take > 0) {
+        if (!_write(data, take, _context)) {
+          return fail("image write failed");
+        }
+        _written += take;
+        data += take;
+        length -= take;
+        _copyLeft -= take;
+      }
+    } else {
+      return fail("patch has trailing data");
+    }
+
+    if (_stage == Stage::Copy && _copyLeft == 0) {
+      _oldPos += _seek;
+      _stage = _written == _newSize ? Stage::Done : Stage::Control;
+    }
+  }
+  return true;
+}
+
+bool DeltaPatcher::emitAdd(const uint8_t* diff, size_t length) {
+  uint8_t old[kOldChunkSize];
+  while (length > 0) {
+    const size_t take = length < kOldChunkSize ? length : kOldChunkSize;
+    // bsdiff treats bytes outside the old image as zero.
+    memset(old, 0, take);
+    int64_t begin = _oldPos;
+    int64_t stop = _oldPos + static_cast<int64_t>(take);
+    if (begin < 0) {
+      begin = 0;
+    }
+    if (stop > static_cast<int64_t>(_oldSize)) {
+      stop = _oldSize;
+    }
+    if (stop > begin &&
+        esp_partition_read(_source, static_cast<size_t>(begin),
+                           old + (begin - _oldPos),
+                           static_cast<size_t>(stop - begin)) != ESP_OK) {
+      return fail("source partition read failed");
+    }
+
+    for (size_t i = 0; i < take; i++) {
+      old[i] = static_cast<uint8_t>(old[i] + diff[i]);
+    }
+    if (!_write(old, take, _context)) {
+      return fail("image write failed");
+    }
+    _written += take;
+    _oldPos += take;
+    diff += take;
+    length -= take;
+  }
+  return true;
+}
+
+bool DeltaPatcher::fail(const char* message) {
+  _error = message;
+  _stage = Stage::Failed;
+  _inflater.end();
+  return false;
+}
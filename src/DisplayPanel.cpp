@@ -1,17 +1,49 @@
 #include "DisplayPanel.h"
 
+#include <string.h>
+
 #include "AppConfig.h"
 
+namespace {
+constexpr uint32_t kOutputTaskStackWords = 2048;
+constexpr UBaseType_t kOutputTaskPriority = 3;  // above loopTask so frames leave on time
+constexpr BaseType_t kOutputTaskCore = 1;       // WiFi/lwIP live on core 0
+// WS2812 wire time: 24 bits at 1.25 us per LED plus the latch gap.
+constexpr uint32_t kWireUsPerLed = 30;
+constexpr uint32_t kLatchUs = 80;
+
+static_assert(APP_LED_OUTPUTS == 1 || APP_LED_OUTPUTS == 2 || APP_LED_OUTPUTS == 4,
+              "APP_LED_OUTPUTS must be 1, 2 or 4");
+}  // namespace
+
 DisplayPanel::DisplayPanel(uint16_t width, uint8_t height)
     : _width(width),
       _height(height),
       _numLeds(width * height),
       _brightness(APP_DEFAULT_BRIGHTNESS),
       _leds(nullptr),
-      _matrix(nullptr) {}
+      _frontLeds(nullptr),
+      _matrix(nullptr),
+      _outputTask(nullptr),
+      _frameFree(nullptr),
+      _frames(0),
+      _lastOutputUs(0),
+      _maxOutputUs(0),
+      _totalOutputUs(0),
+      _expectedOutputUs(0),
+      _slowFrames(0),
+      _showWaits(0),
+      _maxShowWaitUs(0) {}
 
 DisplayPanel::~DisplayPanel() {
+  if (_outputTask != nullptr) {
+    vTaskDelete(_outputTask);
+  }
+  if (_frameFree != nullptr) {
+    vSemaphoreDelete(_frameFree);
+  }
   delete _matrix;
+  delete[] _frontLeds;
   delete[] _leds;
 }
 
@@ -19,11 +51,21 @@ bool DisplayPanel::begin() {
   if (_width == 0 || _height == 0 || (_width % 8) != 0) {
     return false;
   }
+  // Every output carries whole 8-wide tile columns.
+  if (((_width / 8) % APP_LED_OUTPUTS) != 0) {
+    return false;
+  }
 
   _leds = new CRGB[_numLeds];
-  if (_leds == nullptr) {
+  _frontLeds = new CRGB[_numLeds];
+  if (_leds == nullptr || _frontLeds == nullptr) {
     return false;
   }
+  fill_solid(_leds, _numLeds, CRGB(0, 0, 0));
+  fill_solid(_frontLeds, _numLeds, CRGB(0, 0, 0));
+  // Outputs clock out side by side, so a frame costs one span's wire time.
+  const uint16_t ledsPerOutput = _numLeds / APP_LED_OUTPUTS;
+  _expectedOutputUs = (static_cast<uint32_t>(ledsPerOutput) * kWireUsPerLed) + kLatchUs;
 
   _matrix = new FastLED_NeoMatrix(
       _leds, 8, _height, _width / 8, 1,
@@ -33,7 +75,24 @@ bool DisplayPanel::begin() {
     return false;
   }
 
-  FastLED.addLeds<NEOPIXEL, LED_STRIP_GPIO>(_leds, _numLeds);
+  // The matrix draws into the back buffer; the strip is fed from the front
+  // buffer, so a frame on the wire is never touched by the next draw. The
+  // matrix chain is linear in the buffer, so extra outputs just take later
+  // spans of it; the I2S driver shifts all registered pins out in one pass.
+  FastLED.addLeds<NEOPIXEL, LED_STRIP_GPIO>(_frontLeds, ledsPerOutput);
+#if APP_LED_OUTPUTS >= 2
+  FastLED.addLeds<NEOPIXEL, LED_STRIP_GPIO_2>(_frontLeds + ledsPerOutput, ledsPerOutput);
+#endif
+#if APP_LED_OUTPUTS == 4
+  FastLED.addLeds<NEOPIXEL, LED_STRIP_GPIO_3>(_frontLeds + (2 * ledsPerOutput), ledsPerOutput);
+  FastLED.addLeds<NEOPIXEL, LED_STRIP_GPIO_4>(_frontLeds + (3 * ledsPerOutput), ledsPerOutput);
+#endif
+  Serial.print("[LED] Outputs=");
+  Serial.print(APP_LED_OUTPUTS);
+  Serial.print(" LedsPerOutput=");
+  Serial.print(ledsPerOutput);
+  Serial.print(" ExpectedFrameUs=");
+  Serial.println(_expectedOutputUs);
   _matrix->begin();
   // Match rssArduinoPlatform: Adafruit GFX built-in 5x7 bitmap font.
   _matrix->setFont(nullptr);
@@ -41,7 +100,25 @@ bool DisplayPanel::begin() {
   _matrix->setTextWrap(false);
   _matrix->setBrightness(_brightness);
   _matrix->fillScreen(0);
-  _matrix->show();
+
+#if APP_LED_OUTPUT_TASK
+  _frameFree = xSemaphoreCreateBinary();
+  if (_frameFree != nullptr) {
+    xSemaphoreGive(_frameFree);
+    if (xTaskCreatePinnedToCore(outputTask, "led_output", kOutputTaskStackWords, this,
+                                kOutputTaskPriority, &_outputTask,
+                                kOutputTaskCore) != pdPASS) {
+      _outputTask = nullptr;
+      Serial.println("[LED] Output task start failed; showing inline");
+    } else {
+      // Frames are shown exactly once, so temporal dithering would only
+      // freeze one dither phase per frame.
+      FastLED.setDither(DISABLE_DITHER);
+    }
+  }
+#endif
+
+  show();
   return true;
 }
 
@@ -85,8 +162,34 @@ void DisplayPanel::drawTextAtColored(int16_t x, const char* text,
 }
 
 void DisplayPanel::show() {
-  if (_matrix != nullptr) {
-    _matrix->show();
+  if (_matrix == nullptr) {
+    return;
+  }
+
+  if (_outputTask == nullptr) {
+    memcpy(_frontLeds, _leds, _numLeds * sizeof(CRGB));
+    outputFrame();
+    return;
+  }
+
+  if (xSemaphoreTake(_frameFree, 0) != pdTRUE) {
+    const uint32_t waitStartUs = micros();
+    xSemaphoreTake(_frameFree, portMAX_DELAY);
+    const uint32_t waitUs = micros() - waitStartUs;
+    _showWaits++;
+    if (waitUs > _maxShowWaitUs) {
+      _maxShowWaitUs = waitUs;
+    }
+  }
+  memcpy(_frontLeds, _leds, _numLeds * sizeof(CRGB));
+  xTaskNotifyGive(_outputTask);
+}
+
+void DisplayPanel::delay(uint32_t ms) {
+  if (_outputTask != nullptr) {
+    ::delay(ms);
+  } else {
+    FastLED.delay(ms);
   }
 }
 
@@ -100,3 +203,48 @@ uint16_t DisplayPanel::color(uint8_t r, uint8_t g, uint8_t b) const {
   }
   return _matrix->Color(r, g, b);
 }
+
+void DisplayPanel::frameStats(DisplayFrameStats& outStats) const {
+  const uint32_t frames = _frames;
+  outStats.frames = frames;
+  outStats.lastOutputUs = _lastOutputUs;
+  outStats.maxOutputUs = _maxOutputUs;
+  outStats.avgOutputUs =
+      frames > 0 ? static_cast<uint32_t>(_totalOutputUs / frames) : 0;
+  outStats.expectedOutputUs = _expectedOutputUs;
+  outStats.slowFrames = _slowFrames;
+  outStats.showWaits = _showWaits;
+  outStats.maxShowWaitUs = _maxShowWaitUs;
+  outStats.outputTask = _outputTask != nullptr;
+  outStats.outputs = APP_LED_OUTPUTS;
+}
+
+void DisplayPanel::outputTask(void* param) {
+  static_cast<DisplayPanel*>(param)->outputLoop();
+}
+
+void DisplayPanel::outputLoop() {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    outputFrame();
+    xSemaphoreGive(_frameFree);
+  }
+}
+
+// A frame that takes well over its wire time was stretched by interrupts
+// (the classic WiFi-induced glitch), so count it.
+void DisplayPanel::outputFrame() {
+  const uint32_t startUs = micros();
+  FastLED.show();
+  const uint32_t outputUs = micros() - startUs;
+
+  _lastOutputUs = outputUs;
+  if (outputUs > _maxOutputUs) {
+    _maxOutputUs = outputUs;
+  }
+  _totalOutputUs += outputUs;
+  if (outputUs > _expectedOutputUs + (_expectedOutputUs / 4)) {
+    _slowFrames++;
+  }
+  _frames++;
+}
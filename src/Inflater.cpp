@@ -0,0 +1,190 @@
+#include "Inflater.h"
+
+#include <esp32/rom/miniz.h>
+
+#include <new>
+
+namespace {
+constexpr size_t kWindowSize = TINFL_LZ_DICT_SIZE;
+
+constexpr size_t kGzipFixedHeader = 10;
+constexpr uint8_t kGzipFlagHeaderCrc = 0x02;
+constexpr uint8_t kGzipFlagExtra = 0x04;
+constexpr uint8_t kGzipFlagName = 0x08;
+constexpr uint8_t kGzipFlagComment = 0x10;
+
+enum GzipStage : uint8_t {
+  kGzipFixed,
+  kGzipExtraLow,
+  kGzipExtraHigh,
+  kGzipExtra,
+  kGzipName,
+  kGzipComment,
+  kGzipHeaderCrc,
+  kGzipBody,
+};
+}  // namespace
+
+Inflater::Inflater()
+    : _decompressor(nullptr),
+      _window(nullptr),
+      _windowOffset(0),
+      _flags(0),
+      _totalOut(0),
+      _gzipStage(kGzipBody),
+      _gzipFlags(0),
+      _gzipRemaining(0) {}
+
+Inflater::~Inflater() { end(); }
+
+bool Inflater::begin(Format format) {
+  end();
+  _decompressor = new (std::nothrow) tinfl_decompressor;
+  _window = new (std::nothrow) uint8_t[kWindowSize];
+  if (_decompressor == nullptr || _window == nullptr) {
+    end();
+    return false;
+  }
+  tinfl_init(_decompressor);
+  _windowOffset = 0;
+  _totalOut = 0;
+  _flags = TINFL_FLAG_HAS_MORE_INPUT;
+  if (format == Format::Zlib) {
+    _flags |= TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_COMPUTE_ADLER32;
+  }
+  // Gzip is a raw DEFLATE stream behind a variable-length header.
+  _gzipStage = format == Format::Gzip ? kGzipFixed : kGzipBody;
+  _gzipFlags = 0;
+  _gzipRemaining = kGzipFixedHeader;
+  return true;
+}
+
+void Inflater::end() {
+  delete _decompressor;
+  delete[] _window;
+  _decompressor = nullptr;
+  _window = nullptr;
+  _windowOffset = 0;
+}
+
+Inflater::Result Inflater::write(const uint8_t* data, size_t length,
+                                 OutputFn output, void* context) {
+  if (_decompressor == nullptr) {
+    return Result::Error;
+  }
+
+  if (_gzipStage != kGzipBody) {
+    const int consumed = consumeGzipHeader(data, length);
+    if (consumed < 0) {
+      return Result::Error;
+    }
+    data += consumed;
+    length -= static_cast<size_t>(consumed);
+    if (_gzipStage != kGzipBody) {
+      return Result::NeedsInput;
+    }
+  }
+
+  while (true) {
+    size_t inBytes = length;
+    size_t outBytes = kWindowSize - _windowOffset;
+    const tinfl_status status =
+        tinfl_decompress(_decompressor, data, &inBytes, _window,
+                         _window + _windowOffset, &outBytes, _flags);
+    data += inBytes;
+    length -= inBytes;
+
+    if (outBytes > 0) {
+      if (!output(_window + _windowOffset, outBytes, context)) {
+        return Result::Aborted;
+      }
+      _windowOffset = (_windowOffset + outBytes) & (kWindowSize - 1);
+      _totalOut += outBytes;
+    }
+
+    if (status == TINFL_STATUS_DONE) {
+      return Result::Done;
+    }
+    if (status < 0) {
+      return Result::Error;
+    }
+    if (status == TINFL_STATUS_NEEDS_MORE_INPUT && length == 0) {
+      return Result::NeedsInput;
+    }
+  }
+}
+
+uint32_t Inflater::totalOut() const { return _totalOut; }
+
+int Inflater::consumeGzipHeader(const uint8_t* data, size_t length) {
+  size_t used = 0;
+  while (used < length && _gzipStage != kGzipBody) {
+    const uint8_t value = data[used++];
+    switch (_gzipStage) {
+      case kGzipFixed: {
+        // ID1 ID2 CM FLG MTIME(4) XFL OS
+        const size_t offset = kGzipFixedHeader - _gzipRemaining;
+        if ((offset == 0 && value != 0x1F) || (offset == 1 && value != 0x8B) ||
+            (offset == 2 && value != 8)) {
+          return -1;
+        }
+        if (offset == 3) {
+          _gzipFlags = value;
+        }
+        if (--_gzipRemaining == 0) {
+          _gzipStage = kGzipExtraLow;
+        }
+        break;
+      }
+      case kGzipExtraLow:
+        _gzipRemaining = value;
+        _gzipStage = kGzipExtraHigh;
+        break;
+      case kGzipExtraHigh:
+        _gzipRemaining = static_cast<uint16_t>(_gzipRemaining | (value << 8));
+        _gzipStage = _gzipRemaining > 0 ? kGzipExtra : kGzipName;
+        break;
+      case kGzipExtra:
+        if (--_gzipRemaining == 0) {
+          _gzipStage = kGzipName;
+        }
+        break;
+      case kGzipName:
+        if (value == 0) {
+          _gzipStage = kGzipComment;
+        }
+        break;
+      case kGzipComment:
+        if (value == 0) {
+          _gzipStage = kGzipHeaderCrc;
+        }
+        break;
+      case kGzipHeaderCrc:
+        if (--_gzipRemaining == 0) {
+          _gzipStage = kGzipBody;
+        }
+        break;
+      default:
+        break;
+    }
+
+    // Step over optional fields the FLG byte says are absent.
+    if (_gzipStage == kGzipExtraLow && (_gzipFlags & kGzipFlagExtra) == 0) {
+      _gzipStage = kGzipName;
+    }
+    if (_gzipStage == kGzipName && (_gzipFlags & kGzipFlagName) == 0) {
+      _gzipStage = kGzipComment;
+    }
+    if (_gzipStage == kGzipComment && (_gzipFlags & kGzipFlagComment) == 0) {
+      _gzipStage = kGzipHeaderCrc;
+    }
+    if (_gzipStage == kGzipHeaderCrc) {
+      if ((_gzipFlags & kGzipFlagHeaderCrc) == 0) {
+        _gzipStage = kGzipBody;
+      } else if (_gzipRemaining == 0) {
+        _gzipRemaining = 2;
+      }
+    }
+  }
+  return static_cast<int>(used);
+}
@@ -5,9 +5,13 @@
 #include <HTTPClient.h>
 #include <LittleFS.h>
 #include <Preferences.h>
-#include <Update.h>
 #include <WiFiClient.h>
 #include <WiFiClientSecure.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/md.h>
+
+#include "Crc32.h"
+#include "DeltaPatcher.h"
 
 #if __has_include("Secrets.h")
 #include "Secrets.h"
@@ -26,8 +30,154 @@ const char* kBackupLengthKey = "len";
 const char* kBackupBlobKey = "blob";
 const char* kOtaMetaNamespace = "ota_meta";
 const char* kLittleFsVersionKey = "fs_ver";
+
+// Image download pipeline. Chunks never straddle a flash sector, so every
+// sector is erased exactly once right before its first write and progress can
+// be checkpointed on sector boundaries.
+constexpr uint32_t kFlashSectorSize = 4096;
+constexpr uint8_t kDownloadAttempts = 5;
+constexpr uint32_t kDownloadRetryDelayMs = 1500;
+constexpr uint32_t kDownloadStallTimeoutMs = 10000;
+constexpr uint32_t kProgressPersistBytes = 64UL * 1024UL;
+constexpr size_t kDeltaChunkSize = 1024;
+const char* kDownloadNamespace = "ota_dl";
+const char* kDownloadKeyKey = "key";
+const char* kDownloadSizeKey = "size";
+const char* kDownloadOffsetKey = "off";
+const char* kDownloadCrcKey = "crc";
+
+class ImageDigest {
+public:
+  ImageDigest() {
+    mbedtls_md_init(&_sha256);
+    mbedtls_md_init(&_md5);
+  }
+  ~ImageDigest() {
+    mbedtls_md_free(&_sha256);
+    mbedtls_md_free(&_md5);
+  }
+
+  bool begin() {
+    mbedtls_md_free(&_sha256);
+    mbedtls_md_free(&_md5);
+    mbedtls_md_init(&_sha256);
+    mbedtls_md_init(&_md5);
+    return mbedtls_md_setup(&_sha256, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 0) == 0 &&
+           mbedtls_md_setup(&_md5, mbedtls_md_info_from_type(MBEDTLS_MD_MD5), 0) == 0 &&
+           mbedtls_md_starts(&_sha256) == 0 && mbedtls_md_starts(&_md5) == 0;
+  }
+
+  void update(const uint8_t* data, size_t length) {
+    mbedtls_md_update(&_sha256, data, length);
+    mbedtls_md_update(&_md5, data, length);
+  }
+
+  String finishSha256() { return finish(_sha256, 32); }
+  String finishMd5() { return finish(_md5, 16); }
+
+private:
+  static String finish(mbedtls_md_context_t& ctx, size_t length) {
+    uint8_t digest[32] = {0};
+    mbedtls_md_finish(&ctx, digest);
+    static const char kHex[] = "0123456789abcdef";
+    String out;
+    out.reserve(length * 2);
+    for (size_t i = 0; i < length; i++) {
+      out += kHex[digest[i] >> 4];
+      out += kHex[digest[i] & 0x0F];
+    }
+    return out;
+  }
+
+  mbedtls_md_context_t _sha256;
+  mbedtls_md_context_t _md5;
+};
+
+bool beginHttp(HTTPClient& http, WiFiClient& plainClient,
+               WiFiClientSecure& secureClient, const String& url) {
+  http.setTimeout(kHttpTimeoutMs);
+  http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+  secureClient.setInsecure();
+  if (url.startsWith("https://")) {
+    return http.begin(secureClient, url);
+  }
+  return http.begin(plainClient, url);
+}
+
+// Erases each sector the first time a write reaches it; `erasedEnd` tracks
+// the first sector not yet erased.
+bool writePartitionBytes(const esp_partition_t* partition, uint32_t offset,
+                         uint32_t& erasedEnd, const uint8_t* data, size_t length) {
+  if (offset + length > partition->size) {
+    return false;
+  }
+  while (erasedEnd < offset + length) {
+    if (esp_partition_erase_range(partition, erasedEnd, kFlashSectorSize) != ESP_OK) {
+      return false;
+    }
+    erasedEnd += kFlashSectorSize;
+  }
+  return esp_partition_write(partition, offset, data, length) == ESP_OK;
+}
+
+struct PartitionSink {
+  const esp_partition_t* partition;
+  uint32_t offset;
+  uint32_t erasedEnd;
+  ImageDigest* digest;
+};
+
+bool writeToPartitionSink(const uint8_t* data, size_t length, void* context) {
+  PartitionSink* sink = static_cast<PartitionSink*>(context);
+  if (!writePartitionBytes(sink->partition, sink->offset, sink->erasedEnd, data,
+                           length)) {
+    return false;
+  }
+  sink->digest->update(data, length);
+  sink->offset += length;
+  return true;
+}
+
+// Progress is keyed by the manifest SHA-256 (or URL when absent) plus size so
+// a different image never resumes on top of stale bytes.
+bool loadDownloadProgress(const String& key, uint32_t size, uint32_t& outOffset,
+                          uint32_t& outCrc) {
+  Preferences prefs;
+  if (!prefs.begin(kDownloadNamespace, true)) {
+    return false;
+  }
+  const bool match = prefs.getString(kDownloadKeyKey, "") == key &&
+                     prefs.getUInt(kDownloadSizeKey, 0) == size;
+  outOffset = prefs.getUInt(kDownloadOffsetKey, 0);
+  outCrc = prefs.getUInt(kDownloadCrcKey, 0);
+  prefs.end();
+  return match && outOffset > 0 && outOffset < size &&
+         (outOffset % kFlashSectorSize) == 0;
+}
+
+void persistDownloadProgress(const String& key, uint32_t size, uint32_t offset,
+                             uint32_t crc) {
+  Preferences prefs;
+  if (!prefs.begin(kDownloadNamespace, false)) {
+    return;
+  }
+  prefs.putString(kDownloadKeyKey, key);
+  prefs.putUInt(kDownloadSizeKey, size);
+  prefs.putUInt(kDownloadOffsetKey, offset);
+  prefs.putUInt(kDownloadCrcKey, crc);
+  prefs.end();
 }
 
+void clearDownloadProgress() {
+  Preferences prefs;
+  if (!prefs.begin(kDownloadNamespace, false)) {
+    return;
+  }
+  prefs.clear();
+  prefs.end();
+}
+}  // namespace
+
 OtaService::OtaService(WifiService& wifiService)
     : _wifiService(wifiService),
       _state(OtaState::Idle),
@@ -39,6 +189,9 @@ OtaService::OtaService(WifiService& wifiService)
       _firmwareMd5(""),
       _firmwareSha256(""),
       _firmwareSize(0),
+      _deltaUrl(""),
+      _deltaSize(0),
+      _lastInstallUsedDelta(false),
       _hasPendingFirmwareUpdate(false),
       _currentLittleFsVersion(""),
       _availableLittleFsVersion(""),
@@ -48,7 +201,11 @@ OtaService::OtaService(WifiService& wifiService)
       _littleFsSize(0),
       _hasPendingLittleFsUpdate(false),
       _lastError(""),
-      _lastCheckedMs(0) {}
+      _lastCheckedMs(0),
+      _downloadOffset(0),
+      _downloadSize(0),
+      _downloadResumeCount(0),
+      _lastImageSha256Verified(false) {}
 
 void OtaService::begin(const char* currentVersion) {
   if (currentVersion != nullptr && currentVersion[0] != '\0') {
@@ -63,6 +220,8 @@ void OtaService::begin(const char* currentVersion) {
   _firmwareMd5 = "";
   _firmwareSha256 = "";
   _firmwareSize = 0;
+  _deltaUrl = "";
+  _deltaSize = 0;
   _littleFsUrl = "";
   _littleFsMd5 = "";
   _littleFsSha256 = "";
@@ -140,83 +299,35 @@ bool OtaService::installAvailableFirmwareUpdate() {
     return false;
   }
 
-  _state = OtaState::Downloading;
-  clearError();
-
-  HTTPClient http;
-  http.setTimeout(kHttpTimeoutMs);
-  http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
-
-  WiFiClient plainClient;
-  WiFiClientSecure secureClient;
-  secureClient.setInsecure();
-
-  bool beginOk = false;
-  if (firmwareUrl.startsWith("https://")) {
-    beginOk = http.begin(secureClient, firmwareUrl);
-  } else {
-    beginOk = http.begin(plainClient, firmwareUrl);
-  }
-  if (!beginOk) {
-    setError("Failed to begin firmware download");
+  const esp_partition_t* partition = esp_ota_get_next_update_partition(nullptr);
+  if (partition == nullptr) {
+    setError("No OTA app partition available");
     return false;
   }
 
-  const int code = http.GET();
-  if (code != HTTP_CODE_OK) {
-    http.end();
-    setError(String("Firmware HTTP error: ") + code);
-    return false;
-  }
-
-  const int contentLength = http.getSize();
-  if (_firmwareSize > 0 && contentLength > 0 &&
-      static_cast<uint32_t>(contentLength) != _firmwareSize) {
-    http.end();
-    setError("Firmware size mismatch versus manifest");
-    return false;
-  }
-
-  size_t updateSize = UPDATE_SIZE_UNKNOWN;
-  if (_firmwareSize > 0) {
-    updateSize = _firmwareSize;
-  } else if (contentLength > 0) {
-    updateSize = static_cast<size_t>(contentLength);
-  }
-
-  _state = OtaState::Installing;
-  if (!Update.begin(updateSize)) {
-    http.end();
-    setError(String("Update begin failed: ") + Update.errorString());
-    return false;
-  }
-
-  if (_firmwareMd5.length() == 32) {
-    if (!Update.setMD5(_firmwareMd5.c_str())) {
-      Update.abort();
-      http.end();
-      setError("Failed to set OTA MD5");
-      return false;
+  // A delta only applies cleanly to the exact running build, so it needs the
+  // full-image SHA-256 to prove the result; any failure falls back to the
+  // full download.
+  bool installed = false;
+  if (_deltaUrl.length() > 0 && _firmwareSha256.length() == 64) {
+    installed = installDeltaFirmwareUpdate(partition);
+    if (!installed) {
+      Serial.print("[OTA] Delta install failed: ");
+      Serial.print(_lastError);
+      Serial.println("; falling back to full image");
     }
   }
+  _lastInstallUsedDelta = installed;
 
-  WiFiClient& stream = http.getStream();
-  const size_t written = Update.writeStream(stream);
-  if (updateSize != UPDATE_SIZE_UNKNOWN && written != updateSize) {
-    Update.abort();
-    http.end();
-    setError("Incomplete OTA write");
+  if (!installed && !downloadImage("Firmware", partition, firmwareUrl,
+                                   _firmwareSize, _firmwareMd5, _firmwareSha256)) {
     return false;
   }
 
-  const bool endOk = Update.end(true);
-  http.end();
-  if (!endOk) {
-    setError(String("Update end failed: ") + Update.errorString());
-    return false;
-  }
-  if (!Update.isFinished()) {
-    setError("OTA did not finish");
+  // Validates the app image header/checksum before switching slots.
+  const esp_err_t err = esp_ota_set_boot_partition(partition);
+  if (err != ESP_OK) {
+    setError(String("Set boot partition failed: ") + esp_err_to_name(err));
     return false;
   }
 
@@ -236,101 +347,343 @@ bool OtaService::installAvailableLittleFsUpdate() {
     setError("No OTA littlefs URL is available");
     return false;
   }
+
+  const esp_partition_t* partition = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "littlefs");
+  if (partition == nullptr) {
+    setError("No littlefs partition available");
+    return false;
+  }
+
   if (!backupSettingsForLittleFsUpdate()) {
     setError("Failed to backup settings before littlefs update");
     return false;
   }
 
+  LittleFS.end();
+
+  if (!downloadImage("LittleFS", partition, littleFsUrl, _littleFsSize,
+                     _littleFsMd5, _littleFsSha256)) {
+    return false;
+  }
+
+  if (_availableLittleFsVersion.length() > 0) {
+    persistCurrentLittleFsVersion(_availableLittleFsVersion);
+    _currentLittleFsVersion = _availableLittleFsVersion;
+  }
+
+  _state = OtaState::RebootRequired;
+  _hasPendingLittleFsUpdate = false;
+  clearError();
+  return true;
+}
+
+// Downloads an MCDELTA1 patch and rebuilds the new image from the running
+// slot into `partition` as the patch streams in.
+bool OtaService::installDeltaFirmwareUpdate(const esp_partition_t* partition) {
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  if (running == nullptr) {
+    setError("Running partition unknown");
+    return false;
+  }
+
+  // Patching overwrites the slot, so any checkpointed full download is void.
+  clearDownloadProgress();
   _state = OtaState::Downloading;
+  _lastImageSha256Verified = false;
+  _downloadOffset = 0;
+  _downloadSize = _firmwareSize;
   clearError();
 
   HTTPClient http;
-  http.setTimeout(kHttpTimeoutMs);
-  http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
-
   WiFiClient plainClient;
   WiFiClientSecure secureClient;
-  secureClient.setInsecure();
-
-  bool beginOk = false;
-  if (littleFsUrl.startsWith("https://")) {
-    beginOk = http.begin(secureClient, littleFsUrl);
-  } else {
-    beginOk = http.begin(plainClient, littleFsUrl);
-  }
-  if (!beginOk) {
-    setError("Failed to begin littlefs download");
+  if (!beginHttp(http, plainClient, secureClient, _deltaUrl)) {
+    setError("Failed to begin delta download");
     return false;
   }
-
   const int code = http.GET();
   if (code != HTTP_CODE_OK) {
     http.end();
-    setError(String("LittleFS HTTP error: ") + code);
+    setError(String("Delta HTTP error: ") + code);
     return false;
   }
-
   const int contentLength = http.getSize();
-  if (_littleFsSize > 0 && contentLength > 0 &&
-      static_cast<uint32_t>(contentLength) != _littleFsSize) {
+  if (_deltaSize > 0 && contentLength > 0 &&
+      static_cast<uint32_t>(contentLength) != _deltaSize) {
     http.end();
-    setError("LittleFS size mismatch versus manifest");
+    setError("Delta size mismatch versus manifest");
     return false;
   }
 
-  size_t updateSize = UPDATE_SIZE_UNKNOWN;
-  if (_littleFsSize > 0) {
-    updateSize = _littleFsSize;
-  } else if (contentLength > 0) {
-    updateSize = static_cast<size_t>(contentLength);
+  std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[kDeltaChunkSize]);
+  ImageDigest digest;
+  if (!buffer || !digest.begin()) {
+    http.end();
+    setError("Delta buffer allocation failed");
+    return false;
   }
 
-  LittleFS.end();
+  PartitionSink sink = {partition, 0, 0, &digest};
+  DeltaPatcher patcher;
+  patcher.begin(running, writeToPartitionSink, &sink);
+
+  WiFiClient& stream = http.getStream();
+  uint32_t received = 0;
+  uint32_t lastDataMs = millis();
+  while (!patcher.finished()) {
+    const int available = stream.available();
+    if (available <= 0) {
+      if (!http.connected() ||
+          static_cast<uint32_t>(millis() - lastDataMs) >= kDownloadStallTimeoutMs) {
+        break;
+      }
+      delay(2);
+      continue;
+    }
+    const size_t want = static_cast<size_t>(available) < kDeltaChunkSize
+                            ? static_cast<size_t>(available)
+                            : kDeltaChunkSize;
+    const size_t got = stream.readBytes(buffer.get(), want);
+    if (got == 0) {
+      continue;
+    }
+    lastDataMs = millis();
+    received += got;
+    if (!patcher.feed(buffer.get(), got)) {
+      http.end();
+      setError(String("Delta patch failed: ") + patcher.error());
+      return false;
+    }
+    _downloadOffset = sink.offset;
+  }
+  http.end();
+  patcher.end();
+
+  if (!patcher.finished()) {
+    setError("Delta download incomplete");
+    return false;
+  }
+  if (_firmwareSize > 0 && patcher.newSize() != _firmwareSize) {
+    setError("Delta output size mismatch versus manifest");
+    return false;
+  }
 
   _state = OtaState::Installing;
-  if (!Update.begin(updateSize, U_SPIFFS, -1, LOW, "littlefs")) {
-    http.end();
-    setError(String("LittleFS begin failed: ") + Update.errorString());
+  if (digest.finishSha256() != _firmwareSha256) {
+    setError("Delta result SHA-256 mismatch");
+    return false;
+  }
+  _lastImageSha256Verified = true;
+
+  Serial.print("[OTA] Delta applied patch=");
+  Serial.print(received);
+  Serial.print(" bytes image=");
+  Serial.print(patcher.newSize());
+  Serial.println(" bytes");
+  return true;
+}
+
+// Streams an image straight into its partition while hashing it. Drops are
+// resumed with HTTP Range requests; sector-aligned progress is kept in NVS so
+// an interrupted install continues after a reboot instead of starting over.
+bool OtaService::downloadImage(const char* label, const esp_partition_t* partition,
+                               const String& url, uint32_t expectedSize,
+                               const String& md5Hex, const String& sha256Hex) {
+  _state = OtaState::Downloading;
+  _lastImageSha256Verified = false;
+  _downloadOffset = 0;
+  _downloadSize = expectedSize;
+  clearError();
+
+  if (expectedSize > partition->size) {
+    setError(String(label) + " image larger than partition");
+    return false;
+  }
+
+  std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[kFlashSectorSize]);
+  ImageDigest digest;
+  if (!buffer || !digest.begin()) {
+    setError(String(label) + " download buffer allocation failed");
     return false;
   }
 
-  if (_littleFsMd5.length() == 32) {
-    if (!Update.setMD5(_littleFsMd5.c_str())) {
-      Update.abort();
+  const String progressKey = sha256Hex.length() == 64 ? sha256Hex : url;
+  uint32_t imageSize = expectedSize;
+  uint32_t offset = 0;
+  uint32_t crc = 0;
+
+  uint32_t savedCrc = 0;
+  if (imageSize > 0 && loadDownloadProgress(progressKey, imageSize, offset, savedCrc)) {
+    // Rebuild hash state from the bytes already in flash.
+    for (uint32_t pos = 0; pos < offset; pos += kFlashSectorSize) {
+      if (esp_partition_read(partition, pos, buffer.get(), kFlashSectorSize) != ESP_OK) {
+        offset = 0;
+        break;
+      }
+      digest.update(buffer.get(), kFlashSectorSize);
+      crc = crc32Update(crc, buffer.get(), kFlashSectorSize);
+    }
+    if (offset == 0 || crc != savedCrc) {
+      Serial.println("[OTA] Saved progress did not match flash; restarting download");
+      offset = 0;
+      crc = 0;
+      digest.begin();
+    } else {
+      Serial.print("[OTA] Resuming ");
+      Serial.print(label);
+      Serial.print(" at ");
+      Serial.print(offset);
+      Serial.print("/");
+      Serial.println(imageSize);
+      _downloadResumeCount++;
+    }
+  }
+
+  uint32_t erasedEnd = offset;
+  uint32_t persistedOffset = offset;
+  int lastHttpCode = 0;
+
+  for (uint8_t attempt = 0; attempt < kDownloadAttempts; attempt++) {
+    if (imageSize > 0 && offset >= imageSize) {
+      break;
+    }
+    if (attempt > 0) {
+      Serial.print("[OTA] ");
+      Serial.print(label);
+      Serial.print(" transfer interrupted at ");
+      Serial.print(offset);
+      Serial.println("; retrying");
+      _downloadResumeCount++;
+      delay(kDownloadRetryDelayMs);
+    }
+    if (!_wifiService.isConnected()) {
+      break;
+    }
+
+    HTTPClient http;
+    WiFiClient plainClient;
+    WiFiClientSecure secureClient;
+    if (!beginHttp(http, plainClient, secureClient, url)) {
+      continue;
+    }
+    if (offset > 0) {
+      http.addHeader("Range", String("bytes=") + offset + "-");
+    }
+
+    lastHttpCode = http.GET();
+    const int contentLength = http.getSize();
+    uint32_t skip = 0;
+    if (lastHttpCode == HTTP_CODE_OK) {
+      if (imageSize == 0 && contentLength > 0) {
+        imageSize = static_cast<uint32_t>(contentLength);
+        _downloadSize = imageSize;
+      } else if (contentLength > 0 && static_cast<uint32_t>(contentLength) != imageSize) {
+        http.end();
+        setError(String(label) + " size mismatch versus manifest");
+        return false;
+      }
+      // Server ignored Range: discard the part already written.
+      skip = offset;
+    } else if (lastHttpCode == HTTP_CODE_PARTIAL_CONTENT && offset > 0) {
+      if (contentLength > 0 &&
+          static_cast<uint32_t>(contentLength) != imageSize - offset) {
+        http.end();
+        setError(String(label) + " range response size mismatch");
+        return false;
+      }
+    } else {
+      http.end();
+      continue;
+    }
+
+    if (imageSize == 0 || imageSize > partition->size) {
       http.end();
-      setError("Failed to set littlefs MD5");
+      setError(String(label) + " image size unknown or larger than partition");
       return false;
     }
-  }
 
-  WiFiClient& stream = http.getStream();
-  const size_t written = Update.writeStream(stream);
-  if (updateSize != UPDATE_SIZE_UNKNOWN && written != updateSize) {
-    Update.abort();
+    WiFiClient& stream = http.getStream();
+    uint32_t lastDataMs = millis();
+    while (offset < imageSize) {
+      const int available = stream.available();
+      if (available <= 0) {
+        if (!http.connected() ||
+            static_cast<uint32_t>(millis() - lastDataMs) >= kDownloadStallTimeoutMs) {
+          break;
+        }
+        delay(2);
+        continue;
+      }
+
+      size_t want = static_cast<size_t>(available);
+      if (skip > 0) {
+        want = want < kFlashSectorSize ? want : kFlashSectorSize;
+        want = want < skip ? want : skip;
+        const size_t discarded = stream.readBytes(buffer.get(), want);
+        skip -= discarded;
+        lastDataMs = millis();
+        continue;
+      }
+
+      const uint32_t sectorRemaining = kFlashSectorSize - (offset % kFlashSectorSize);
+      const uint32_t imageRemaining = imageSize - offset;
+      want = want < sectorRemaining ? want : sectorRemaining;
+      want = want < imageRemaining ? want : imageRemaining;
+      const size_t got = stream.readBytes(buffer.get(), want);
+      if (got == 0) {
+        continue;
+      }
+      lastDataMs = millis();
+
+      if (!writePartitionBytes(partition, offset, erasedEnd, buffer.get(), got)) {
+        http.end();
+        setError(String(label) + " flash write failed");
+        return false;
+      }
+
+      digest.update(buffer.get(), got);
+      crc = crc32Update(crc, buffer.get(), got);
+      offset += got;
+      _downloadOffset = offset;
+
+      if ((offset % kFlashSectorSize) == 0 && offset < imageSize &&
+          offset - persistedOffset >= kProgressPersistBytes) {
+        persistDownloadProgress(progressKey, imageSize, offset, crc);
+        persistedOffset = offset;
+      }
+    }
     http.end();
-    setError("Incomplete littlefs write");
-    return false;
   }
 
-  const bool endOk = Update.end(true);
-  http.end();
-  if (!endOk) {
-    setError(String("LittleFS end failed: ") + Update.errorString());
+  if (imageSize == 0 || offset < imageSize) {
+    if (lastHttpCode != HTTP_CODE_OK && lastHttpCode != HTTP_CODE_PARTIAL_CONTENT) {
+      setError(String(label) + " HTTP error: " + lastHttpCode);
+    } else {
+      setError(String(label) + " download incomplete at " + offset + " of " +
+               imageSize + " bytes");
+    }
     return false;
   }
-  if (!Update.isFinished()) {
-    setError("LittleFS OTA did not finish");
+
+  _state = OtaState::Installing;
+  clearDownloadProgress();
+  const String sha256 = digest.finishSha256();
+  const String md5 = digest.finishMd5();
+  if (sha256Hex.length() == 64 && sha256 != sha256Hex) {
+    setError(String(label) + " SHA-256 mismatch");
     return false;
   }
-
-  if (_availableLittleFsVersion.length() > 0) {
-    persistCurrentLittleFsVersion(_availableLittleFsVersion);
-    _currentLittleFsVersion = _availableLittleFsVersion;
+  if (md5Hex.length() == 32 && md5 != md5Hex) {
+    setError(String(label) + " MD5 mismatch");
+    return false;
   }
+  _lastImageSha256Verified = sha256Hex.length() == 64;
 
-  _state = OtaState::RebootRequired;
-  _hasPendingLittleFsUpdate = false;
-  clearError();
+  Serial.print("[OTA] ");
+  Serial.print(label);
+  Serial.print(" image verified sha256=");
+  Serial.println(sha256);
   return true;
 }
 
@@ -412,6 +765,9 @@ void OtaService::appendStatus(JsonObject obj) const {
       _lastManifestUrl.length() ? _lastManifestUrl : _defaultManifestUrl;
   obj["firmware_url"] = _firmwareUrl;
   obj["firmware_size"] = _firmwareSize;
+  obj["delta_url"] = _deltaUrl;
+  obj["delta_size"] = _deltaSize;
+  obj["last_install_delta"] = _lastInstallUsedDelta;
   obj["littlefs_url"] = _littleFsUrl;
   obj["littlefs_size"] = _littleFsSize;
   obj["has_update"] = hasPendingUpdate();
@@ -419,6 +775,10 @@ void OtaService::appendStatus(JsonObject obj) const {
   obj["has_littlefs_update"] = _hasPendingLittleFsUpdate;
   obj["last_error"] = _lastError;
   obj["last_check_ms"] = _lastCheckedMs;
+  obj["download_offset"] = _downloadOffset;
+  obj["download_size"] = _downloadSize;
+  obj["download_resumes"] = _downloadResumeCount;
+  obj["sha256_verified"] = _lastImageSha256Verified;
   obj["wifi_connected"] = _wifiService.isConnected();
 }
 
@@ -470,14 +830,27 @@ bool OtaService::fetchManifest(const String& manifestUrl) {
   const char* fwUrl = firmware["url"] | "";
   _firmwareUrl = normalizeHttpUrl(fwUrl != nullptr ? fwUrl : "");
   _firmwareSize = firmware["size"] | 0;
-  _firmwareMd5 = normalizeMd5Hex(firmware["md5"] | "");
-  _firmwareSha256 = firmware["sha256"] | "";
+  _firmwareMd5 = normalizeHexDigest(firmware["md5"] | "");
+  _firmwareSha256 = normalizeHexDigest(firmware["sha256"] | "");
+
+  _deltaUrl = "";
+  _deltaSize = 0;
+  JsonVariant delta = firmware["delta"];
+  if (delta.is<JsonArray>()) {
+    for (JsonVariant entry : delta.as<JsonArray>()) {
+      if (selectDeltaEntry(entry)) {
+        break;
+      }
+    }
+  } else if (!delta.isNull()) {
+    selectDeltaEntry(delta);
+  }
 
   const char* littleFsUrl = littlefs["url"] | "";
   _littleFsUrl = normalizeHttpUrl(littleFsUrl != nullptr ? littleFsUrl : "");
   _littleFsSize = littlefs["size"] | 0;
-  _littleFsMd5 = normalizeMd5Hex(littlefs["md5"] | "");
-  _littleFsSha256 = littlefs["sha256"] | "";
+  _littleFsMd5 = normalizeHexDigest(littlefs["md5"] | "");
+  _littleFsSha256 = normalizeHexDigest(littlefs["sha256"] | "");
   _availableLittleFsVersion = littlefs["version"] | "";
 
   if (_littleFsUrl.length() > 0 && _availableLittleFsVersion.length() == 0) {
@@ -487,6 +860,20 @@ bool OtaService::fetchManifest(const String& manifestUrl) {
   return true;
 }
 
+// Accepts a `firmware.delta` entry only when it was built from the running
+// version.
+bool OtaService::selectDeltaEntry(JsonVariant entry) {
+  const char* fromVersion = entry["from_version"] | "";
+  const char* url = entry["url"] | "";
+  if (fromVersion == nullptr || url == nullptr || url[0] == '\0' ||
+      _currentVersion != fromVersion) {
+    return false;
+  }
+  _deltaUrl = normalizeHttpUrl(url);
+  _deltaSize = entry["size"] | 0;
+  return _deltaUrl.length() > 0;
+}
+
 String OtaService::normalizeManifestUrl(String url) {
   url = normalizeHttpUrl(url);
   if (url.length() == 0) {
@@ -522,7 +909,7 @@ String OtaService::normalizeHttpUrl(String url) {
   return url;
 }
 
-String OtaService::normalizeMd5Hex(String value) {
+String OtaService::normalizeHexDigest(String value) {
   value.trim();
   String out;
   out.reserve(value.length());
@@ -0,0 +1,127 @@
+#include "PlaybackStore.h"
+
+#include <LittleFS.h>
+#include <esp_attr.h>
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Crc32.h"
+
+namespace {
+constexpr uint32_t kRecordMagic = 0x31424B50;  // "PKB1"
+// Outside /cache, whose stray files RssCache deletes at boot.
+constexpr char kPlaybackPath[] = "/config/playback.bin";
+
+struct PlaybackRecord {
+  uint32_t magic;
+  PlaybackCheckpoint checkpoint;
+  uint32_t crc;
+};
+
+// Survives software resets and panics; garbage after power-on, which the
+// magic/CRC check rejects.
+RTC_NOINIT_ATTR PlaybackRecord gPlaybackRecord;
+
+// record() runs on the loop task, flushDue() on the producer.
+portMUX_TYPE gRecordMux = portMUX_INITIALIZER_UNLOCKED;
+
+uint32_t recordCrc(const PlaybackRecord& record) {
+  return crc32Compute(&record, offsetof(PlaybackRecord, crc));
+}
+
+bool recordValid(const PlaybackRecord& record) {
+  return record.magic == kRecordMagic && record.crc == recordCrc(record);
+}
+}  // namespace
+
+PlaybackStore::PlaybackStore()
+    : _restoredFrom(PlaybackOrigin::None),
+      _recorded(false),
+      _lastFlushMs(0),
+      _flashWrites(0),
+      _flushed{} {}
+
+bool PlaybackStore::restore(PlaybackCheckpoint& outCheckpoint) {
+  _lastFlushMs = millis();
+  PlaybackRecord flashRecord = {};
+  File file = LittleFS.open(kPlaybackPath, "r");
+  if (file) {
+    if (file.readBytes(reinterpret_cast<char*>(&flashRecord), sizeof(flashRecord)) !=
+        sizeof(flashRecord)) {
+      flashRecord.magic = 0;
+    }
+    file.close();
+  }
+  const bool flashValid = recordValid(flashRecord);
+  if (flashValid) {
+    _flushed = flashRecord.checkpoint;
+  }
+
+  PlaybackRecord rtcRecord = {};
+  portENTER_CRITICAL(&gRecordMux);
+  rtcRecord = gPlaybackRecord;
+  portEXIT_CRITICAL(&gRecordMux);
+  if (recordValid(rtcRecord)) {
+    _restoredFrom = PlaybackOrigin::Rtc;
+    outCheckpoint = rtcRecord.checkpoint;
+  } else if (flashValid) {
+    _restoredFrom = PlaybackOrigin::Flash;
+    outCheckpoint = flashRecord.checkpoint;
+  } else {
+    _restoredFrom = PlaybackOrigin::None;
+    return false;
+  }
+  Serial.print("[PLAYBACK] Checkpoint restored from ");
+  Serial.println(_restoredFrom == PlaybackOrigin::Rtc ? "rtc" : "flash");
+  return true;
+}
+
+void PlaybackStore::record(const PlaybackCheckpoint& checkpoint) {
+  PlaybackRecord record = {};
+  record.magic = kRecordMagic;
+  record.checkpoint = checkpoint;
+  record.crc = recordCrc(record);
+  portENTER_CRITICAL(&gRecordMux);
+  gPlaybackRecord = record;
+  _recorded = true;
+  portEXIT_CRITICAL(&gRecordMux);
+}
+
+// LittleFS commits a rewritten file atomically on close, so a power cut
+// mid-write leaves the previous checkpoint in place.
+bool PlaybackStore::flushDue(uint32_t nowMs) {
+  if (nowMs - _lastFlushMs < kFlushIntervalMs) {
+    return false;
+  }
+  PlaybackRecord record = {};
+  portENTER_CRITICAL(&gRecordMux);
+  const bool recorded = _recorded;
+  record = gPlaybackRecord;
+  portEXIT_CRITICAL(&gRecordMux);
+  _lastFlushMs = nowMs;
+  if (!recorded || memcmp(&record.checkpoint, &_flushed, sizeof(_flushed)) == 0) {
+    return false;
+  }
+
+  File file = LittleFS.open(kPlaybackPath, "w");
+  if (!file) {
+    return false;
+  }
+  const bool written = file.write(reinterpret_cast<const uint8_t*>(&record),
+                                  sizeof(record)) == sizeof(record);
+  file.close();
+  if (!written) {
+    Serial.println("[PLAYBACK] Checkpoint write failed");
+    return false;
+  }
+  _flushed = record.checkpoint;
+  _flashWrites++;
+  return true;
+}
+
+void PlaybackStore::stats(PlaybackStats& outStats) const {
+  outStats.restoredFrom = _restoredFrom;
+  outStats.resumed = false;
+  outStats.flashWrites = _flashWrites;
+}
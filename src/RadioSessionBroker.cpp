@@ -0,0 +1,301 @@
+#include "RadioSessionBroker.h"
+
+#include <freertos/task.h>
+#include <string.h>
+
+namespace {
+constexpr uint32_t kConnectTimeoutMs = 8000;
+constexpr uint8_t kConnectRetries = 2;
+constexpr uint32_t kHoldPollMs = 20;
+
+bool dueBy(uint32_t dueMs, uint32_t nowMs) {
+  return static_cast<int32_t>(nowMs - dueMs) >= 0;
+}
+
+bool earlier(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) < 0; }
+
+class MutexLock {
+public:
+  explicit MutexLock(SemaphoreHandle_t mutex) : _mutex(mutex) {
+    if (_mutex != nullptr) {
+      xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+    }
+  }
+  ~MutexLock() {
+    if (_mutex != nullptr) {
+      xSemaphoreGiveRecursive(_mutex);
+    }
+  }
+
+private:
+  SemaphoreHandle_t _mutex;
+};
+}  // namespace
+
+RadioSessionBroker::RadioSessionBroker(SettingsStore& settingsStore,
+                                       WifiService& wifiService)
+    : _settingsStore(settingsStore),
+      _wifiService(wifiService),
+      _jobMutex(nullptr),
+      _windowMutex(nullptr),
+      _radioControlEnabled(true),
+      _jobs{},
+      _windowDepth(0),
+      _holdDone(nullptr),
+      _holdContext(nullptr),
+      _holdUntilMs(0),
+      _current{},
+      _reports{},
+      _reportHead(0),
+      _windows(0),
+      _associations(0),
+      _failedAssociations(0),
+      _jobsRun(0),
+      _awakeMsTotal(0) {}
+
+void RadioSessionBroker::begin() {
+  if (_jobMutex == nullptr) {
+    _jobMutex = xSemaphoreCreateRecursiveMutex();
+  }
+  if (_windowMutex == nullptr) {
+    _windowMutex = xSemaphoreCreateRecursiveMutex();
+  }
+}
+
+void RadioSessionBroker::setRadioControlEnabled(bool enabled) {
+  _radioControlEnabled = enabled;
+}
+
+bool RadioSessionBroker::submit(const char* name, JobFn fn, void* context,
+                                uint32_t deadlineMs) {
+  if (fn == nullptr) {
+    return false;
+  }
+  MutexLock lock(_jobMutex);
+  Job* freeSlot = nullptr;
+  for (size_t i = 0; i < kMaxJobs; i++) {
+    Job& job = _jobs[i];
+    if (!job.pending) {
+      if (freeSlot == nullptr) {
+        freeSlot = &job;
+      }
+      continue;
+    }
+    if (job.fn == fn && job.context == context) {
+      if (earlier(deadlineMs, job.deadlineMs)) {
+        job.deadlineMs = deadlineMs;
+      }
+      return true;
+    }
+  }
+  if (freeSlot == nullptr) {
+    Serial.print("[RADIO] Job queue full, dropped ");
+    Serial.println(name);
+    return false;
+  }
+  freeSlot->name = name;
+  freeSlot->fn = fn;
+  freeSlot->context = context;
+  freeSlot->deadlineMs = deadlineMs;
+  freeSlot->pending = true;
+  return true;
+}
+
+bool RadioSessionBroker::windowDue(uint32_t nowMs) const {
+  // In config mode wait for an in-progress join rather than failing jobs.
+  if (!_radioControlEnabled && _wifiService.connectInProgress()) {
+    return false;
+  }
+  MutexLock lock(_jobMutex);
+  for (size_t i = 0; i < kMaxJobs; i++) {
+    if (_jobs[i].pending && dueBy(_jobs[i].deadlineMs, nowMs)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t RadioSessionBroker::runWindow() {
+  MutexLock windowLock(_windowMutex);
+
+  Job due[kMaxJobs];
+  const size_t dueCount = takeDueJobs(kCoalesceMs, due, kMaxJobs);
+  const bool outer = _windowDepth == 0;
+  if (outer && dueCount == 0) {
+    return 0;
+  }
+  _windowDepth++;
+
+  bool manageRadio = false;
+  bool attempted = false;
+  if (outer) {
+    memset(&_current, 0, sizeof(_current));
+    _current.openedMs = millis();
+    const AppSettings& settings = _settingsStore.settings();
+    manageRadio = _radioControlEnabled && settings.wifiSsid[0] != '\0';
+    if (manageRadio && _wifiService.mode() != WifiRuntimeMode::StaConnected) {
+      attempted = true;
+      _current.associated = _wifiService.connectSta(
+          settings.wifiSsid, settings.wifiPassword, kConnectTimeoutMs, kConnectRetries);
+      _current.connectMs = millis() - _current.openedMs;
+    }
+  }
+
+  const bool connected = _wifiService.mode() == WifiRuntimeMode::StaConnected;
+  _current.connected = _current.connected || connected;
+  size_t okCount = 0;
+  for (size_t i = 0; i < dueCount; i++) {
+    const bool ok = due[i].fn(connected, due[i].context);
+    if (ok) {
+      okCount++;
+    }
+    noteJob(due[i].name, ok);
+  }
+
+  if (outer) {
+    if (manageRadio) {
+      waitForHold();
+      _wifiService.stopWifi();
+      _current.awakeMs = millis() - _current.openedMs;
+    }
+    _holdDone = nullptr;
+    finishWindow(attempted);
+  }
+  _windowDepth--;
+  return okCount;
+}
+
+void RadioSessionBroker::holdWindow(uint32_t maxMs, HoldFn done, void* context) {
+  if (_windowDepth == 0 || done == nullptr) {
+    return;
+  }
+  _holdDone = done;
+  _holdContext = context;
+  _holdUntilMs = millis() + maxMs;
+}
+
+// Only needed when this window is about to drop the radio; with an
+// always-on connection the reply simply lands later.
+void RadioSessionBroker::waitForHold() {
+  if (_holdDone == nullptr || _wifiService.mode() != WifiRuntimeMode::StaConnected) {
+    return;
+  }
+  const uint32_t startMs = millis();
+  while (!_holdDone(_holdContext) && !dueBy(_holdUntilMs, millis())) {
+    vTaskDelay(pdMS_TO_TICKS(kHoldPollMs));
+  }
+  _current.holdMs = millis() - startMs;
+}
+
+// Earliest deadline first, so e.g. the boot OTA check runs before RSS work.
+size_t RadioSessionBroker::takeDueJobs(uint32_t horizonMs, Job* outJobs,
+                                       size_t maxJobs) {
+  MutexLock lock(_jobMutex);
+  const uint32_t limitMs = millis() + horizonMs;
+  size_t count = 0;
+  for (size_t i = 0; i < kMaxJobs && count < maxJobs; i++) {
+    Job& job = _jobs[i];
+    if (!job.pending || !dueBy(job.deadlineMs, limitMs)) {
+      continue;
+    }
+    size_t pos = count++;
+    while (pos > 0 && earlier(job.deadlineMs, outJobs[pos - 1].deadlineMs)) {
+      outJobs[pos] = outJobs[pos - 1];
+      pos--;
+    }
+    outJobs[pos] = job;
+    job.pending = false;
+  }
+  return count;
+}
+
+void RadioSessionBroker::noteJob(const char* name, bool ok) {
+  if (_current.jobCount > 0) {
+    strlcat(_current.jobs, ",", sizeof(_current.jobs));
+  }
+  strlcat(_current.jobs, name != nullptr ? name : "?", sizeof(_current.jobs));
+  _current.jobCount++;
+  if (ok) {
+    _current.jobsOk++;
+  }
+}
+
+void RadioSessionBroker::finishWindow(bool associationAttempted) {
+  {
+    MutexLock lock(_jobMutex);
+    _windows++;
+    if (associationAttempted) {
+      if (_current.associated) {
+        _associations++;
+      } else {
+        _failedAssociations++;
+      }
+    }
+    _jobsRun += _current.jobCount;
+    _awakeMsTotal += _current.awakeMs;
+    _reports[_reportHead] = _current;
+    _reportHead = (_reportHead + 1) % kReportWindows;
+  }
+
+  Serial.print("[RADIO] Window jobs=");
+  Serial.print(_current.jobs);
+  Serial.print(" ok=");
+  Serial.print(_current.jobsOk);
+  Serial.print("/");
+  Serial.print(_current.jobCount);
+  Serial.print(" connect=");
+  Serial.print(_current.connectMs);
+  Serial.print("ms hold=");
+  Serial.print(_current.holdMs);
+  Serial.print("ms awake=");
+  Serial.print(_current.awakeMs);
+  Serial.println(_current.connected ? "ms" : "ms (no STA)");
+}
+
+bool RadioSessionBroker::recentWindow(size_t age, RadioWindowReport& outReport) const {
+  MutexLock lock(_jobMutex);
+  const size_t stored = _windows < kReportWindows ? _windows : kReportWindows;
+  if (age >= stored) {
+    return false;
+  }
+  outReport = _reports[(_reportHead + kReportWindows - 1 - age) % kReportWindows];
+  return true;
+}
+
+void RadioSessionBroker::appendStatus(JsonObject obj) const {
+  MutexLock lock(_jobMutex);
+  const uint32_t uptimeMs = millis();
+  size_t pending = 0;
+  for (size_t i = 0; i < kMaxJobs; i++) {
+    if (_jobs[i].pending) {
+      pending++;
+    }
+  }
+  obj["radio_control"] = _radioControlEnabled;
+  obj["windows"] = _windows;
+  obj["associations"] = _associations;
+  obj["failed_associations"] = _failedAssociations;
+  obj["associations_per_hour"] =
+      uptimeMs > 0 ? static_cast<uint32_t>((static_cast<uint64_t>(_associations) *
+                                            3600000ULL) / uptimeMs)
+                   : 0;
+  obj["jobs_run"] = _jobsRun;
+  obj["awake_ms"] = _awakeMsTotal;
+  obj["pending_jobs"] = pending;
+
+  JsonArray recent = obj.createNestedArray("recent");
+  const size_t stored = _windows < kReportWindows ? _windows : kReportWindows;
+  for (size_t age = 0; age < stored; age++) {
+    const RadioWindowReport& report =
+        _reports[(_reportHead + kReportWindows - 1 - age) % kReportWindows];
+    JsonObject window = recent.createNestedObject();
+    window["opened_ms"] = report.openedMs;
+    window["connect_ms"] = report.connectMs;
+    window["awake_ms"] = report.awakeMs;
+    window["hold_ms"] = report.holdMs;
+    window["jobs"] = report.jobs;
+    window["jobs_ok"] = report.jobsOk;
+    window["job_count"] = report.jobCount;
+    window["connected"] = report.connected;
+  }
+}
@@ -1,16 +1,30 @@
 #include "RssCache.h"
 
 #include <LittleFS.h>
-#include <ctype.h>
+#include <esp_heap_caps.h>
 #include <esp_system.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#include "Crc32.h"
+#include "RssClassifier.h"
+
 namespace {
 constexpr char kCacheDir[] = "/cache";
-constexpr uint32_t kCacheMagic = 0x52434348u;  // "RCCH"
-constexpr uint16_t kCacheVersion = 1u;
+constexpr char kLogPath[] = "/cache/log.bin";
+constexpr char kLogTempPath[] = "/cache/log.tmp";
+constexpr uint32_t kLogMagic = 0x31474C52u;  // "RLG1"
+// Compact once dead records outweigh live ones, but not for a small log.
+constexpr uint32_t kCompactMinBytes = 32 * 1024;
+constexpr size_t kCopyChunkBytes = 256;
+// One packed item: flags, title and description with their terminators.
+constexpr size_t kPackedItemMaxBytes = 1 + (APP_RSS_TITLE_LEN + 1) + (APP_RSS_DESC_LEN + 1);
+// Without PSRAM the RAM tier takes at most a quarter of the heap left after
+// boot reservations; 8 typical sources pack into about 50 KB.
+constexpr size_t kHotHeapShareDivisor = 4;
+constexpr size_t kHotHeapMaxBytes = 48 * 1024;
+constexpr size_t kHotPsramBytes = 128 * 1024;
 
 uint32_t fnv1a(const char* value) {
   uint32_t hash = 2166136261u;
@@ -36,14 +50,6 @@ uint32_t hashMixU32(uint32_t hash, uint32_t value) {
   return hash;
 }
 
-void buildCachePath(const char* sourceUrl, char* outPath, size_t outPathLen) {
-  if (outPath == nullptr || outPathLen == 0) {
-    return;
-  }
-  snprintf(outPath, outPathLen, "%s/%08lx.bin", kCacheDir,
-           static_cast<unsigned long>(fnv1a(sourceUrl)));
-}
-
 inline bool bitGetLocal(const uint8_t* bits, uint32_t idx) {
   return bits != nullptr && (bits[idx / 8] & (1u << (idx % 8))) != 0;
 }
@@ -53,6 +59,64 @@ inline void bitSetLocal(uint8_t* bits, uint32_t idx) {
     bits[idx / 8] |= (1u << (idx % 8));
   }
 }
+
+// Streams one log record, folding every byte into the CRC trailer and copying
+// the payload into a RAM-tier blob when one was allocated.
+class LogWriter {
+public:
+  LogWriter(File& file, uint8_t* mirror)
+      : _file(file), _mirror(mirror), _mirrored(0), _crc(0), _ok(true) {}
+
+  void header(const void* data, size_t length) { put(data, length, false); }
+  void payload(const void* data, size_t length) { put(data, length, true); }
+  bool finish() {
+    const uint32_t crc = _crc;
+    _ok = _ok && _file.write(reinterpret_cast<const uint8_t*>(&crc), sizeof(crc)) ==
+                     sizeof(crc);
+    return _ok;
+  }
+
+private:
+  void put(const void* data, size_t length, bool isPayload) {
+    if (!_ok || length == 0) {
+      return;
+    }
+    _crc = crc32Update(_crc, data, length);
+    _ok = _file.write(static_cast<const uint8_t*>(data), length) == length;
+    if (isPayload && _mirror != nullptr) {
+      memcpy(_mirror + _mirrored, data, length);
+      _mirrored += length;
+    }
+  }
+
+  File& _file;
+  uint8_t* _mirror;
+  size_t _mirrored;
+  uint32_t _crc;
+  bool _ok;
+};
+
+// Reads one packed item (flags, title\0, description\0) from at most `length`
+// bytes; a cut-off item yields whatever text is there.
+void unpackItem(const uint8_t* data, size_t length, RssItem& outItem) {
+  memset(&outItem, 0, sizeof(outItem));
+  if (length == 0) {
+    return;
+  }
+  outItem.flags = data[0];
+  const char* text = reinterpret_cast<const char*>(data + 1);
+  size_t left = length - 1;
+  const size_t titleLen = strnlen(text, left);
+  memcpy(outItem.title, text, titleLen < APP_RSS_TITLE_LEN ? titleLen : APP_RSS_TITLE_LEN);
+  if (titleLen >= left) {
+    return;
+  }
+  text += titleLen + 1;
+  left -= titleLen + 1;
+  const size_t descLen = strnlen(text, left);
+  memcpy(outItem.description, text,
+         descLen < APP_RSS_DESC_LEN ? descLen : APP_RSS_DESC_LEN);
+}
 }  // namespace
 
 RssCache::RssCache()
@@ -61,85 +125,158 @@ RssCache::RssCache()
       _cycleSourceCount(0),
       _cycleTotalItems(0),
       _cycleRemainingItems(0),
-      _cycleSources{} {}
-
-RssCache::~RssCache() { freeCycleState(); }
+      _cycleSources{},
+      _index{},
+      _logBytes(0),
+      _deadBytes(0),
+      _compactions(0),
+      _hot{},
+      _hotBytes(0),
+      _hotTick(0),
+      _hits(0),
+      _misses(0),
+      _evictions(0),
+      _hotBudget(0),
+      _hotPsram(false) {}
+
+RssCache::~RssCache() {
+  freeCycleState();
+  freeHot();
+}
 
 bool RssCache::begin() {
   if (!LittleFS.exists(kCacheDir) && !LittleFS.mkdir(kCacheDir)) {
     return false;
   }
   freeCycleState();
+  freeHot();
+  _hotPsram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM) >= kHotPsramBytes;
+  if (_hotPsram) {
+    _hotBudget = kHotPsramBytes;
+  } else {
+    const size_t share = heap_caps_get_free_size(MALLOC_CAP_8BIT) / kHotHeapShareDivisor;
+    _hotBudget = share < kHotHeapMaxBytes ? share : kHotHeapMaxBytes;
+  }
+  Serial.print("[RSS] Cache RAM tier budget bytes=");
+  Serial.print(static_cast<uint32_t>(_hotBudget));
+  Serial.println(_hotPsram ? " (psram)" : " (heap)");
+
+  if (!LittleFS.exists(kLogPath) && LittleFS.exists(kLogTempPath)) {
+    // Builds that removed the log before the rename could lose power in
+    // between; the temp copy was complete by then, and the scan checks it.
+    Serial.println("[RSS] Cache log missing; recovering compacted copy");
+    LittleFS.rename(kLogTempPath, kLogPath);
+  }
+  removeLegacyFiles();
+  const uint32_t scanStartMs = millis();
+  const bool clean = scanLog();
+  uint32_t sources = 0;
+  for (size_t i = 0; i < kLogIndexEntries; i++) {
+    if (_index[i].used) {
+      sources++;
+    }
+  }
+  Serial.print("[RSS] Cache log sources=");
+  Serial.print(sources);
+  Serial.print(" bytes=");
+  Serial.print(_logBytes);
+  Serial.print(" dead=");
+  Serial.print(_deadBytes);
+  Serial.print(" scan_ms=");
+  Serial.println(millis() - scanStartMs);
+  if (!clean) {
+    Serial.println("[RSS] Cache log has a bad tail; compacting");
+    compactLog();
+  }
   return true;
 }
 
 bool RssCache::store(const char* sourceUrl, const char* /*sourceName*/,
                      const RssItem* items, size_t itemCount) {
   if (sourceUrl == nullptr || sourceUrl[0] == '\0' || items == nullptr ||
-      itemCount == 0) {
+      itemCount == 0 || itemCount > APP_MAX_RSS_ITEMS) {
     return false;
   }
 
-  char finalPath[64] = {0};
-  buildCachePath(sourceUrl, finalPath, sizeof(finalPath));
-  char tempPath[80] = {0};
-  snprintf(tempPath, sizeof(tempPath), "%s.tmp", finalPath);
-
-  File out = LittleFS.open(tempPath, "w");
-  if (!out) {
+  uint16_t offsets[APP_MAX_RSS_ITEMS];
+  size_t payloadBytes = itemCount * sizeof(uint16_t);
+  for (size_t i = 0; i < itemCount; i++) {
+    offsets[i] = static_cast<uint16_t>(payloadBytes);
+    payloadBytes += 3 + strnlen(items[i].title, APP_RSS_TITLE_LEN) +
+                    strnlen(items[i].description, APP_RSS_DESC_LEN);
+  }
+  if (payloadBytes > UINT16_MAX) {
     return false;
   }
 
   const time_t now = time(nullptr);
   const uint32_t epoch = (now > 0) ? static_cast<uint32_t>(now) : millis() / 1000;
 
-  CacheHeader header = {};
-  header.magic = kCacheMagic;
-  header.version = kCacheVersion;
-  header.itemCount = static_cast<uint32_t>(itemCount);
+  LogRecordHeader header = {};
+  header.magic = kLogMagic;
+  header.urlHash = fnv1a(sourceUrl);
   header.updatedEpoch = epoch;
+  header.itemCount = static_cast<uint16_t>(itemCount);
+  header.payloadBytes = static_cast<uint16_t>(payloadBytes);
 
-  if (out.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) !=
-      sizeof(header)) {
+  File out = LittleFS.open(kLogPath, "a");
+  if (out && out.size() != _logBytes) {
+    // Leftovers of a failed append would sit between records and end the
+    // next boot scan early.
     out.close();
-    LittleFS.remove(tempPath);
+    compactLog();
+    out = LittleFS.open(kLogPath, "a");
+  }
+  if (!out) {
     return false;
   }
+  const uint32_t offset = _logBytes;
 
-  for (size_t i = 0; i < itemCount; i++) {
-    CacheRecord record = {};
-    strlcpy(record.title, items[i].title, sizeof(record.title));
-    strlcpy(record.description, items[i].description, sizeof(record.description));
-    record.flags = items[i].flags | inferItemFlags(items[i]);
-
-    if (out.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record)) !=
-        sizeof(record)) {
-      out.close();
-      LittleFS.remove(tempPath);
-      return false;
-    }
+  // The previous copy is stale either way; its bytes go to the new one.
+  HotSource* stale = findHot(header.urlHash);
+  if (stale != nullptr) {
+    dropHot(*stale);
   }
+  uint8_t* blob =
+      reserveHot(payloadBytes, header.urlHash, true) ? allocHot(payloadBytes) : nullptr;
 
+  LogWriter writer(out, blob);
+  writer.header(&header, sizeof(header));
+  writer.payload(offsets, itemCount * sizeof(uint16_t));
+  for (size_t i = 0; i < itemCount; i++) {
+    const RssItem& item = items[i];
+    const uint8_t flags =
+        rssItemIsClassified(item.flags) ? item.flags : classifyRssItem(item);
+    writer.payload(&flags, sizeof(flags));
+    writer.payload(item.title, strnlen(item.title, APP_RSS_TITLE_LEN));
+    writer.payload("", 1);
+    writer.payload(item.description, strnlen(item.description, APP_RSS_DESC_LEN));
+    writer.payload("", 1);
+  }
+  const bool written = writer.finish();
   out.close();
 
-  if (LittleFS.exists(finalPath)) {
-    LittleFS.remove(finalPath);
-  }
-  if (!LittleFS.rename(tempPath, finalPath)) {
-    LittleFS.remove(tempPath);
+  if (!written) {
+    heap_caps_free(blob);
+    compactLog();
     return false;
   }
 
+  _logBytes += recordBytes(header.payloadBytes);
+  indexRecord(header, offset);
+  if (blob != nullptr) {
+    insertHot(header.urlHash, header.itemCount, header.updatedEpoch, blob, payloadBytes);
+  }
+  if (_logBytes >= kCompactMinBytes && _deadBytes > _logBytes / 2) {
+    compactLog();
+  }
   invalidateCycleState();
   return true;
 }
 
 bool RssCache::hasItems(const char* sourceUrl) const {
-  CacheHeader header = {};
-  if (!readHeader(sourceUrl, header)) {
-    return false;
-  }
-  return header.itemCount > 0;
+  const LogEntry* entry = findEntry(sourceUrl);
+  return entry != nullptr && entry->itemCount > 0;
 }
 
 bool RssCache::metadata(const char* sourceUrl,
@@ -148,42 +285,30 @@ bool RssCache::metadata(const char* sourceUrl,
   outMetadata.itemCount = 0;
   outMetadata.updatedEpoch = 0;
 
-  CacheHeader header = {};
-  if (!readHeader(sourceUrl, header)) {
+  const LogEntry* entry = findEntry(sourceUrl);
+  if (entry == nullptr) {
     return false;
   }
 
   outMetadata.valid = true;
-  outMetadata.itemCount = header.itemCount;
-  outMetadata.updatedEpoch = header.updatedEpoch;
+  outMetadata.itemCount = entry->itemCount;
+  outMetadata.updatedEpoch = entry->updatedEpoch;
   return true;
 }
 
 bool RssCache::itemCount(const char* sourceUrl, uint32_t& outCount) const {
   outCount = 0;
-  CacheHeader header = {};
-  if (!readHeader(sourceUrl, header)) {
+  const LogEntry* entry = findEntry(sourceUrl);
+  if (entry == nullptr) {
     return false;
   }
-  outCount = header.itemCount;
+  outCount = entry->itemCount;
   return true;
 }
 
 bool RssCache::loadItem(const char* sourceUrl, uint32_t itemIndex,
                         RssItem& outItem) const {
-  CacheRecord record = {};
-  if (!readRecord(sourceUrl, itemIndex, record)) {
-    return false;
-  }
-
-  memset(&outItem, 0, sizeof(outItem));
-  strlcpy(outItem.title, record.title, sizeof(outItem.title));
-  strlcpy(outItem.description, record.description, sizeof(outItem.description));
-  outItem.flags = record.flags;
-  if (outItem.flags == RssItemFlagNone) {
-    outItem.flags = inferItemFlags(outItem);
-  }
-  return true;
+  return loadRecord(sourceUrl, itemIndex, outItem);
 }
 
 bool RssCache::pickRandomItemNoRepeat(const RssSource* sources, size_t sourceCount,
@@ -251,8 +376,7 @@ bool RssCache::pickRandomItemNoRepeat(const RssSource* sources, size_t sourceCou
     return false;
   }
 
-  CacheRecord record = {};
-  if (!readRecord(sources[selectedSource].url, selectedItemIdx, record)) {
+  if (!loadRecord(sources[selectedSource].url, selectedItemIdx, outItem)) {
     return false;
   }
 
@@ -260,14 +384,6 @@ bool RssCache::pickRandomItemNoRepeat(const RssSource* sources, size_t sourceCou
   sourceState.shownCount++;
   _cycleRemainingItems--;
 
-  memset(&outItem, 0, sizeof(outItem));
-  strlcpy(outItem.title, record.title, sizeof(outItem.title));
-  strlcpy(outItem.description, record.description, sizeof(outItem.description));
-  outItem.flags = record.flags;
-  if (outItem.flags == RssItemFlagNone) {
-    outItem.flags = inferItemFlags(outItem);
-  }
-
   outSourceIndex = static_cast<size_t>(selectedSource);
   if (outFlags != nullptr) {
     *outFlags = outItem.flags;
@@ -276,6 +392,66 @@ bool RssCache::pickRandomItemNoRepeat(const RssSource* sources, size_t sourceCou
   return true;
 }
 
+void RssCache::cycleSnapshot(RssCycleSnapshot& outSnapshot) const {
+  memset(&outSnapshot, 0, sizeof(outSnapshot));
+  if (!_cycleValid) {
+    return;
+  }
+  outSnapshot.valid = true;
+  outSnapshot.signature = _cycleSignature;
+  for (size_t i = 0; i < _cycleSourceCount; i++) {
+    const CycleSourceState& state = _cycleSources[i];
+    if (state.shownBits != nullptr) {
+      memcpy(outSnapshot.shownBits[i], state.shownBits, (state.itemCount + 7u) / 8u);
+    }
+  }
+}
+
+bool RssCache::restoreCycle(const RssSource* sources, size_t sourceCount,
+                            const RssCycleSnapshot& snapshot) {
+  if (!snapshot.valid || sources == nullptr || sourceCount == 0 ||
+      sourceCount > APP_MAX_RSS_SOURCES || !ensureCycleState(sources, sourceCount) ||
+      _cycleSignature != snapshot.signature) {
+    return false;
+  }
+  _cycleRemainingItems = _cycleTotalItems;
+  for (size_t i = 0; i < _cycleSourceCount; i++) {
+    CycleSourceState& state = _cycleSources[i];
+    state.shownCount = 0;
+    if (state.shownBits == nullptr) {
+      continue;
+    }
+    for (uint32_t item = 0; item < state.itemCount; item++) {
+      if (bitGetLocal(snapshot.shownBits[i], item)) {
+        bitSetLocal(state.shownBits, item);
+        state.shownCount++;
+      } else {
+        state.shownBits[item / 8] &= static_cast<uint8_t>(~(1u << (item % 8)));
+      }
+    }
+    _cycleRemainingItems -= state.shownCount;
+  }
+  return true;
+}
+
+void RssCache::stats(RssCacheStats& outStats) const {
+  outStats.hits = _hits;
+  outStats.misses = _misses;
+  outStats.evictions = _evictions;
+  outStats.hotBytes = static_cast<uint32_t>(_hotBytes);
+  outStats.budgetBytes = static_cast<uint32_t>(_hotBudget);
+  outStats.hotSources = 0;
+  for (size_t i = 0; i < APP_MAX_RSS_SOURCES; i++) {
+    if (_hot[i].blob != nullptr) {
+      outStats.hotSources++;
+    }
+  }
+  outStats.psram = _hotPsram;
+  outStats.logBytes = _logBytes;
+  outStats.deadBytes = _deadBytes;
+  outStats.compactions = _compactions;
+}
+
 void RssCache::invalidateCycleState() { _cycleValid = false; }
 
 void RssCache::freeCycleState() {
@@ -293,20 +469,18 @@ void RssCache::freeCycleState() {
 }
 
 bool RssCache::ensureCycleState(const RssSource* sources, size_t sourceCount) {
-  CacheHeader headers[APP_MAX_RSS_SOURCES] = {};
-  bool hasHeader[APP_MAX_RSS_SOURCES] = {};
-
+  const LogEntry* entries[APP_MAX_RSS_SOURCES] = {};
   for (size_t i = 0; i < sourceCount; i++) {
-    hasHeader[i] = readHeader(sources[i].url, headers[i]);
+    entries[i] = findEntry(sources[i].url);
   }
 
   uint32_t signature = 2166136261u;
   signature = hashMixU32(signature, static_cast<uint32_t>(sourceCount));
   for (size_t i = 0; i < sourceCount; i++) {
     signature = hashMixU32(signature, fnv1a(sources[i].url));
-    signature = hashMixU32(signature, hasHeader[i] ? headers[i].itemCount : 0u);
+    signature = hashMixU32(signature, entries[i] != nullptr ? entries[i]->itemCount : 0u);
     signature = hashMixU32(signature,
-                           hasHeader[i] ? headers[i].updatedEpoch : 0u);
+                           entries[i] != nullptr ? entries[i]->updatedEpoch : 0u);
   }
 
   if (_cycleValid && _cycleSignature == signature &&
@@ -320,12 +494,12 @@ bool RssCache::ensureCycleState(const RssSource* sources, size_t sourceCount) {
   _cycleTotalItems = 0;
 
   for (size_t i = 0; i < sourceCount; i++) {
-    if (!hasHeader[i] || headers[i].itemCount == 0) {
+    if (entries[i] == nullptr || entries[i]->itemCount == 0) {
       continue;
     }
 
     CycleSourceState& state = _cycleSources[i];
-    state.itemCount = headers[i].itemCount;
+    state.itemCount = entries[i]->itemCount;
     state.shownCount = 0;
 
     const size_t bitBytes = (state.itemCount + 7u) / 8u;
@@ -356,109 +530,361 @@ void RssCache::restartCycleState() {
   _cycleRemainingItems = _cycleTotalItems;
 }
 
-bool RssCache::readHeader(const char* sourceUrl, CacheHeader& outHeader) const {
-  if (sourceUrl == nullptr || sourceUrl[0] == '\0') {
-    return false;
-  }
-
-  char path[64] = {0};
-  buildCachePath(sourceUrl, path, sizeof(path));
-  if (!LittleFS.exists(path)) {
-    return false;
+// Rebuilds the index with one pass over the log, stopping at the first record
+// whose header, length or CRC does not check out. Returns false when that
+// left bytes unread.
+bool RssCache::scanLog() {
+  memset(_index, 0, sizeof(_index));
+  _logBytes = 0;
+  _deadBytes = 0;
+  if (!LittleFS.exists(kLogPath)) {
+    return true;
   }
-
-  File file = LittleFS.open(path, "r");
+  File file = LittleFS.open(kLogPath, "r");
   if (!file) {
     return false;
   }
 
-  const size_t readLen =
-      file.readBytes(reinterpret_cast<char*>(&outHeader), sizeof(outHeader));
+  const uint32_t size = file.size();
+  uint8_t chunk[kCopyChunkBytes];
+  while (_logBytes + sizeof(LogRecordHeader) <= size) {
+    LogRecordHeader header = {};
+    if (file.readBytes(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+        header.magic != kLogMagic || header.itemCount == 0 ||
+        header.itemCount > APP_MAX_RSS_ITEMS ||
+        header.payloadBytes < header.itemCount * (sizeof(uint16_t) + 3) ||
+        _logBytes + recordBytes(header.payloadBytes) > size) {
+      break;
+    }
+    uint32_t crc = crc32Update(0, &header, sizeof(header));
+    size_t left = header.payloadBytes;
+    while (left > 0) {
+      const size_t want = left < sizeof(chunk) ? left : sizeof(chunk);
+      if (file.readBytes(reinterpret_cast<char*>(chunk), want) != want) {
+        break;
+      }
+      crc = crc32Update(crc, chunk, want);
+      left -= want;
+    }
+    uint32_t storedCrc = 0;
+    if (left != 0 ||
+        file.readBytes(reinterpret_cast<char*>(&storedCrc), sizeof(storedCrc)) !=
+            sizeof(storedCrc) ||
+        storedCrc != crc) {
+      break;
+    }
+    indexRecord(header, _logBytes);
+    _logBytes += recordBytes(header.payloadBytes);
+  }
   file.close();
+  return _logBytes == size;
+}
 
-  if (readLen != sizeof(outHeader)) {
-    return false;
+// Copies each source's latest record into a fresh log and renames it over the
+// old one. LittleFS replaces the target atomically, so a power cut leaves
+// either log whole; the old one stays authoritative until then.
+bool RssCache::compactLog() {
+  LogEntry moved[kLogIndexEntries];
+  memcpy(moved, _index, sizeof(moved));
+  uint32_t written = 0;
+  File in = LittleFS.open(kLogPath, "r");
+  File out = LittleFS.open(kLogTempPath, "w");
+  bool ok = in && out;
+  uint8_t chunk[kCopyChunkBytes];
+  for (size_t i = 0; ok && i < kLogIndexEntries; i++) {
+    if (!moved[i].used) {
+      continue;
+    }
+    ok = in.seek(moved[i].offset, SeekSet);
+    moved[i].offset = written;
+    size_t left = recordBytes(moved[i].payloadBytes);
+    while (ok && left > 0) {
+      const size_t want = left < sizeof(chunk) ? left : sizeof(chunk);
+      ok = in.readBytes(reinterpret_cast<char*>(chunk), want) == want &&
+           out.write(chunk, want) == want;
+      left -= want;
+      written += want;
+    }
   }
-  if (outHeader.magic != kCacheMagic || outHeader.version != kCacheVersion) {
+  if (in) {
+    in.close();
+  }
+  if (out) {
+    out.close();
+  }
+
+  if (ok) {
+    ok = LittleFS.rename(kLogTempPath, kLogPath);
+  }
+  if (!ok) {
+    LittleFS.remove(kLogTempPath);
+    Serial.println("[RSS] Cache log compaction failed");
     return false;
   }
+
+  Serial.print("[RSS] Cache log compacted bytes=");
+  Serial.print(_logBytes);
+  Serial.print("->");
+  Serial.println(written);
+  memcpy(_index, moved, sizeof(_index));
+  _logBytes = written;
+  _deadBytes = 0;
+  _compactions++;
   return true;
 }
 
-bool RssCache::readRecord(const char* sourceUrl, uint32_t itemIndex,
-                          CacheRecord& outRecord) const {
-  CacheHeader header = {};
-  if (!readHeader(sourceUrl, header) || itemIndex >= header.itemCount) {
-    return false;
+// Per-source files from before the log are dropped rather than converted,
+// as is a log.tmp left by a compaction that never reached its rename;
+// the next fetch cycle refills the cache.
+void RssCache::removeLegacyFiles() {
+  File dir = LittleFS.open(kCacheDir);
+  if (!dir || !dir.isDirectory()) {
+    return;
+  }
+  char stale[kLogIndexEntries][48];
+  size_t staleCount = 0;
+  File entry = dir.openNextFile();
+  while (entry) {
+    if (!entry.isDirectory() && strcmp(entry.path(), kLogPath) != 0 &&
+        staleCount < kLogIndexEntries) {
+      strlcpy(stale[staleCount++], entry.path(), sizeof(stale[0]));
+    }
+    entry.close();
+    entry = dir.openNextFile();
   }
+  dir.close();
 
-  char path[64] = {0};
-  buildCachePath(sourceUrl, path, sizeof(path));
-  if (!LittleFS.exists(path)) {
-    return false;
+  for (size_t i = 0; i < staleCount; i++) {
+    LittleFS.remove(stale[i]);
   }
-  File file = LittleFS.open(path, "r");
-  if (!file) {
-    return false;
+  if (staleCount > 0) {
+    Serial.print("[RSS] Removed old cache files=");
+    Serial.println(static_cast<uint32_t>(staleCount));
   }
+}
 
-  const uint32_t offset =
-      sizeof(CacheHeader) + (itemIndex * sizeof(CacheRecord));
-  if (!file.seek(offset, SeekSet)) {
-    file.close();
-    return false;
+// Points the source's entry at its newest record, which turns the previous
+// one into dead bytes. A full index gives up the source updated longest ago.
+void RssCache::indexRecord(const LogRecordHeader& header, uint32_t offset) {
+  LogEntry* slot = nullptr;
+  LogEntry* freeSlot = nullptr;
+  LogEntry* oldest = nullptr;
+  for (size_t i = 0; i < kLogIndexEntries; i++) {
+    LogEntry& entry = _index[i];
+    if (!entry.used) {
+      if (freeSlot == nullptr) {
+        freeSlot = &entry;
+      }
+    } else if (entry.urlHash == header.urlHash) {
+      slot = &entry;
+      break;
+    } else if (oldest == nullptr || entry.updatedEpoch < oldest->updatedEpoch) {
+      oldest = &entry;
+    }
+  }
+  if (slot == nullptr) {
+    slot = freeSlot;
+  }
+  if (slot == nullptr) {
+    slot = oldest;
+    HotSource* hot = findHot(slot->urlHash);
+    if (hot != nullptr) {
+      dropHot(*hot);
+    }
+  }
+  if (slot->used) {
+    _deadBytes += recordBytes(slot->payloadBytes);
   }
+  slot->used = true;
+  slot->itemCount = header.itemCount;
+  slot->payloadBytes = header.payloadBytes;
+  slot->urlHash = header.urlHash;
+  slot->offset = offset;
+  slot->updatedEpoch = header.updatedEpoch;
+}
 
-  const size_t readLen =
-      file.readBytes(reinterpret_cast<char*>(&outRecord), sizeof(outRecord));
-  file.close();
-  return readLen == sizeof(outRecord);
+const RssCache::LogEntry* RssCache::findEntry(const char* sourceUrl) const {
+  if (sourceUrl == nullptr || sourceUrl[0] == '\0') {
+    return nullptr;
+  }
+  const uint32_t urlHash = fnv1a(sourceUrl);
+  for (size_t i = 0; i < kLogIndexEntries; i++) {
+    if (_index[i].used && _index[i].urlHash == urlHash) {
+      return &_index[i];
+    }
+  }
+  return nullptr;
 }
 
-uint8_t RssCache::inferItemFlags(const RssItem& item) {
-  const char* finishedMarkers[] = {" final",   "final ",  "final/",
-                                   "postponed", "cancelled", "canceled",
-                                   "suspended"};
+uint32_t RssCache::recordBytes(uint16_t payloadBytes) {
+  return sizeof(LogRecordHeader) + payloadBytes + sizeof(uint32_t);
+}
 
-  for (const char* marker : finishedMarkers) {
-    if (containsCaseInsensitive(item.title, marker) ||
-        containsCaseInsensitive(item.description, marker)) {
-      return RssItemFlagNone;
+// One item straight from the log: its offset-table slot, then the item.
+bool RssCache::readLogItem(const LogEntry& entry, uint32_t itemIndex,
+                           RssItem& outItem) const {
+  File file = LittleFS.open(kLogPath, "r");
+  if (!file) {
+    return false;
+  }
+  const uint32_t payloadStart = entry.offset + sizeof(LogRecordHeader);
+  uint16_t itemOffset = 0;
+  uint8_t packed[kPackedItemMaxBytes];
+  size_t packedBytes = 0;
+  bool ok = file.seek(payloadStart + itemIndex * sizeof(uint16_t), SeekSet) &&
+            file.readBytes(reinterpret_cast<char*>(&itemOffset), sizeof(itemOffset)) ==
+                sizeof(itemOffset) &&
+            itemOffset < entry.payloadBytes && file.seek(payloadStart + itemOffset, SeekSet);
+  if (ok) {
+    packedBytes = entry.payloadBytes - itemOffset;
+    if (packedBytes > sizeof(packed)) {
+      packedBytes = sizeof(packed);
     }
+    ok = file.readBytes(reinterpret_cast<char*>(packed), packedBytes) == packedBytes;
+  }
+  file.close();
+  if (!ok) {
+    return false;
   }
+  unpackItem(packed, packedBytes, outItem);
+  return true;
+}
 
-  const char* liveMarkers[] = {"in progress", "halftime", "top ",      "bottom ",
-                               "bot ",        "end of ",  "start of ", "q1",
-                               "q2",          "q3",       "q4",        "1st period",
-                               "2nd period",  "3rd period", "overtime", " ot "};
+// RAM tier first; a miss loads the whole source when it fits, otherwise the
+// one item is read from the log.
+bool RssCache::loadRecord(const char* sourceUrl, uint32_t itemIndex,
+                          RssItem& outItem) const {
+  const LogEntry* entry = findEntry(sourceUrl);
+  if (entry == nullptr || itemIndex >= entry->itemCount) {
+    return false;
+  }
+  const HotSource* hot = findHotCounted(entry->urlHash);
+  if (hot == nullptr) {
+    hot = admitHot(*entry);
+  }
+  if (hot == nullptr) {
+    return readLogItem(*entry, itemIndex, outItem);
+  }
+  const size_t itemOffset = reinterpret_cast<const uint16_t*>(hot->blob)[itemIndex];
+  if (itemOffset >= hot->blobBytes) {
+    return false;
+  }
+  unpackItem(hot->blob + itemOffset, hot->blobBytes - itemOffset, outItem);
+  return true;
+}
 
-  for (const char* marker : liveMarkers) {
-    if (containsCaseInsensitive(item.title, marker) ||
-        containsCaseInsensitive(item.description, marker)) {
-      return RssItemFlagLive;
+RssCache::HotSource* RssCache::findHot(uint32_t urlHash) const {
+  for (size_t i = 0; i < APP_MAX_RSS_SOURCES; i++) {
+    if (_hot[i].blob != nullptr && _hot[i].urlHash == urlHash) {
+      return &_hot[i];
     }
   }
+  return nullptr;
+}
 
-  return RssItemFlagNone;
+RssCache::HotSource* RssCache::findHotCounted(uint32_t urlHash) const {
+  HotSource* hot = findHot(urlHash);
+  if (hot == nullptr) {
+    _misses++;
+    return nullptr;
+  }
+  _hits++;
+  hot->lastUsed = ++_hotTick;
+  return hot;
 }
 
-bool RssCache::containsCaseInsensitive(const char* haystack,
-                                       const char* needle) {
-  if (haystack == nullptr || needle == nullptr || needle[0] == '\0') {
-    return false;
+// Admits a source after a miss only when it fits without evicting another:
+// with a tier too small for every source, picks rotating across sources
+// would otherwise reload whole records over and over.
+RssCache::HotSource* RssCache::admitHot(const LogEntry& entry) const {
+  if (!reserveHot(entry.payloadBytes, entry.urlHash, false)) {
+    return nullptr;
+  }
+  uint8_t* blob = allocHot(entry.payloadBytes);
+  if (blob == nullptr) {
+    return nullptr;
+  }
+  File file = LittleFS.open(kLogPath, "r");
+  const bool ok = file && file.seek(entry.offset + sizeof(LogRecordHeader), SeekSet) &&
+                  file.readBytes(reinterpret_cast<char*>(blob), entry.payloadBytes) ==
+                      entry.payloadBytes;
+  if (file) {
+    file.close();
   }
+  if (!ok) {
+    heap_caps_free(blob);
+    return nullptr;
+  }
+  return insertHot(entry.urlHash, entry.itemCount, entry.updatedEpoch, blob,
+                   entry.payloadBytes);
+}
+
+// The caller has reserved room for `blob`, which the tier now owns.
+RssCache::HotSource* RssCache::insertHot(uint32_t urlHash, uint32_t itemCount,
+                                         uint32_t updatedEpoch, uint8_t* blob,
+                                         size_t blobBytes) const {
+  for (size_t i = 0; i < APP_MAX_RSS_SOURCES; i++) {
+    HotSource& hot = _hot[i];
+    if (hot.blob != nullptr) {
+      continue;
+    }
+    hot.urlHash = urlHash;
+    hot.itemCount = itemCount;
+    hot.updatedEpoch = updatedEpoch;
+    hot.lastUsed = ++_hotTick;
+    hot.blob = blob;
+    hot.blobBytes = blobBytes;
+    _hotBytes += blobBytes;
+    return &hot;
+  }
+  heap_caps_free(blob);
+  return nullptr;
+}
 
-  const size_t needleLen = strlen(needle);
-  for (const char* h = haystack; *h != '\0'; h++) {
-    size_t i = 0;
-    while (i < needleLen && h[i] != '\0' &&
-           tolower(static_cast<unsigned char>(h[i])) ==
-               tolower(static_cast<unsigned char>(needle[i]))) {
-      i++;
+bool RssCache::reserveHot(size_t bytes, uint32_t keepHash, bool mayEvict) const {
+  if (bytes > _hotBudget) {
+    return false;
+  }
+  while (true) {
+    bool freeSlot = false;
+    HotSource* oldest = nullptr;
+    for (size_t i = 0; i < APP_MAX_RSS_SOURCES; i++) {
+      HotSource& hot = _hot[i];
+      if (hot.blob == nullptr) {
+        freeSlot = true;
+      } else if (hot.urlHash != keepHash &&
+                 (oldest == nullptr ||
+                  static_cast<int32_t>(hot.lastUsed - oldest->lastUsed) < 0)) {
+        oldest = &hot;
+      }
     }
-    if (i == needleLen) {
+    if (freeSlot && _hotBytes + bytes <= _hotBudget) {
       return true;
     }
+    if (!mayEvict || oldest == nullptr) {
+      return false;
+    }
+    dropHot(*oldest);
+    _evictions++;
+  }
+}
+
+void RssCache::dropHot(HotSource& hot) const {
+  _hotBytes -= hot.blobBytes;
+  heap_caps_free(hot.blob);
+  memset(&hot, 0, sizeof(hot));
+}
+
+void RssCache::freeHot() {
+  for (size_t i = 0; i < APP_MAX_RSS_SOURCES; i++) {
+    if (_hot[i].blob != nullptr) {
+      dropHot(_hot[i]);
+    }
   }
-  return false;
+  _hotBytes = 0;
+}
+
+uint8_t* RssCache::allocHot(size_t bytes) const {
+  return static_cast<uint8_t*>(
+      heap_caps_malloc(bytes, _hotPsram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT));
 }
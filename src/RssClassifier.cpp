@@ -0,0 +1,79 @@
+#include "RssClassifier.h"
+
+#include "RssStatusAutomaton.h"
+
+namespace {
+// Bit order matches HITS in scripts/gen_status_automaton.py.
+enum RssStatusHit : uint8_t {
+  kHitLive = 0x01,
+  kHitFinal = 0x02,
+  kHitScheduled = 0x04,
+  kHitPostponed = 0x08,
+  kHitAt = 0x10,
+  kHitMeridiem = 0x20,
+  kHitColon = 0x40,
+  kHitTimezone = 0x80,
+};
+
+// Walks text through the automaton starting from `state`; the caller feeds a
+// trailing word break so whole-word markers at the end of the text match.
+uint8_t scanStatus(const char* text, rss_status::State& state) {
+  uint8_t hits = 0;
+  if (text == nullptr) {
+    return hits;
+  }
+  for (const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+       *p != '\0'; p++) {
+    state = rss_status::kNext[state][rss_status::kSymbol[*p]];
+    hits |= rss_status::kHits[state];
+  }
+  return hits;
+}
+
+uint8_t endScan(rss_status::State& state) {
+  state = rss_status::kNext[state][0];
+  const uint8_t hits = rss_status::kHits[state];
+  state = rss_status::kNext[0][0];
+  return hits;
+}
+
+// Strongest state wins: a postponed or final game is never live, and start
+// times only count when nothing says the game has begun.
+uint8_t resolveHits(uint8_t hits) {
+  if ((hits & kHitPostponed) != 0) {
+    return RssItemFlagPostponed;
+  }
+  if ((hits & kHitFinal) != 0) {
+    return RssItemFlagFinal;
+  }
+  if ((hits & kHitLive) != 0) {
+    return RssItemFlagLive;
+  }
+  const bool clock = (hits & kHitMeridiem) != 0 && (hits & kHitColon) != 0;
+  const bool atZone = (hits & kHitAt) != 0 && (hits & kHitTimezone) != 0;
+  if ((hits & kHitScheduled) != 0 || clock || atZone) {
+    return RssItemFlagScheduled;
+  }
+  return RssItemFlagNone;
+}
+}  // namespace
+
+uint8_t classifyRssStatus(const char* text) {
+  rss_status::State state = rss_status::kNext[0][0];
+  uint8_t hits = scanStatus(text, state);
+  hits |= endScan(state);
+  return resolveHits(hits);
+}
+
+uint8_t classifyRssItem(const RssItem& item) {
+  rss_status::State state = rss_status::kNext[0][0];
+  uint8_t hits = scanStatus(item.title, state);
+  hits |= endScan(state);
+  hits |= scanStatus(item.description, state);
+  hits |= endScan(state);
+  if ((item.flags & RssItemFlagLive) != 0) {
+    hits |= kHitLive;
+  }
+  return (item.flags & ~RssItemFlagStateMask) | resolveHits(hits) |
+         RssItemFlagClassified;
+}
@@ -2,14 +2,34 @@
 
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
+#include <WiFiClient.h>
 #include <WiFiClientSecure.h>
 #include <ctype.h>
+#include <esp_heap_caps.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "Inflater.h"
+#include "RssClassifier.h"
 #include "RssSanitizer.h"
+#include "ScratchArena.h"
 
 namespace {
 constexpr size_t kRssMaxResponseBytes = 64 * 1024;
+// Only ask for gzip when the inflater (32 KB window + tinfl state) will fit.
+constexpr size_t kInflateMinLargestBlock = 48 * 1024;
+const char* kCollectedHeaders[] = {"Content-Encoding"};
+
+// MCDG feed digest (scripts/feed_digest.py): pre-sanitized, pre-classified
+// items, length-prefixed so they copy straight into RssItem fields.
+constexpr char kDigestMagic[4] = {'M', 'C', 'D', 'G'};
+constexpr uint8_t kDigestVersion = 1;
+constexpr size_t kDigestHeaderBytes = 12;  // magic, version, count, reserved, epoch
+constexpr size_t kDigestItemHeaderBytes = 3;  // flags, title length, description length
+
+// Batch responses: "@@section <key>" on its own line starts each league.
+constexpr char kSectionMarker[] = "@@section ";
+constexpr size_t kSectionKeyLen = 15;
 constexpr uint8_t kJsonWalkMaxDepth = 5;
 
 void safeCopy(char* dst, size_t dstLen, const char* src) {
@@ -23,26 +43,228 @@ void safeCopy(char* dst, size_t dstLen, const char* src) {
   strlcpy(dst, src, dstLen);
 }
 
-bool extractTagContent(const String& block, const char* tagName, String& out) {
-  String open = String("<") + tagName + ">";
-  String close = String("</") + tagName + ">";
+// HTTP body sink over a fixed buffer (arena tail). Bytes past the cap are
+// accepted and dropped so HTTPClient keeps draining the connection.
+class ScratchSink : public Stream {
+public:
+  ScratchSink(char* buffer, size_t capacity)
+      : _buffer(buffer), _capacity(capacity), _length(0), _received(0), _truncated(false) {}
+
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t* data, size_t size) override {
+    _received += size;
+    size_t copy = _capacity - _length;
+    if (copy > size) {
+      copy = size;
+    }
+    memcpy(_buffer + _length, data, copy);
+    _length += copy;
+    if (copy < size) {
+      _truncated = true;
+    }
+    return size;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+  size_t length() const { return _length; }
+  size_t received() const { return _received; }
+  bool truncated() const { return _truncated; }
+
+private:
+  char* _buffer;
+  size_t _capacity;
+  size_t _length;
+  size_t _received;
+  bool _truncated;
+};
+
+// Compressed HTTP body sink: inflates each network chunk straight into the
+// plain-text ScratchSink. Decoding stops once the sink is full, but the
+// connection is still drained.
+class InflateSink : public Stream {
+public:
+  InflateSink(Inflater& inflater, ScratchSink& out)
+      : _inflater(inflater), _out(out), _received(0), _state(Inflater::Result::NeedsInput) {}
+
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t* data, size_t size) override {
+    _received += size;
+    if (_state == Inflater::Result::NeedsInput) {
+      _state = _inflater.write(data, size, onInflated, &_out);
+    }
+    return size;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+  size_t received() const { return _received; }
+  // A stream that ended early or failed to decode is corrupt unless it was
+  // cut short on purpose at the size cap.
+  bool intact() const {
+    return _state == Inflater::Result::Done ||
+           (_state == Inflater::Result::Aborted && _out.truncated());
+  }
+
+private:
+  static bool onInflated(const uint8_t* data, size_t length, void* context) {
+    ScratchSink* sink = static_cast<ScratchSink*>(context);
+    sink->write(data, length);
+    return !sink->truncated();
+  }
+
+  Inflater& _inflater;
+  ScratchSink& _out;
+  size_t _received;
+  Inflater::Result _state;
+};
+
+// Transport errors (negative HTTPClient codes), timeouts, rate limiting and
+// server errors say nothing about the request itself.
+bool statusIsTransient(int status) {
+  return status < 0 || status == 408 || status == 429 || status >= 500;
+}
+
+// A read error or fewer bytes than Content-Length means the connection
+// dropped mid-body; parsing the rest would pass a partial feed off as whole.
+bool bodyComplete(int written, int expected, size_t received, RssFetchResult& result) {
+  if (written >= 0 && (expected <= 0 || received >= static_cast<size_t>(expected))) {
+    return true;
+  }
+  result.error = String("Body cut short at ") + received + " bytes";
+  result.errorClass = RssFetchError::Transient;
+  result.hostFailure = true;
+  return false;
+}
+
+// Streams the response body into `buffer` (NUL-terminated), inflating a
+// gzip/deflate Content-Encoding on the way.
+bool readBody(HTTPClient& http, char* buffer, size_t capacity, size_t& outLength,
+              RssFetchResult& result) {
+  ScratchSink sink(buffer, capacity);
+  const String encoding = http.header("Content-Encoding");
+  if (encoding.length() == 0 || encoding.equalsIgnoreCase("identity")) {
+    const int expected = http.getSize();
+    const int written = http.writeToStream(&sink);
+    result.wireBytes = sink.received();
+    if (!bodyComplete(written, expected, sink.received(), result)) {
+      return false;
+    }
+  } else {
+    Inflater::Format format = Inflater::Format::Gzip;
+    if (encoding.equalsIgnoreCase("deflate")) {
+      format = Inflater::Format::Zlib;
+    } else if (!encoding.equalsIgnoreCase("gzip") && !encoding.equalsIgnoreCase("x-gzip")) {
+      result.error = String("Unsupported Content-Encoding ") + encoding;
+      result.errorClass = RssFetchError::Permanent;
+      return false;
+    }
+    Inflater inflater;
+    if (!inflater.begin(format)) {
+      result.error = "Inflater allocation failed";
+      result.errorClass = RssFetchError::Transient;
+      return false;
+    }
+    InflateSink inflate(inflater, sink);
+    http.writeToStream(&inflate);
+    inflater.end();
+    result.compressed = true;
+    result.wireBytes = inflate.received();
+    if (!inflate.intact()) {
+      result.error = "Compressed body corrupt";
+      result.errorClass = RssFetchError::Transient;
+      result.hostFailure = true;
+      return false;
+    }
+  }
+  outLength = sink.length();
+  buffer[outLength] = '\0';
+  result.bodyBytes = outLength;
+  result.truncated = sink.truncated();
+  return true;
+}
+
+// Parse temporaries come from the arena when one is attached, else the heap.
+class ScratchText {
+public:
+  ScratchText(ScratchArena* arena, const char* src, size_t length)
+      : _text(nullptr), _length(length), _heap(false) {
+    if (arena != nullptr) {
+      _text = static_cast<char*>(arena->allocate(length + 1));
+    }
+    if (_text == nullptr) {
+      _text = static_cast<char*>(malloc(length + 1));
+      _heap = _text != nullptr;
+    }
+    if (_text != nullptr) {
+      memcpy(_text, src, length);
+      _text[length] = '\0';
+    }
+  }
+  ~ScratchText() {
+    if (_heap) {
+      free(_text);
+    }
+  }
 
-  const int start = block.indexOf(open);
-  if (start < 0) {
+  // Sanitizes in place and copies the result into a fixed item field.
+  void sanitizeInto(char* dst, size_t dstLen) {
+    if (_text == nullptr) {
+      safeCopy(dst, dstLen, "");
+      return;
+    }
+    sanitizeRssTextInPlace(_text, _length);
+    safeCopy(dst, dstLen, _text);
+  }
+
+private:
+  char* _text;
+  size_t _length;
+  bool _heap;
+};
+
+const char* findBounded(const char* begin, const char* end, const char* needle) {
+  const size_t needleLen = strlen(needle);
+  for (const char* p = begin; p + needleLen <= end; p++) {
+    if (*p == needle[0] && memcmp(p, needle, needleLen) == 0) {
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+// Finds <tag>...</tag> inside [begin, end); returns the content span.
+bool extractTagContent(const char* begin, const char* end, const char* tagName,
+                       const char*& outStart, size_t& outLength) {
+  char open[24];
+  char close[24];
+  snprintf(open, sizeof(open), "<%s>", tagName);
+  snprintf(close, sizeof(close), "</%s>", tagName);
+
+  const char* start = findBounded(begin, end, open);
+  if (start == nullptr) {
     return false;
   }
-  const int contentStart = start + open.length();
-  const int end = block.indexOf(close, contentStart);
-  if (end < 0) {
+  const char* contentStart = start + strlen(open);
+  const char* stop = findBounded(contentStart, end, close);
+  if (stop == nullptr) {
     return false;
   }
-
-  out = block.substring(contentStart, end);
+  outStart = contentStart;
+  outLength = static_cast<size_t>(stop - contentStart);
   return true;
 }
 
-bool payloadLooksLikeJson(const String& payload) {
-  for (size_t i = 0; i < payload.length(); i++) {
+void sanitizeInPlace(String& text) {
+  if (text.length() > 0) {
+    text.remove(sanitizeRssTextInPlace(&text[0], text.length()));
+  }
+}
+
+bool payloadLooksLikeJson(const char* payload, size_t length) {
+  for (size_t i = 0; i < length; i++) {
     const char c = payload[i];
     if (isspace(static_cast<unsigned char>(c))) {
       continue;
@@ -52,6 +274,18 @@ bool payloadLooksLikeJson(const String& payload) {
   return false;
 }
 
+bool payloadIsDigest(const char* payload, size_t length) {
+  return length >= kDigestHeaderBytes && memcmp(payload, kDigestMagic, sizeof(kDigestMagic)) == 0;
+}
+
+// Copies a length-prefixed digest string into a fixed item field, truncating
+// like strlcpy.
+void copyDigestText(char* dst, size_t dstLen, const char* src, size_t srcLen) {
+  const size_t copy = srcLen < dstLen - 1 ? srcLen : dstLen - 1;
+  memcpy(dst, src, copy);
+  dst[copy] = '\0';
+}
+
 bool urlRequestsJson(const char* url) {
   if (url == nullptr) {
     return false;
@@ -222,43 +456,6 @@ bool parseScoreValue(const String& scoreText, int& outScore) {
   return true;
 }
 
-bool looksLikeLiveGameDetail(const String& detailText) {
-  String lower = detailText;
-  lower.toLowerCase();
-  return lower.indexOf("top of") >= 0 || lower.indexOf("bottom of") >= 0 ||
-         lower.indexOf("halftime") >= 0 || lower.indexOf("qtr") >= 0 ||
-         lower.indexOf("quarter") >= 0 || lower.indexOf("period") >= 0 ||
-         lower.indexOf("in progress") >= 0 || lower.indexOf("live") >= 0;
-}
-
-bool looksLikeFinalGameDetail(const String& detailText) {
-  String lower = detailText;
-  lower.toLowerCase();
-  return lower.indexOf("final") >= 0 || lower.indexOf("completed") >= 0;
-}
-
-bool looksLikeScheduledDetail(const String& detailText) {
-  String lower = detailText;
-  lower.toLowerCase();
-
-  if (looksLikeLiveGameDetail(detailText) || looksLikeFinalGameDetail(detailText)) {
-    return false;
-  }
-
-  if (lower.indexOf("scheduled") >= 0 || lower.indexOf("pre-game") >= 0 ||
-      lower.indexOf("pregame") >= 0) {
-    return true;
-  }
-
-  const bool hasAt = lower.indexOf(" at ") >= 0;
-  const bool hasClock = (lower.indexOf(":") >= 0) &&
-                        (lower.indexOf(" am") >= 0 || lower.indexOf(" pm") >= 0);
-  const bool hasTz = lower.indexOf(" est") >= 0 || lower.indexOf(" edt") >= 0 ||
-                     lower.indexOf(" et") >= 0;
-
-  return hasAt && (hasClock || hasTz);
-}
-
 String colorTagWrap(const String& text, const char* hexColor) {
   String out = "[[#";
   out += hexColor;
@@ -439,7 +636,8 @@ bool extractEspnEvent(JsonObjectConst obj, String& outTitle, String& outDescript
     readNestedStatus(obj, status);
   }
 
-  bool isLive = looksLikeLiveGameDetail(status);
+  const uint8_t statusState = classifyRssStatus(status.c_str());
+  bool isLive = (statusState & RssItemFlagLive) != 0;
   if (!isLive) {
     JsonVariantConst statusNode = competition["status"];
     if (statusNode.is<JsonObjectConst>()) {
@@ -456,7 +654,7 @@ bool extractEspnEvent(JsonObjectConst obj, String& outTitle, String& outDescript
   }
 
   const bool showScores = awayScore.length() > 0 && homeScore.length() > 0 &&
-                          !(looksLikeScheduledDetail(status) && !isLive);
+                          !((statusState & RssItemFlagScheduled) != 0 && !isLive);
   formatSportsHeadline(awayName, homeName, awayTeamColorHex, homeTeamColorHex,
                        awayScore, homeScore, showScores, outTitle);
   outDescription = status;
@@ -566,12 +764,13 @@ bool extractHomeAwayPair(JsonObjectConst obj, String& outTitle, String& outDescr
     readNestedStatus(obj, detail);
   }
 
+  const uint8_t detailState = classifyRssStatus(detail.c_str());
   const bool isLive = (obj["isLive"].is<bool>() && obj["isLive"].as<bool>()) ||
                       (obj["live"].is<bool>() && obj["live"].as<bool>()) ||
-                      looksLikeLiveGameDetail(detail);
+                      (detailState & RssItemFlagLive) != 0;
 
   const bool showScores = awayScore.length() > 0 && homeScore.length() > 0 &&
-                          !(looksLikeScheduledDetail(detail) && !isLive);
+                          !((detailState & RssItemFlagScheduled) != 0 && !isLive);
   formatSportsHeadline(awayName, homeName, awayTeamColorHex, homeTeamColorHex,
                        awayScore, homeScore, showScores, outTitle);
   outDescription = detail;
@@ -645,16 +844,13 @@ void collectJsonItems(JsonVariantConst node, RssItem* outItems, size_t maxItems,
   String title;
   String description;
   if (parseJsonItemObject(obj, title, description)) {
-    const String safeTitle = sanitizeRssText(title);
-    const String safeDescription = sanitizeRssText(description);
-    if (safeTitle.length() > 0) {
-      safeCopy(outItems[count].title, sizeof(outItems[count].title), safeTitle.c_str());
+    sanitizeInPlace(title);
+    sanitizeInPlace(description);
+    if (title.length() > 0) {
+      safeCopy(outItems[count].title, sizeof(outItems[count].title), title.c_str());
       safeCopy(outItems[count].description, sizeof(outItems[count].description),
-               safeDescription.c_str());
-      String liveTest = safeTitle + " " + safeDescription;
-      liveTest.toLowerCase();
-      outItems[count].flags =
-          (liveTest.indexOf("live") >= 0) ? RssItemFlagLive : RssItemFlagNone;
+               description.c_str());
+      outItems[count].flags = RssItemFlagNone;
       count++;
       if (count >= maxItems) {
         return;
@@ -672,14 +868,50 @@ void collectJsonItems(JsonVariantConst node, RssItem* outItems, size_t maxItems,
     }
   }
 }
+
+uint16_t collectJsonDocument(JsonDocument& doc, const char* payload, size_t length,
+                             RssItem* outItems, size_t maxItems) {
+  DeserializationError err = deserializeJson(doc, payload, length);
+  if (err) {
+    return 0;
+  }
+
+  uint16_t count = 0;
+  collectJsonItems(doc.as<JsonVariantConst>(), outItems, maxItems, count, 0);
+  return count;
+}
 }  // namespace
 
-RssFetcher::RssFetcher() {}
+RssFetcher::RssFetcher() : _arena(nullptr) {}
+
+void RssFetcher::setScratchArena(ScratchArena* arena) { _arena = arena; }
 
 RssFetchResult RssFetcher::fetch(const char* url, RssItem* outItems,
                                  size_t maxItems, uint8_t maxAttempts,
                                  uint32_t timeoutMs, uint32_t backoffMs) const {
-  RssFetchResult result = {false, 0, -1, ""};
+  return fetchInto(url, outItems, maxItems, nullptr, nullptr, maxAttempts, timeoutMs,
+                   backoffMs);
+}
+
+RssFetchResult RssFetcher::fetchSections(const char* url, RssItem* outItems,
+                                         size_t maxItems, RssSectionFn onSection,
+                                         void* context, uint8_t maxAttempts,
+                                         uint32_t timeoutMs, uint32_t backoffMs) const {
+  if (onSection == nullptr) {
+    RssFetchResult result = {false, 0, -1, "Section callback is missing", 0, 0, false,
+                             false, false, 0, RssFetchError::Permanent, false, 0};
+    return result;
+  }
+  return fetchInto(url, outItems, maxItems, onSection, context, maxAttempts, timeoutMs,
+                   backoffMs);
+}
+
+RssFetchResult RssFetcher::fetchInto(const char* url, RssItem* outItems, size_t maxItems,
+                                     RssSectionFn onSection, void* context,
+                                     uint8_t maxAttempts, uint32_t timeoutMs,
+                                     uint32_t backoffMs) const {
+  RssFetchResult result = {false, 0, -1, "", 0, 0, false, false, false, 0,
+                           RssFetchError::Permanent, false, 0};
 
   if (url == nullptr || url[0] == '\0') {
     result.error = "RSS URL is empty";
@@ -701,53 +933,107 @@ RssFetchResult RssFetcher::fetch(const char* url, RssItem* outItems,
   }
 
   for (uint8_t attempt = 1; attempt <= maxAttempts; attempt++) {
-    WiFiClientSecure client;
-    client.setInsecure();
+    result.attempts = attempt;
+    result.hostFailure = false;
+    // Plain http:// is for local stand-ins (scripts/feed_standin_server.py).
+    WiFiClient plainClient;
+    WiFiClientSecure secureClient;
+    secureClient.setInsecure();
+    WiFiClient& client = strncmp(url, "https://", 8) == 0 ? secureClient : plainClient;
 
     HTTPClient http;
     http.setTimeout(static_cast<uint16_t>(timeoutMs));
 
+    // With an arena the body streams straight into its tail (inflated on the
+    // way when the server gzips it); otherwise fall back to a plain heap
+    // String.
+    size_t tailAvailable = 0;
+    char* tail = nullptr;
+    if (_arena != nullptr) {
+      _arena->reset();
+      tail = _arena->tail(tailAvailable);
+    }
+    const bool streamToArena = tail != nullptr && tailAvailable > 1;
+
     if (!http.begin(client, url)) {
       result.error = "HTTP begin failed";
+      result.errorClass = RssFetchError::Permanent;
     } else {
+      if (streamToArena &&
+          heap_caps_get_largest_free_block(MALLOC_CAP_8BIT) >= kInflateMinLargestBlock) {
+        http.addHeader("Accept-Encoding", "gzip, deflate");
+      }
+      http.collectHeaders(kCollectedHeaders, 1);
       const int status = http.GET();
       result.httpStatus = status;
 
       if (status == HTTP_CODE_OK) {
-        String payload = http.getString();
-        if (payload.length() > kRssMaxResponseBytes) {
-          payload.remove(kRssMaxResponseBytes);
-        }
-
-        const bool preferJson = urlRequestsJson(url) || payloadLooksLikeJson(payload);
-        uint16_t count = 0;
-        if (preferJson) {
-          count = parseJsonFeed(payload, outItems, maxItems);
-          if (count == 0) {
-            count = parseRssXml(payload, outItems, maxItems);
+        String heapPayload;
+        const char* payload = nullptr;
+        size_t payloadLen = 0;
+        bool haveBody = true;
+        if (streamToArena) {
+          const size_t cap = tailAvailable - 1 < kRssMaxResponseBytes
+                                 ? tailAvailable - 1
+                                 : kRssMaxResponseBytes;
+          haveBody = readBody(http, tail, cap, payloadLen, result);
+          if (haveBody) {
+            _arena->commitTail(payloadLen + 1);
+            payload = tail;
           }
         } else {
-          count = parseRssXml(payload, outItems, maxItems);
-          if (count == 0 && payloadLooksLikeJson(payload)) {
-            count = parseJsonFeed(payload, outItems, maxItems);
+          // getString() hides read errors; only the length can tell.
+          const int expected = http.getSize();
+          heapPayload = http.getString();
+          result.wireBytes = heapPayload.length();
+          haveBody = bodyComplete(0, expected, heapPayload.length(), result);
+          if (heapPayload.length() > kRssMaxResponseBytes) {
+            heapPayload.remove(kRssMaxResponseBytes);
+            result.truncated = true;
           }
+          payload = heapPayload.c_str();
+          payloadLen = heapPayload.length();
+          result.bodyBytes = payloadLen;
+        }
+
+        uint16_t count = 0;
+        if (haveBody) {
+          count = onSection != nullptr
+                      ? parseSections(url, payload, payloadLen, outItems, maxItems,
+                                      onSection, context, result)
+                      : parsePayload(url, payload, payloadLen, outItems, maxItems, result);
         }
 
         if (count > 0) {
           result.success = true;
           result.itemCount = count;
           result.error = "";
+          result.errorClass = RssFetchError::None;
           http.end();
           return result;
         }
 
-        result.error = "No feed items parsed";
+        if (haveBody) {
+          if (result.digest) {
+            result.error = "Digest invalid or empty";
+          } else {
+            result.error = onSection != nullptr ? "No league sections parsed"
+                                                : "No feed items parsed";
+          }
+          result.errorClass = RssFetchError::Permanent;
+        }
       } else {
         result.error = String("HTTP status ") + status;
+        result.errorClass =
+            statusIsTransient(status) ? RssFetchError::Transient : RssFetchError::Permanent;
+        result.hostFailure = statusIsTransient(status);
       }
       http.end();
     }
 
+    if (result.errorClass == RssFetchError::Permanent) {
+      break;
+    }
     if (attempt < maxAttempts) {
       delay(backoffMs * attempt);
     }
@@ -756,71 +1042,184 @@ RssFetchResult RssFetcher::fetch(const char* url, RssItem* outItems,
   return result;
 }
 
-uint16_t RssFetcher::parseRssXml(const String& xml, RssItem* outItems,
+uint16_t RssFetcher::parsePayload(const char* url, const char* payload, size_t length,
+                                  RssItem* outItems, size_t maxItems,
+                                  RssFetchResult& result) const {
+  uint16_t count = 0;
+  if (payloadIsDigest(payload, length)) {
+    count = parseDigest(payload, length, outItems, maxItems);
+    result.digest = true;
+  } else {
+    const bool looksJson = payloadLooksLikeJson(payload, length);
+    const bool preferJson = urlRequestsJson(url) || looksJson;
+    if (preferJson) {
+      count = parseJsonFeed(payload, length, outItems, maxItems);
+      if (count == 0) {
+        count = parseRssXml(payload, length, outItems, maxItems);
+      }
+    } else {
+      count = parseRssXml(payload, length, outItems, maxItems);
+      if (count == 0 && looksJson) {
+        count = parseJsonFeed(payload, length, outItems, maxItems);
+      }
+    }
+  }
+
+  // Digest items arrive classified by the companion service.
+  for (uint16_t i = 0; i < count; i++) {
+    if (!rssItemIsClassified(outItems[i].flags)) {
+      outItems[i].flags = classifyRssItem(outItems[i]);
+    }
+  }
+  return count;
+}
+
+// Each section's parse scratch is rewound before the next, so a six-league
+// batch needs no more arena than its largest section.
+uint16_t RssFetcher::parseSections(const char* url, const char* payload, size_t length,
+                                   RssItem* outItems, size_t maxItems,
+                                   RssSectionFn onSection, void* context,
+                                   RssFetchResult& result) const {
+  const char* const end = payload + length;
+  const char* marker = length >= sizeof(kSectionMarker) - 1 &&
+                               memcmp(payload, kSectionMarker, sizeof(kSectionMarker) - 1) == 0
+                           ? payload
+                           : nullptr;
+  if (marker == nullptr) {
+    marker = findBounded(payload, end, "\n@@section ");
+    if (marker != nullptr) {
+      marker++;
+    }
+  }
+
+  uint16_t total = 0;
+  while (marker != nullptr) {
+    const char* keyStart = marker + sizeof(kSectionMarker) - 1;
+    const char* lineEnd =
+        static_cast<const char*>(memchr(keyStart, '\n', static_cast<size_t>(end - keyStart)));
+    const char* bodyStart = lineEnd != nullptr ? lineEnd + 1 : end;
+    const char* next = findBounded(bodyStart, end, "\n@@section ");
+    const char* bodyEnd = next != nullptr ? next : end;
+
+    char key[kSectionKeyLen + 1];
+    size_t keyLen = 0;
+    for (const char* p = keyStart; p < bodyStart && keyLen < kSectionKeyLen; p++) {
+      if (!isspace(static_cast<unsigned char>(*p))) {
+        key[keyLen++] = *p;
+      }
+    }
+    key[keyLen] = '\0';
+
+    const size_t mark = _arena != nullptr ? _arena->mark() : 0;
+    const uint16_t count =
+        keyLen > 0 ? parsePayload(url, bodyStart, static_cast<size_t>(bodyEnd - bodyStart),
+                                  outItems, maxItems, result)
+                   : 0;
+    if (_arena != nullptr) {
+      _arena->rewind(mark);
+    }
+    if (count > 0) {
+      onSection(key, count, context);
+      result.sections++;
+      total += count;
+    }
+    marker = next != nullptr ? next + 1 : nullptr;
+  }
+  return total;
+}
+
+uint16_t RssFetcher::parseRssXml(const char* xml, size_t length, RssItem* outItems,
                                  size_t maxItems) const {
   uint16_t count = 0;
-  int searchPos = 0;
+  const char* cursor = xml;
+  const char* const end = xml + length;
 
   while (count < maxItems) {
-    const int itemStart = xml.indexOf("<item", searchPos);
-    if (itemStart < 0) {
+    const char* itemStart = findBounded(cursor, end, "<item");
+    if (itemStart == nullptr) {
       break;
     }
 
-    const int itemOpenEnd = xml.indexOf('>', itemStart);
-    if (itemOpenEnd < 0) {
+    const char* itemOpenEnd =
+        static_cast<const char*>(memchr(itemStart, '>', static_cast<size_t>(end - itemStart)));
+    if (itemOpenEnd == nullptr) {
       break;
     }
 
-    const int itemEnd = xml.indexOf("</item>", itemOpenEnd + 1);
-    if (itemEnd < 0) {
+    const char* itemEnd = findBounded(itemOpenEnd + 1, end, "</item>");
+    if (itemEnd == nullptr) {
       break;
     }
 
-    const String itemBlock = xml.substring(itemOpenEnd + 1, itemEnd);
-    String rawTitle;
-    String rawDescription;
-
-    extractTagContent(itemBlock, "title", rawTitle);
-    extractTagContent(itemBlock, "description", rawDescription);
-
-    const String title = sanitizeRssText(rawTitle);
-    const String description = sanitizeRssText(rawDescription);
-
-    if (title.length() > 0) {
-      safeCopy(outItems[count].title, sizeof(outItems[count].title), title.c_str());
-      safeCopy(outItems[count].description, sizeof(outItems[count].description),
-               description.c_str());
-      outItems[count].flags = RssItemFlagNone;
+    const char* rawTitle = itemOpenEnd;
+    size_t rawTitleLen = 0;
+    const char* rawDescription = itemOpenEnd;
+    size_t rawDescriptionLen = 0;
+    extractTagContent(itemOpenEnd + 1, itemEnd, "title", rawTitle, rawTitleLen);
+    extractTagContent(itemOpenEnd + 1, itemEnd, "description", rawDescription,
+                      rawDescriptionLen);
+
+    RssItem& item = outItems[count];
+    ScratchText title(_arena, rawTitle, rawTitleLen);
+    title.sanitizeInto(item.title, sizeof(item.title));
+    if (item.title[0] != '\0') {
+      ScratchText description(_arena, rawDescription, rawDescriptionLen);
+      description.sanitizeInto(item.description, sizeof(item.description));
+      item.flags = RssItemFlagNone;
       count++;
     }
 
-    searchPos = itemEnd + 7;
+    cursor = itemEnd + 7;
   }
 
   return count;
 }
 
-uint16_t RssFetcher::parseJsonFeed(const String& payload, RssItem* outItems,
-                                   size_t maxItems) const {
+uint16_t RssFetcher::parseJsonFeed(const char* payload, size_t length,
+                                   RssItem* outItems, size_t maxItems) const {
   if (outItems == nullptr || maxItems == 0) {
     return 0;
   }
 
-  size_t capacity = payload.length() + 4096;
-  if (capacity < 8192) {
-    capacity = 8192;
-  } else if (capacity > 96 * 1024) {
-    capacity = 96 * 1024;
+  // The document tree lives in the arena when one is attached.
+  if (_arena != nullptr) {
+    ScratchJsonAllocator allocator(*_arena);
+    JsonDocument doc(&allocator);
+    return collectJsonDocument(doc, payload, length, outItems, maxItems);
   }
+  JsonDocument doc;
+  return collectJsonDocument(doc, payload, length, outItems, maxItems);
+}
 
-  DynamicJsonDocument doc(capacity);
-  DeserializationError err = deserializeJson(doc, payload);
-  if (err) {
+uint16_t RssFetcher::parseDigest(const char* payload, size_t length, RssItem* outItems,
+                                 size_t maxItems) const {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(payload);
+  if (length < kDigestHeaderBytes || data[4] != kDigestVersion) {
     return 0;
   }
 
+  const uint8_t itemCount = data[5];
+  size_t offset = kDigestHeaderBytes;
   uint16_t count = 0;
-  collectJsonItems(doc.as<JsonVariantConst>(), outItems, maxItems, count, 0);
+  for (uint8_t i = 0; i < itemCount && count < maxItems; i++) {
+    if (length - offset < kDigestItemHeaderBytes) {
+      return 0;
+    }
+    const uint8_t flags = data[offset];
+    const size_t titleLen = data[offset + 1];
+    const size_t descriptionLen = data[offset + 2];
+    offset += kDigestItemHeaderBytes;
+    if (length - offset < titleLen + descriptionLen) {
+      return 0;
+    }
+    if (titleLen > 0) {
+      RssItem& item = outItems[count++];
+      copyDigestText(item.title, sizeof(item.title), payload + offset, titleLen);
+      copyDigestText(item.description, sizeof(item.description), payload + offset + titleLen,
+                     descriptionLen);
+      item.flags = flags;
+    }
+    offset += titleLen + descriptionLen;
+  }
   return count;
 }
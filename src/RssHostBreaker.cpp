@@ -0,0 +1,152 @@
+#include "RssHostBreaker.h"
+
+#include <ctype.h>
+#include <string.h>
+
+namespace {
+constexpr uint8_t kTripFailures = 2;
+constexpr uint32_t kCooldownBaseMs = 2UL * 60UL * 1000UL;
+constexpr uint32_t kCooldownMaxMs = 30UL * 60UL * 1000UL;
+
+bool elapsed(uint32_t sinceMs, uint32_t durationMs, uint32_t nowMs) {
+  return static_cast<uint32_t>(nowMs - sinceMs) >= durationMs;
+}
+}  // namespace
+
+RssHostBreaker::RssHostBreaker() : _entries{}, _count(0) {}
+
+void RssHostBreaker::reset() {
+  memset(_entries, 0, sizeof(_entries));
+  _count = 0;
+}
+
+bool RssHostBreaker::allow(const char* url, uint32_t nowMs, bool& outProbe) {
+  outProbe = false;
+  char host[sizeof(_entries[0].host)];
+  if (!hostOf(url, host, sizeof(host))) {
+    return true;
+  }
+  const int index = find(host);
+  if (index < 0) {
+    return true;
+  }
+  RssHostBreakerEntry& e = _entries[index];
+  if (e.state == RssBreakerState::Closed) {
+    return true;
+  }
+  if (e.state == RssBreakerState::HalfOpen ||
+      !elapsed(e.openedMs, e.cooldownMs, nowMs)) {
+    return false;
+  }
+  e.state = RssBreakerState::HalfOpen;
+  outProbe = true;
+  return true;
+}
+
+void RssHostBreaker::record(const char* url, bool hostFailure, uint32_t nowMs) {
+  char host[sizeof(_entries[0].host)];
+  if (!hostOf(url, host, sizeof(host))) {
+    return;
+  }
+  const int index = hostFailure ? findOrAdd(host) : find(host);
+  if (index < 0) {
+    return;
+  }
+  RssHostBreakerEntry& e = _entries[index];
+  if (!hostFailure) {
+    e.state = RssBreakerState::Closed;
+    e.failures = 0;
+    e.cooldownMs = 0;
+    return;
+  }
+
+  if (e.failures < UINT8_MAX) {
+    e.failures++;
+  }
+  if (e.state == RssBreakerState::HalfOpen) {
+    e.cooldownMs = e.cooldownMs * 2 < kCooldownMaxMs ? e.cooldownMs * 2 : kCooldownMaxMs;
+  } else if (e.state == RssBreakerState::Closed && e.failures >= kTripFailures) {
+    e.cooldownMs = kCooldownBaseMs;
+    if (e.trips < UINT16_MAX) {
+      e.trips++;
+    }
+  } else {
+    return;
+  }
+  e.state = RssBreakerState::Open;
+  e.openedMs = nowMs;
+}
+
+uint32_t RssHostBreaker::msUntilRetry(const char* url, uint32_t nowMs) const {
+  char host[sizeof(_entries[0].host)];
+  if (!hostOf(url, host, sizeof(host))) {
+    return 0;
+  }
+  const int index = find(host);
+  if (index < 0 || _entries[index].state != RssBreakerState::Open) {
+    return 0;
+  }
+  const RssHostBreakerEntry& e = _entries[index];
+  const uint32_t openFor = nowMs - e.openedMs;
+  return openFor >= e.cooldownMs ? 0 : e.cooldownMs - openFor;
+}
+
+size_t RssHostBreaker::count() const { return _count; }
+
+bool RssHostBreaker::entry(size_t index, RssHostBreakerEntry& outEntry) const {
+  if (index >= _count) {
+    return false;
+  }
+  outEntry = _entries[index];
+  return true;
+}
+
+const char* RssHostBreaker::stateName(RssBreakerState state) {
+  switch (state) {
+    case RssBreakerState::Open:
+      return "open";
+    case RssBreakerState::HalfOpen:
+      return "half_open";
+    case RssBreakerState::Closed:
+    default:
+      return "closed";
+  }
+}
+
+// Lowercased authority (host[:port]) between "://" and the path.
+bool RssHostBreaker::hostOf(const char* url, char* outHost, size_t outHostLen) {
+  if (url == nullptr || outHostLen == 0) {
+    return false;
+  }
+  const char* start = strstr(url, "://");
+  start = start != nullptr ? start + 3 : url;
+  size_t len = 0;
+  for (const char* p = start; *p != '\0' && *p != '/' && *p != '?' && *p != '#'; p++) {
+    if (len + 1 < outHostLen) {
+      outHost[len++] = static_cast<char>(tolower(static_cast<unsigned char>(*p)));
+    }
+  }
+  outHost[len] = '\0';
+  return len > 0;
+}
+
+int RssHostBreaker::find(const char* host) const {
+  for (size_t i = 0; i < _count; i++) {
+    if (strcmp(_entries[i].host, host) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+int RssHostBreaker::findOrAdd(const char* host) {
+  const int index = find(host);
+  if (index >= 0 || _count >= APP_MAX_RSS_SOURCES) {
+    return index;
+  }
+  RssHostBreakerEntry& e = _entries[_count];
+  memset(&e, 0, sizeof(e));
+  strncpy(e.host, host, sizeof(e.host) - 1);
+  e.state = RssBreakerState::Closed;
+  return static_cast<int>(_count++);
+}
@@ -0,0 +1,191 @@
+#include "RssRefreshScheduler.h"
+
+#include <string.h>
+
+namespace {
+constexpr uint32_t kDefaultIntervalMs = 15UL * 60UL * 1000UL;
+constexpr uint32_t kMinIntervalMs = 5UL * 60UL * 1000UL;
+constexpr uint32_t kMaxIntervalMs = 60UL * 60UL * 1000UL;
+constexpr uint32_t kLiveMinIntervalMs = 60UL * 1000UL;
+constexpr uint32_t kLiveMaxIntervalMs = 3UL * 60UL * 1000UL;
+constexpr uint32_t kRetryBaseMs = 60UL * 1000UL;
+constexpr uint32_t kRetryMaxMs = 30UL * 60UL * 1000UL;
+constexpr uint8_t kMaxFailureShift = 5;
+
+bool dueBy(uint32_t dueMs, uint32_t nowMs) {
+  return static_cast<int32_t>(nowMs - dueMs) >= 0;
+}
+
+uint32_t clampInterval(uint32_t value, uint32_t low, uint32_t high) {
+  if (value < low) return low;
+  if (value > high) return high;
+  return value;
+}
+}  // namespace
+
+RssRefreshScheduler::RssRefreshScheduler()
+    : _entries{},
+      _heap{},
+      _heapPos{},
+      _count(0),
+      _liveMaxIntervalMs(kLiveMaxIntervalMs) {}
+
+void RssRefreshScheduler::reset(size_t sourceCount, uint32_t firstDueMs) {
+  _count = sourceCount < APP_MAX_RSS_SOURCES ? sourceCount : APP_MAX_RSS_SOURCES;
+  memset(_entries, 0, sizeof(_entries));
+  for (size_t i = 0; i < _count; i++) {
+    _entries[i].dueMs = firstDueMs;
+    _entries[i].intervalMs = kDefaultIntervalMs;
+    _heap[i] = static_cast<uint8_t>(i);
+    _heapPos[i] = static_cast<uint8_t>(i);
+  }
+}
+
+void RssRefreshScheduler::markAllDue(uint32_t dueMs) {
+  for (size_t i = 0; i < _count; i++) {
+    _entries[i].dueMs = dueMs;
+  }
+}
+
+void RssRefreshScheduler::setLivePriority(bool enabled) {
+  _liveMaxIntervalMs = enabled ? kLiveMinIntervalMs : kLiveMaxIntervalMs;
+}
+
+bool RssRefreshScheduler::isDue(size_t index, uint32_t nowMs) const {
+  return index < _count && dueBy(_entries[index].dueMs, nowMs);
+}
+
+// Walks the heap from the root and prunes any subtree whose root is not due.
+size_t RssRefreshScheduler::collectDue(uint32_t nowMs, size_t* outIndices,
+                                       size_t maxIndices) const {
+  size_t found = 0;
+  uint8_t stack[APP_MAX_RSS_SOURCES];
+  size_t depth = 0;
+  if (_count > 0) {
+    stack[depth++] = 0;
+  }
+  while (depth > 0 && found < maxIndices) {
+    const size_t pos = stack[--depth];
+    const size_t index = _heap[pos];
+    if (!dueBy(_entries[index].dueMs, nowMs)) {
+      continue;
+    }
+    outIndices[found++] = index;
+    const size_t left = (pos * 2) + 1;
+    if (left < _count) stack[depth++] = static_cast<uint8_t>(left);
+    if (left + 1 < _count) stack[depth++] = static_cast<uint8_t>(left + 1);
+  }
+  return found;
+}
+
+uint32_t RssRefreshScheduler::msUntilNextDue(uint32_t nowMs) const {
+  if (_count == 0) {
+    return UINT32_MAX;
+  }
+  const uint32_t dueMs = _entries[_heap[0]].dueMs;
+  return dueBy(dueMs, nowMs) ? 0 : dueMs - nowMs;
+}
+
+bool RssRefreshScheduler::recordSuccess(size_t index, uint32_t nowMs,
+                                        uint32_t contentHash, bool live) {
+  if (index >= _count) {
+    return true;
+  }
+  RssSourceSchedule& e = _entries[index];
+  const bool firstCheck = e.checks == 0;
+  const bool changed = firstCheck || contentHash != e.contentHash;
+
+  uint32_t interval = e.intervalMs;
+  if (!firstCheck) {
+    interval = changed ? interval / 2 : interval + (interval / 2);
+  }
+  interval = live ? clampInterval(interval, kLiveMinIntervalMs, _liveMaxIntervalMs)
+                  : clampInterval(interval, kMinIntervalMs, kMaxIntervalMs);
+
+  if (e.checks < UINT16_MAX) e.checks++;
+  if (changed && !firstCheck && e.changes < UINT16_MAX) e.changes++;
+  e.contentHash = contentHash;
+  e.intervalMs = interval;
+  e.lastCheckMs = nowMs;
+  e.failures = 0;
+  e.live = live;
+  reschedule(index, nowMs + interval);
+  return changed;
+}
+
+void RssRefreshScheduler::recordFailure(size_t index, uint32_t nowMs, bool permanent) {
+  if (index >= _count) {
+    return;
+  }
+  RssSourceSchedule& e = _entries[index];
+  if (e.failures < UINT8_MAX) {
+    e.failures++;
+  }
+  const uint8_t shift = e.failures - 1 < kMaxFailureShift ? e.failures - 1 : kMaxFailureShift;
+  uint32_t delay = kRetryBaseMs << shift;
+  if (delay > kRetryMaxMs || permanent) {
+    delay = kRetryMaxMs;
+  }
+  e.lastCheckMs = nowMs;
+  reschedule(index, nowMs + delay);
+}
+
+void RssRefreshScheduler::postpone(size_t index, uint32_t dueMs) {
+  if (index < _count) {
+    reschedule(index, dueMs);
+  }
+}
+
+bool RssRefreshScheduler::entry(size_t index, RssSourceSchedule& outEntry) const {
+  if (index >= _count) {
+    return false;
+  }
+  outEntry = _entries[index];
+  return true;
+}
+
+bool RssRefreshScheduler::earlier(size_t heapA, size_t heapB) const {
+  return static_cast<int32_t>(_entries[_heap[heapA]].dueMs -
+                              _entries[_heap[heapB]].dueMs) < 0;
+}
+
+void RssRefreshScheduler::reschedule(size_t index, uint32_t dueMs) {
+  _entries[index].dueMs = dueMs;
+  const size_t pos = _heapPos[index];
+  siftUp(pos);
+  siftDown(_heapPos[index]);
+}
+
+void RssRefreshScheduler::swapNodes(size_t heapA, size_t heapB) {
+  const uint8_t a = _heap[heapA];
+  _heap[heapA] = _heap[heapB];
+  _heap[heapB] = a;
+  _heapPos[_heap[heapA]] = static_cast<uint8_t>(heapA);
+  _heapPos[_heap[heapB]] = static_cast<uint8_t>(heapB);
+}
+
+void RssRefreshScheduler::siftUp(size_t heapPos) {
+  while (heapPos > 0) {
+    const size_t parent = (heapPos - 1) / 2;
+    if (!earlier(heapPos, parent)) {
+      return;
+    }
+    swapNodes(heapPos, parent);
+    heapPos = parent;
+  }
+}
+
+void RssRefreshScheduler::siftDown(size_t heapPos) {
+  while (true) {
+    const size_t left = (heapPos * 2) + 1;
+    const size_t right = left + 1;
+    size_t smallest = heapPos;
+    if (left < _count && earlier(left, smallest)) smallest = left;
+    if (right < _count && earlier(right, smallest)) smallest = right;
+    if (smallest == heapPos) {
+      return;
+    }
+    swapNodes(heapPos, smallest);
+    heapPos = smallest;
+  }
+}
@@ -1,11 +1,16 @@
 #include "RssRuntime.h"
 
 #include <HTTPClient.h>
+#include <WiFiClient.h>
 #include <WiFiClientSecure.h>
+#include <esp_heap_caps.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "AppConfig.h"
 #include "RssSources.h"
+#include "WeatherExtractor.h"
 #if __has_include("Secrets.h")
 #include "Secrets.h"
 #endif
@@ -23,86 +28,166 @@ constexpr ColorTriplet kSourceColors[] = {
 };
 
 constexpr uint32_t kItemsPerInterstitial = 6;
+// Interstitial rotation: time, weather, then each configured message.
+constexpr uint8_t kInterstitialSlots = static_cast<uint8_t>(APP_MAX_MESSAGES + 2);
 constexpr uint32_t kClockSyncRetryMs = 60UL * 1000UL;
-constexpr uint32_t kClockResyncMs = 6UL * 60UL * 60UL * 1000UL;
+// How long a wake window lingers for the SNTP reply before dropping the radio.
+constexpr uint32_t kClockReplyWaitMs = 1500;
 constexpr uint32_t kWeatherRefreshMs = 15UL * 60UL * 1000UL;
 constexpr uint32_t kWeatherRetryMs = 60UL * 1000UL;
 constexpr const char* kNtpServer1 = "pool.ntp.org";
 constexpr const char* kNtpServer2 = "time.nist.gov";
 constexpr const char* kNtpServer3 = "time.google.com";
 constexpr const char* kEasternTz = "EST5EDT,M3.2.0/2,M11.1.0/2";
+constexpr uint32_t kProducerStackWords = 6144;
+constexpr UBaseType_t kProducerPriority = 1;
+constexpr BaseType_t kProducerCore = 0;  // keep fetches off the scroll loop core
+constexpr uint32_t kProducerIdleMs = 1000;
+constexpr uint32_t kIdlePollMs = 20;
+constexpr uint32_t kDequeueWaitMs = 20;
+constexpr uint32_t kFirstRefreshDelayMs = 2500;
+constexpr size_t kMinScratchBytes = 32 * 1024;
+// Live priority: one live game after every kHeadlinesPerLiveItem picks.
+constexpr uint32_t kHeadlinesPerLiveItem = 2;
+constexpr ColorTriplet kScoreUpdateColor = {255, 140, 0};
+// Each fetch may retry twice, but one refresh cycle retries at most
+// kRetryBudgetPerCycle times in total across all sources.
+constexpr uint8_t kFetchAttempts = 3;
+constexpr uint8_t kRetryBudgetPerCycle = 3;
+constexpr uint32_t kBreakerRecheckMs = 30UL * 1000UL;
 #ifndef APP_WEATHER_API_URL
 #define APP_WEATHER_API_URL ""
 #endif
 constexpr const char* kWeatherApiUrl = APP_WEATHER_API_URL;
 
-bool extractXmlAttribute(const String& xml, const char* tagName, const char* attrName,
-                         String& out) {
-  if (tagName == nullptr || attrName == nullptr) {
-    return false;
-  }
+uint32_t laterOf(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) >= 0 ? a : b;
+}
 
-  String open = String("<") + tagName;
-  const int tagStart = xml.indexOf(open);
-  if (tagStart < 0) {
-    return false;
+uint32_t fnv1aAppend(uint32_t hash, const char* text) {
+  while (*text != '\0') {
+    hash ^= static_cast<uint8_t>(*text++);
+    hash *= 16777619UL;
   }
+  return hash;
+}
 
-  const int tagEnd = xml.indexOf('>', tagStart);
-  if (tagEnd < 0) {
-    return false;
-  }
+// Change detector for an item list; live flags are included so a game going
+// final counts as a change even when the text is identical.
+uint32_t hashItemsBegin(size_t count) { return 2166136261UL ^ static_cast<uint32_t>(count); }
 
-  String tag = xml.substring(tagStart, tagEnd + 1);
-  String key = String(attrName) + "=\"";
-  const int valueStart = tag.indexOf(key);
-  if (valueStart < 0) {
-    return false;
-  }
+uint32_t hashItemAppend(uint32_t hash, const RssItem& item) {
+  hash = fnv1aAppend(hash, item.title);
+  hash = fnv1aAppend(hash, item.description);
+  hash ^= item.flags;
+  hash *= 16777619UL;
+  return hash;
+}
 
-  const int start = valueStart + key.length();
-  const int end = tag.indexOf('"', start);
-  if (end <= start) {
-    return false;
+uint32_t hashFetchedItems(const RssItem* items, size_t count, bool& outLive) {
+  uint32_t hash = hashItemsBegin(count);
+  outLive = false;
+  for (size_t i = 0; i < count; i++) {
+    hash = hashItemAppend(hash, items[i]);
+    if ((items[i].flags & RssItemFlagLive) != 0) {
+      outLive = true;
+    }
   }
+  return hash;
+}
 
-  out = tag.substring(start, end);
-  out.trim();
-  return out.length() > 0;
+void appendText(char* out, size_t outLen, size_t& used, const char* text) {
+  while (*text != '\0' && used + 1 < outLen) {
+    out[used++] = *text++;
+  }
+  out[used] = '\0';
 }
 
-void appendWeatherPart(String& out, const String& prefix, const String& value,
-                       const String& suffix) {
-  if (value.length() == 0) {
+// Appends prefix + value + suffix when the value is present; the message is
+// cut at the end of the buffer rather than reallocated.
+void appendWeatherPart(char* out, size_t outLen, size_t& used, const char* prefix,
+                       const char* value, const char* suffix) {
+  if (value[0] == '\0') {
     return;
   }
-  out += prefix;
-  out += value;
-  out += suffix;
+  appendText(out, outLen, used, prefix);
+  appendText(out, outLen, used, value);
+  appendText(out, outLen, used, suffix);
 }
+
+// Scoped holder for the runtime's recursive mutexes. The state mutex guards
+// playback/cache state shared by the loop, producer and boot tasks; the
+// network mutex serializes radio and fetch work. Take network before state.
+class RecursiveLock {
+public:
+  explicit RecursiveLock(SemaphoreHandle_t mutex) : _mutex(mutex) {
+    if (_mutex != nullptr) {
+      xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+    }
+  }
+  ~RecursiveLock() {
+    if (_mutex != nullptr) {
+      xSemaphoreGiveRecursive(_mutex);
+    }
+  }
+
+private:
+  SemaphoreHandle_t _mutex;
+};
 }  // namespace
 
-RssRuntime::RssRuntime(SettingsStore& settingsStore, WifiService& wifiService)
+RssRuntime::RssRuntime(SettingsStore& settingsStore, WifiService& wifiService,
+                       RadioSessionBroker& radioBroker)
     : _settingsStore(settingsStore),
       _wifiService(wifiService),
+      _radioBroker(radioBroker),
       _fetcher(),
+      _scratch(),
       _cache(),
       _sources{},
       _sourceCount(0),
+      _sourcesGeneration(0),
       _suspended(false),
-      _radioControlEnabled(true),
-      _nextRefreshMs(0),
+      _producerParked(false),
+      _windowRefreshed(false),
+      _producerWindow(false),
+      _segmentNetworkEnabled(true),
+      _stateMutex(nullptr),
+      _networkMutex(nullptr),
+      _segmentQueue(nullptr),
+      _producerTask(nullptr),
+      _segmentGeneration(0),
+      _orderedRefreshRequested(false),
+      _segmentsServed(0),
+      _segmentUnderruns(0),
+      _lastDequeueUs(0),
+      _maxDequeueUs(0),
+      _lastBuildMs(0),
+      _maxBuildMs(0),
+      _scheduler(),
+      _scoreBoard(),
+      _hostBreaker(),
+      _retryBudget(0),
+      _breakerSkips(0),
+      _pendingScores{},
+      _pendingScoreCount(0),
+      _scoreUpdates(0),
+      _headlinesSinceLive(0),
+      _livePriorityEnabled(true),
+      _sportsBatchUrl{},
       _cacheReady(false),
       _randomEnabled(true),
       _haveCurrentItem(false),
       _showTitleNext(true),
       _itemsSinceInterstitial(0),
       _interstitialCursor(0),
-      _clockSynced(false),
-      _clockSyncEpoch(0),
-      _clockSyncMillis(0),
+      _clock(),
+      _playbackStore(),
+      _resumeCheckpoint{},
+      _resumePending(false),
+      _playbackResumed(false),
       _lastClockSyncAttemptMs(0),
-      _weatherMessage("Weather unavailable"),
+      _weatherMessage{},
       _weatherReady(false),
       _pendingStartupWeather(true),
       _weatherLastFetchMs(0),
@@ -116,47 +201,107 @@ RssRuntime::RssRuntime(SettingsStore& settingsStore, WifiService& wifiService)
       _fetchItems{} {}
 
 bool RssRuntime::begin() {
+  if (_stateMutex == nullptr) {
+    _stateMutex = xSemaphoreCreateRecursiveMutex();
+  }
+  if (_networkMutex == nullptr) {
+    _networkMutex = xSemaphoreCreateRecursiveMutex();
+  }
+  _clock.begin(kEasternTz);
+  // Reserve parse scratch before the heap fragments; shrink if boot is tight.
+  size_t scratchBytes = APP_RSS_SCRATCH_BYTES;
+  while (!_scratch.reserve(scratchBytes) && scratchBytes / 2 >= kMinScratchBytes) {
+    scratchBytes /= 2;
+  }
+  if (_scratch.reserved()) {
+    _fetcher.setScratchArena(&_scratch);
+    Serial.print("[RSS] Scratch arena reserved bytes=");
+    Serial.println(static_cast<uint32_t>(_scratch.capacity()));
+  } else {
+    Serial.println("[RSS] Scratch arena unavailable; parsing on the heap");
+  }
+  // After the arena, so the cache's RAM tier is sized from what is left.
   if (!_cache.begin()) {
     return false;
   }
   rebuildSources(_settingsStore.settings());
   _cacheReady = hasCachedContent();
   _pendingStartupWeather = true;
-  _nextRefreshMs = millis() + 2500;
+  // Applied by the resetPlayback() of the settings pass that follows begin().
+  _resumePending = _playbackStore.restore(_resumeCheckpoint);
+
+  if (_segmentQueue == nullptr) {
+    _segmentQueue = xQueueCreate(kLookaheadSegments, sizeof(QueuedSegment));
+  }
+  if (_segmentQueue != nullptr && _producerTask == nullptr &&
+      xTaskCreatePinnedToCore(producerTask, "rss_producer", kProducerStackWords,
+                              this, kProducerPriority, &_producerTask,
+                              kProducerCore) != pdPASS) {
+    _producerTask = nullptr;
+    Serial.println("[RSS] Producer task start failed; building segments inline");
+  }
   return true;
 }
 
+// Most saves touch messages or display settings; playback and refresh state
+// only start over when the source list itself changed.
 void RssRuntime::onSettingsChanged(const AppSettings& settings) {
-  rebuildSources(settings);
-  _cacheReady = hasCachedContent();
-  _pendingStartupWeather = true;
-  resetPlayback();
-  forceRefreshSoon();
+  RecursiveLock lock(_stateMutex);
+  const bool wasRandom = _randomEnabled;
+  if (rebuildSources(settings)) {
+    _cacheReady = hasCachedContent();
+    _pendingStartupWeather = true;
+    resetPlayback();
+    forceRefreshSoon();
+  } else if (_randomEnabled != wasRandom || _resumePending) {
+    resetPlayback();
+  }
 }
 
-void RssRuntime::setSuspended(bool suspended) { _suspended = suspended; }
+void RssRuntime::setSuspended(bool suspended) {
+  _suspended = suspended;
+  if (!suspended && _producerTask != nullptr) {
+    xTaskNotifyGive(_producerTask);
+  }
+}
 
-void RssRuntime::setRadioControlEnabled(bool enabled) {
-  _radioControlEnabled = enabled;
+bool RssRuntime::waitProducerIdle(uint32_t timeoutMs) const {
+  const uint32_t startMs = millis();
+  while (!((_producerTask == nullptr || _producerParked) && networkIdle())) {
+    if (millis() - startMs >= timeoutMs) {
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(kIdlePollMs));
+  }
+  return true;
 }
 
-void RssRuntime::tick() {
-  if (_suspended || !hasEnabledSources()) {
-    return;
+void RssRuntime::setSegmentNetworkEnabled(bool enabled) {
+  _segmentNetworkEnabled = enabled;
+}
+
+// prefetchNetworkWork() re-checks the flags under the network lock, so once
+// the lock is free with the flag down no producer window can open.
+bool RssRuntime::networkIdle() const {
+  if (_networkMutex == nullptr) {
+    return true;
   }
-  if (!shouldRefreshNow()) {
-    return;
+  if (xSemaphoreTakeRecursive(_networkMutex, 0) != pdTRUE) {
+    return false;
   }
-
-  const bool fetchSuccess = refreshCache();
-  scheduleNextRefresh(fetchSuccess);
+  xSemaphoreGiveRecursive(_networkMutex);
+  return true;
 }
 
-void RssRuntime::forceRefreshSoon() { _nextRefreshMs = millis() + 500; }
+void RssRuntime::forceRefreshSoon() {
+  RecursiveLock lock(_stateMutex);
+  _scheduler.markAllDue(millis() + 500);
+}
 
 bool RssRuntime::hasEnabledSources() const { return _sourceCount > 0; }
 
 bool RssRuntime::hasCachedContent() const {
+  RecursiveLock lock(_stateMutex);
   for (size_t i = 0; i < _sourceCount; i++) {
     if (_cache.hasItems(_sources[i].url)) {
       return true;
@@ -168,15 +313,20 @@ bool RssRuntime::hasCachedContent() const {
 bool RssRuntime::cacheReady() const { return _cacheReady; }
 
 bool RssRuntime::refreshAllNow() {
-  const bool success = refreshCache();
-  scheduleNextRefresh(success);
-  return success;
+  RecursiveLock networkLock(_networkMutex);
+  {
+    RecursiveLock lock(_stateMutex);
+    _scheduler.markAllDue(millis());
+  }
+  return refreshCache();
 }
 
 void RssRuntime::queueStartupWeather() {
+  RecursiveLock lock(_stateMutex);
   _pendingStartupWeather = true;
   _haveCurrentItem = false;
   _showTitleNext = true;
+  invalidateLookahead();
 }
 
 bool RssRuntime::nextSegment(String& outText, uint8_t& outR, uint8_t& outG,
@@ -185,6 +335,182 @@ bool RssRuntime::nextSegment(String& outText, uint8_t& outR, uint8_t& outG,
     return false;
   }
 
+  if (_segmentQueue == nullptr || _producerTask == nullptr) {
+    // No producer: build inline, letting an ordered-source refresh run first.
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+      prefetchNetworkWork();
+      RecursiveLock lock(_stateMutex);
+      if (buildScoreUpdate(outText, outR, outG, outB) ||
+          buildSegment(outText, outR, outG, outB)) {
+        PlaybackCheckpoint checkpoint;
+        capturePlayback(checkpoint);
+        _playbackStore.record(checkpoint);
+        _playbackStore.flushDue(millis());
+        return true;
+      }
+      if (!_orderedRefreshRequested) {
+        break;
+      }
+    }
+    return false;
+  }
+
+  const uint32_t startUs = micros();
+  QueuedSegment segment;
+  bool ready = false;
+  while (xQueueReceive(_segmentQueue, &segment, pdMS_TO_TICKS(kDequeueWaitMs)) ==
+         pdTRUE) {
+    if (segment.generation == _segmentGeneration) {
+      ready = true;
+      break;
+    }
+  }
+  xTaskNotifyGive(_producerTask);
+
+  _lastDequeueUs = micros() - startUs;
+  if (_lastDequeueUs > _maxDequeueUs) {
+    _maxDequeueUs = _lastDequeueUs;
+  }
+  if (!ready) {
+    _segmentUnderruns++;
+    return false;
+  }
+
+  _segmentsServed++;
+  _playbackStore.record(segment.checkpoint);
+  outText = segment.text;
+  outR = segment.r;
+  outG = segment.g;
+  outB = segment.b;
+  return true;
+}
+
+void RssRuntime::pipelineStats(RssPipelineStats& outStats) const {
+  outStats.queued = _segmentQueue != nullptr
+                        ? static_cast<uint8_t>(uxQueueMessagesWaiting(_segmentQueue))
+                        : 0;
+  outStats.capacity = _producerTask != nullptr ? kLookaheadSegments : 0;
+  outStats.served = _segmentsServed;
+  outStats.underruns = _segmentUnderruns;
+  outStats.lastDequeueUs = _lastDequeueUs;
+  outStats.maxDequeueUs = _maxDequeueUs;
+  outStats.lastBuildMs = _lastBuildMs;
+  outStats.maxBuildMs = _maxBuildMs;
+  RecursiveLock lock(_stateMutex);
+  outStats.liveItems = static_cast<uint16_t>(_scoreBoard.liveCount());
+  outStats.pendingScoreUpdates = _pendingScoreCount;
+  outStats.scoreUpdates = _scoreUpdates;
+  outStats.retryBudgetLeft = _retryBudget;
+  outStats.breakerSkips = _breakerSkips;
+}
+
+void RssRuntime::producerTask(void* param) {
+  static_cast<RssRuntime*>(param)->producerLoop();
+}
+
+// Keeps up to kLookaheadSegments ready. Network work happens in
+// prefetchNetworkWork() without the state lock; building from cache is quick.
+void RssRuntime::producerLoop() {
+  while (true) {
+    if (_suspended) {
+      _producerParked = true;
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kProducerIdleMs));
+      continue;
+    }
+    _producerParked = false;
+    if (!hasEnabledSources() || uxQueueSpacesAvailable(_segmentQueue) == 0) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kProducerIdleMs));
+      continue;
+    }
+
+    const bool windowRan = prefetchNetworkWork();
+
+    const uint32_t startMs = millis();
+    QueuedSegment segment = {};
+    String text;
+    bool built = false;
+    bool urgent = false;
+    bool refreshRequested = false;
+    {
+      RecursiveLock lock(_stateMutex);
+      segment.generation = _segmentGeneration;
+      urgent = buildScoreUpdate(text, segment.r, segment.g, segment.b);
+      built = urgent || buildSegment(text, segment.r, segment.g, segment.b);
+      refreshRequested = _orderedRefreshRequested;
+      if (built) {
+        capturePlayback(segment.checkpoint);
+      }
+    }
+
+    if (!built) {
+      // Retry at once only if the requested refresh just had its window. A
+      // deferred window (e.g. config-mode join still running) would otherwise
+      // spin this task on core 0 until the join ends.
+      if (!refreshRequested || !windowRan) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kProducerIdleMs));
+      }
+      continue;
+    }
+
+    _lastBuildMs = millis() - startMs;
+    if (_lastBuildMs > _maxBuildMs) {
+      _maxBuildMs = _lastBuildMs;
+    }
+    strlcpy(segment.text, text.c_str(), sizeof(segment.text));
+    if (segment.generation == _segmentGeneration) {
+      // Score changes jump the lookahead so they play before the next headline.
+      if (urgent) {
+        xQueueSendToFront(_segmentQueue, &segment, 0);
+      } else {
+        xQueueSend(_segmentQueue, &segment, 0);
+      }
+    }
+    _playbackStore.flushDue(millis());
+  }
+}
+
+// Hands due network work to the radio broker, which batches sources, weather
+// and NTP into one wake window ahead of the segments that need them. Returns
+// false when no window ran: nothing was due, or the window was deferred.
+bool RssRuntime::prefetchNetworkWork() {
+  if (!_segmentNetworkEnabled || _suspended) {
+    return false;
+  }
+  RecursiveLock networkLock(_networkMutex);
+  if (!_segmentNetworkEnabled || _suspended) {
+    return false;
+  }
+
+  {
+    RecursiveLock lock(_stateMutex);
+    _orderedRefreshRequested = false;
+    _clock.poll();
+  }
+  const uint32_t nowMs = millis();
+  submitNetworkJobs(nowMs);
+  if (!_radioBroker.windowDue(nowMs)) {
+    return false;
+  }
+  _producerWindow = true;
+  _radioBroker.runWindow();
+  _producerWindow = false;
+  RecursiveLock lock(_stateMutex);
+  _cacheReady = hasCachedContent();
+  return true;
+}
+
+void RssRuntime::invalidateLookahead() {
+  _segmentGeneration++;
+  if (_segmentQueue != nullptr) {
+    xQueueReset(_segmentQueue);
+  }
+  if (_producerTask != nullptr) {
+    xTaskNotifyGive(_producerTask);
+  }
+}
+
+bool RssRuntime::buildSegment(String& outText, uint8_t& outR, uint8_t& outG,
+                              uint8_t& outB) {
   if (!_haveCurrentItem && _pendingStartupWeather) {
     if (buildWeatherMessage(outText)) {
       outR = 255;
@@ -208,12 +534,9 @@ bool RssRuntime::nextSegment(String& outText, uint8_t& outR, uint8_t& outG,
   }
 
   colorForSource(_currentColorIndex, outR, outG, outB);
-  bool singleSegment = false;
-  if (_currentSourceIndex < _sourceCount) {
-    String sourceUrl = _sources[_currentSourceIndex].url;
-    sourceUrl.toLowerCase();
-    singleSegment = sourceUrl.indexOf("sport=") >= 0;
-  }
+  const bool singleSegment =
+      _currentSourceIndex < _sourceCount &&
+      _sources[_currentSourceIndex].displayMode == RssDisplayMode::SingleSegment;
 
   if (_showTitleNext) {
     outText = (_currentItem.title[0] != '\0') ? _currentItem.title : "(no title)";
@@ -246,105 +569,226 @@ const RssSource* RssRuntime::sources() const { return _sources; }
 
 bool RssRuntime::sourceMetadata(size_t sourceIndex,
                                 RssCacheMetadata& outMetadata) const {
+  RecursiveLock lock(_stateMutex);
   if (sourceIndex >= _sourceCount) {
     return false;
   }
   return _cache.metadata(_sources[sourceIndex].url, outMetadata);
 }
 
-bool RssRuntime::shouldRefreshNow() const {
-  return static_cast<int32_t>(millis() - _nextRefreshMs) >= 0;
+size_t RssRuntime::hostBreakerCount() const {
+  RecursiveLock lock(_stateMutex);
+  return _hostBreaker.count();
+}
+
+bool RssRuntime::hostBreakerEntry(size_t index, RssHostBreakerEntry& outEntry) const {
+  RecursiveLock lock(_stateMutex);
+  return _hostBreaker.entry(index, outEntry);
+}
+
+void RssRuntime::cacheStats(RssCacheStats& outStats) const {
+  RecursiveLock lock(_stateMutex);
+  _cache.stats(outStats);
+}
+
+void RssRuntime::clockStats(ClockStats& outStats) const {
+  RecursiveLock lock(_stateMutex);
+  _clock.stats(outStats);
+}
+
+void RssRuntime::playbackStats(PlaybackStats& outStats) const {
+  _playbackStore.stats(outStats);
+  outStats.resumed = _playbackResumed;
 }
 
-void RssRuntime::scheduleNextRefresh(bool success) {
-  _nextRefreshMs = millis() + (success ? kRefreshIntervalMs : kRefreshRetryMs);
+bool RssRuntime::sourceSchedule(size_t sourceIndex,
+                                RssSourceSchedule& outSchedule) const {
+  RecursiveLock lock(_stateMutex);
+  return _scheduler.entry(sourceIndex, outSchedule);
 }
 
-void RssRuntime::rebuildSources(const AppSettings& settings) {
+// Returns true when the list of source URLs changed (always on the first
+// build); only then are the schedule, host breakers and scoreboard reset.
+bool RssRuntime::rebuildSources(const AppSettings& settings) {
+  const uint32_t previousHash = sourcesHash();
   _sourceCount = buildRssSources(settings, _sources, APP_MAX_RSS_SOURCES);
   _randomEnabled = settings.rssRandomEnabled;
+  _livePriorityEnabled = settings.rssLivePriorityEnabled;
+  if (!buildRssSportsBatchUrl(settings, _sources, _sourceCount, _sportsBatchUrl,
+                              sizeof(_sportsBatchUrl))) {
+    // No usable batch URL: every source falls back to its own request.
+    for (size_t i = 0; i < _sourceCount; i++) {
+      _sources[i].batched = false;
+    }
+  }
+  _scheduler.setLivePriority(_livePriorityEnabled);
+  if (_sourcesGeneration != 0 && sourcesHash() == previousHash) {
+    return false;
+  }
+  _sourcesGeneration++;
+  _scheduler.reset(_sourceCount, millis() + kFirstRefreshDelayMs);
+  _scoreBoard.reset();
+  _hostBreaker.reset();
+  _pendingScoreCount = 0;
+  _headlinesSinceLive = 0;
+  return true;
 }
 
 bool RssRuntime::refreshCache() {
+  RecursiveLock networkLock(_networkMutex);
   if (_sourceCount == 0) {
     _cacheReady = false;
     return false;
   }
 
-  const AppSettings& settings = _settingsStore.settings();
+  const bool wasReady = _cacheReady;
+  _windowRefreshed = false;
+  submitNetworkJobs(millis());
+  _radioBroker.runWindow();
 
-  // In config mode we keep current radio state stable so web UI stays reachable.
-  if (!_radioControlEnabled) {
-    if (_wifiService.mode() != WifiRuntimeMode::StaConnected) {
-      _cacheReady = hasCachedContent();
-      return false;
-    }
-    trySyncClockFromNtp(false);
-    const bool weatherFetched = refreshWeather();
+  RecursiveLock lock(_stateMutex);
+  _cacheReady = hasCachedContent();
+  // Sources refresh independently now, so only restart playback when the
+  // first content lands; otherwise the ordered walk would keep rewinding.
+  if (_cacheReady && !wasReady) {
+    resetPlayback();
+  }
+  return _windowRefreshed;
+}
 
-    bool fetchedAny = false;
-    for (size_t i = 0; i < _sourceCount; i++) {
-      const RssFetchResult result = _fetcher.fetch(
-          _sources[i].url, _fetchItems, APP_MAX_RSS_ITEMS, 3, 10000, 750);
-      if (!result.success || result.itemCount == 0) {
-        continue;
-      }
-      if (_cache.store(_sources[i].url, _sources[i].name, _fetchItems,
-                       result.itemCount)) {
-        fetchedAny = true;
-      }
-    }
+// Deadlines come from the per-source schedule and the weather/NTP ages; the
+// broker keeps the earliest deadline for a job that is already pending.
+void RssRuntime::submitNetworkJobs(uint32_t nowMs) {
+  RecursiveLock lock(_stateMutex);
+  if (_sourceCount > 0) {
+    _radioBroker.submit("rss", sourcesJob, this,
+                        nowMs + _scheduler.msUntilNextDue(nowMs));
+  }
+  if (kWeatherApiUrl[0] != '\0') {
+    _radioBroker.submit("weather", weatherJob, this, weatherDeadlineMs(nowMs));
+  }
+  _radioBroker.submit("ntp", clockJob, this, clockDeadlineMs(nowMs));
+}
 
-    _cacheReady = hasCachedContent();
-    if (fetchedAny || weatherFetched) {
-      resetPlayback();
-    }
-    return fetchedAny || weatherFetched;
+bool RssRuntime::sourcesJob(bool connected, void* context) {
+  RssRuntime* self = static_cast<RssRuntime*>(context);
+  if (self->windowCancelled()) {
+    return false;
   }
+  const bool refreshed = self->refreshDueSources(connected);
+  if (refreshed) {
+    self->_windowRefreshed = true;
+  }
+  return refreshed;
+}
 
-  if (settings.wifiSsid[0] == '\0') {
-    _cacheReady = hasCachedContent();
+bool RssRuntime::weatherJob(bool connected, void* context) {
+  RssRuntime* self = static_cast<RssRuntime*>(context);
+  if (self->windowCancelled()) {
     return false;
   }
+  if (!connected) {
+    RecursiveLock lock(self->_stateMutex);
+    self->_lastWeatherFetchAttemptMs = millis();
+    return false;
+  }
+  const bool refreshed = self->refreshWeather();
+  if (refreshed) {
+    self->_windowRefreshed = true;
+  }
+  return refreshed;
+}
 
-  if (!_wifiService.connectSta(settings.wifiSsid, settings.wifiPassword, 8000, 2)) {
-    _wifiService.stopWifi();
-    _cacheReady = hasCachedContent();
+// Only sends the request: the reply is applied by poll(), either while the
+// broker holds the window open or on a later segment build.
+bool RssRuntime::clockJob(bool connected, void* context) {
+  RssRuntime* self = static_cast<RssRuntime*>(context);
+  if (self->windowCancelled()) {
+    return false;
+  }
+  RecursiveLock lock(self->_stateMutex);
+  self->_lastClockSyncAttemptMs = millis();
+  if (!connected) {
     return false;
   }
-  trySyncClockFromNtp(false);
-  const bool weatherFetched = refreshWeather();
+  self->_clock.startSync(kNtpServer1, kNtpServer2, kNtpServer3);
+  self->_radioBroker.holdWindow(kClockReplyWaitMs, clockReplyIn, self);
+  return true;
+}
 
-  bool fetchedAny = false;
+bool RssRuntime::clockReplyIn(void* context) {
+  RssRuntime* self = static_cast<RssRuntime*>(context);
+  RecursiveLock lock(self->_stateMutex);
+  self->_clock.poll();
+  return !self->_clock.waiting();
+}
 
-  for (size_t i = 0; i < _sourceCount; i++) {
-    const RssFetchResult result =
-        _fetcher.fetch(_sources[i].url, _fetchItems, APP_MAX_RSS_ITEMS, 3, 10000,
-                       750);
-    if (!result.success || result.itemCount == 0) {
-      continue;
-    }
+// Jobs of a producer window bail out once segment network is disabled or the
+// producer suspended; skipped work stays due. The boot task's refreshAllNow()
+// runs its window to the end.
+bool RssRuntime::windowCancelled() const {
+  return _producerWindow && (!_segmentNetworkEnabled || _suspended);
+}
 
-    if (_cache.store(_sources[i].url, _sources[i].name, _fetchItems,
-                     result.itemCount)) {
-      fetchedAny = true;
-    }
+// Refreshes every source due within the broker's coalescing horizon, so
+// sources that would come due shortly ride along in the same session.
+bool RssRuntime::refreshDueSources(bool connected) {
+  size_t due[APP_MAX_RSS_SOURCES];
+  size_t dueCount = 0;
+  uint32_t generation = 0;
+  {
+    RecursiveLock lock(_stateMutex);
+    dueCount = _scheduler.collectDue(millis() + RadioSessionBroker::kCoalesceMs, due,
+                                     APP_MAX_RSS_SOURCES);
+    generation = _sourcesGeneration;
+    _retryBudget = kRetryBudgetPerCycle;
   }
 
-  _wifiService.stopWifi();
-  _cacheReady = hasCachedContent();
-
-  if (fetchedAny || weatherFetched) {
-    resetPlayback();
+  bool refreshedAny = false;
+  bool batchDone = false;
+  for (size_t i = 0; i < dueCount && !windowCancelled(); i++) {
+    bool batched = false;
+    {
+      RecursiveLock lock(_stateMutex);
+      if (generation != _sourcesGeneration) {
+        // Settings rebuilt the list; the new one is scheduled from scratch.
+        break;
+      }
+      if (!connected || _wifiService.mode() != WifiRuntimeMode::StaConnected) {
+        _scheduler.recordFailure(due[i], millis());
+        continue;
+      }
+      batched = _sources[due[i]].batched;
+    }
+    // One batch request refreshes every batched league, due or not.
+    if (batched) {
+      if (!batchDone && refreshSportsBatch(generation)) {
+        refreshedAny = true;
+      }
+      batchDone = true;
+      continue;
+    }
+    if (refreshSource(due[i], generation)) {
+      refreshedAny = true;
+    }
   }
-  return fetchedAny || weatherFetched;
+  return refreshedAny;
 }
 
 bool RssRuntime::pickNextItem() {
-  if (!_randomEnabled) {
-    return pickNextItemOrdered();
+  if (_livePriorityEnabled && _headlinesSinceLive >= kHeadlinesPerLiveItem &&
+      pickLiveItem()) {
+    _headlinesSinceLive = 0;
+    return true;
+  }
+  const bool picked = _randomEnabled ? pickNextItemRandom() : pickNextItemOrdered();
+  if (picked) {
+    _headlinesSinceLive++;
   }
+  return picked;
+}
 
+bool RssRuntime::pickNextItemRandom() {
   bool cycleReset = false;
   size_t sourceIndex = 0;
   RssItem item = {};
@@ -370,60 +814,216 @@ bool RssRuntime::pickNextItem() {
   return true;
 }
 
-bool RssRuntime::refreshSource(size_t sourceIndex) {
-  if (sourceIndex >= _sourceCount) {
-    return false;
+// Works on a copy of the URL taken under the state lock; every result is
+// dropped if the source list was rebuilt while the request ran.
+bool RssRuntime::refreshSource(size_t sourceIndex, uint32_t generation) {
+  char url[APP_MAX_URL_LEN + 1];
+  {
+    RecursiveLock lock(_stateMutex);
+    if (generation != _sourcesGeneration || sourceIndex >= _sourceCount) {
+      return false;
+    }
+    strlcpy(url, _sources[sourceIndex].url, sizeof(url));
+    Serial.print("[RSS] Refresh source: ");
+    Serial.print(_sources[sourceIndex].name);
+    Serial.print(" -> ");
+    Serial.println(url);
   }
 
-  Serial.print("[RSS] Refresh source: ");
-  Serial.print(_sources[sourceIndex].name);
-  Serial.print(" -> ");
-  Serial.println(_sources[sourceIndex].url);
+  uint8_t attempts = 0;
+  if (!admitFetch(url, attempts)) {
+    RecursiveLock lock(_stateMutex);
+    const uint32_t waitMs = _hostBreaker.msUntilRetry(url, millis());
+    if (generation == _sourcesGeneration) {
+      _scheduler.postpone(sourceIndex,
+                          millis() + (waitMs > 0 ? waitMs : kBreakerRecheckMs));
+    }
+    return false;
+  }
 
-  const RssFetchResult result = _fetcher.fetch(
-      _sources[sourceIndex].url, _fetchItems, APP_MAX_RSS_ITEMS, 3, 10000, 750);
+  const size_t largestBefore = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  const uint32_t minFreeBefore = ESP.getMinFreeHeap();
+  const RssFetchResult result =
+      _fetcher.fetch(url, _fetchItems, APP_MAX_RSS_ITEMS, attempts, 10000, 750);
+  logRefreshHeap(largestBefore, minFreeBefore);
+  logFetchBody(result);
+  settleFetch(url, result);
+  // Items are copied out; drop every per-fetch scratch allocation at once.
+  _scratch.reset();
   if (!result.success || result.itemCount == 0) {
     Serial.print("[RSS] Refresh failed: ");
-    Serial.println(result.error);
+    Serial.print(result.error);
+    Serial.println(result.errorClass == RssFetchError::Permanent ? " (permanent)"
+                                                                 : " (transient)");
+    RecursiveLock lock(_stateMutex);
+    if (generation == _sourcesGeneration) {
+      _scheduler.recordFailure(sourceIndex, millis(),
+                               result.errorClass == RssFetchError::Permanent);
+    }
     return false;
   }
-  const bool stored = _cache.store(_sources[sourceIndex].url, _sources[sourceIndex].name,
-                                   _fetchItems, result.itemCount);
-  Serial.print("[RSS] Refresh ");
-  Serial.print(stored ? "stored " : "store failed ");
-  Serial.print("items=");
-  Serial.print(result.itemCount);
-  Serial.print(" source=");
-  Serial.println(_sources[sourceIndex].name);
-  return stored;
+  return ingestFetchedItems(sourceIndex, generation, result.itemCount);
 }
 
-bool RssRuntime::refreshSourceWithManagedRadio(size_t sourceIndex) {
-  if (sourceIndex >= _sourceCount) {
+// Leagues missing from the response count as failed refreshes so they back
+// off like a failed single-league fetch.
+bool RssRuntime::refreshSportsBatch(uint32_t generation) {
+  char url[APP_MAX_URL_LEN + 1];
+  {
+    RecursiveLock lock(_stateMutex);
+    if (generation != _sourcesGeneration) {
+      return false;
+    }
+    strlcpy(url, _sportsBatchUrl, sizeof(url));
+  }
+  Serial.print("[RSS] Refresh sports batch -> ");
+  Serial.println(url);
+
+  uint8_t attempts = 0;
+  if (!admitFetch(url, attempts)) {
+    RecursiveLock lock(_stateMutex);
+    const uint32_t waitMs = _hostBreaker.msUntilRetry(url, millis());
+    for (size_t i = 0; generation == _sourcesGeneration && i < _sourceCount; i++) {
+      if (_sources[i].batched) {
+        _scheduler.postpone(i, millis() + (waitMs > 0 ? waitMs : kBreakerRecheckMs));
+      }
+    }
     return false;
   }
 
-  if (!_radioControlEnabled) {
-    if (_wifiService.mode() != WifiRuntimeMode::StaConnected) {
-      return false;
+  SportsBatchRefresh batch = {this, generation, 0, false};
+  const size_t largestBefore = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  const uint32_t minFreeBefore = ESP.getMinFreeHeap();
+  const RssFetchResult result =
+      _fetcher.fetchSections(url, _fetchItems, APP_MAX_RSS_ITEMS, onSportsSection,
+                             &batch, attempts, 10000, 750);
+  logRefreshHeap(largestBefore, minFreeBefore);
+  logFetchBody(result);
+  settleFetch(url, result);
+  _scratch.reset();
+  if (!result.success) {
+    Serial.print("[RSS] Batch refresh failed: ");
+    Serial.println(result.error);
+  }
+
+  // A league left out of a good reply just has nothing listed; only a failed
+  // request can be permanent.
+  const bool permanent = !result.success && result.errorClass == RssFetchError::Permanent;
+  RecursiveLock lock(_stateMutex);
+  for (size_t i = 0; generation == _sourcesGeneration && i < _sourceCount; i++) {
+    if (_sources[i].batched && (batch.sectionMask & (1UL << i)) == 0) {
+      _scheduler.recordFailure(i, millis(), permanent);
     }
-    return refreshSource(sourceIndex);
   }
+  return batch.storedAny;
+}
 
-  const AppSettings& settings = _settingsStore.settings();
-  if (settings.wifiSsid[0] == '\0') {
-    return false;
+// Checks the host breaker and sizes the attempt count from what is left of
+// the cycle's retry budget. A half-open probe gets exactly one attempt.
+bool RssRuntime::admitFetch(const char* url, uint8_t& outAttempts) {
+  bool probe = false;
+  uint8_t retries = 0;
+  {
+    RecursiveLock lock(_stateMutex);
+    if (!_hostBreaker.allow(url, millis(), probe)) {
+      _breakerSkips++;
+      Serial.print("[RSS] Breaker open, skipping ");
+      Serial.println(url);
+      return false;
+    }
+    retries = kFetchAttempts - 1 < _retryBudget ? kFetchAttempts - 1 : _retryBudget;
+  }
+  outAttempts = probe ? 1 : static_cast<uint8_t>(1 + retries);
+  if (probe) {
+    Serial.print("[RSS] Breaker probe ");
+    Serial.println(url);
   }
+  return true;
+}
 
-  if (!_wifiService.connectSta(settings.wifiSsid, settings.wifiPassword, 8000, 2)) {
-    _wifiService.stopWifi();
-    return false;
+void RssRuntime::settleFetch(const char* url, const RssFetchResult& result) {
+  const uint8_t retried = result.attempts > 1 ? result.attempts - 1 : 0;
+  RecursiveLock lock(_stateMutex);
+  _retryBudget = retried < _retryBudget ? _retryBudget - retried : 0;
+  _hostBreaker.record(url, !result.success && result.hostFailure, millis());
+}
+
+void RssRuntime::onSportsSection(const char* key, uint16_t itemCount, void* context) {
+  SportsBatchRefresh* batch = static_cast<SportsBatchRefresh*>(context);
+  RssRuntime* self = batch->self;
+  RecursiveLock lock(self->_stateMutex);
+  for (size_t i = 0; batch->generation == self->_sourcesGeneration && i < self->_sourceCount;
+       i++) {
+    const RssSource& source = self->_sources[i];
+    if (!source.batched || (batch->sectionMask & (1UL << i)) != 0 ||
+        strcmp(rssLeagueKey(source.league), key) != 0) {
+      continue;
+    }
+    batch->sectionMask |= 1UL << i;
+    if (self->ingestFetchedItems(i, batch->generation, itemCount)) {
+      batch->storedAny = true;
+    }
+    return;
   }
-  trySyncClockFromNtp(false);
+}
 
-  const bool refreshed = refreshSource(sourceIndex);
-  _wifiService.stopWifi();
-  return refreshed;
+bool RssRuntime::ingestFetchedItems(size_t sourceIndex, uint32_t generation,
+                                    uint16_t itemCount) {
+  bool live = false;
+  const uint32_t contentHash = hashFetchedItems(_fetchItems, itemCount, live);
+  bool changed = true;
+  bool stored = false;
+  RssSourceSchedule schedule = {};
+  char name[APP_RSS_SOURCE_NAME_LEN + 1];
+  {
+    RecursiveLock lock(_stateMutex);
+    if (generation != _sourcesGeneration) {
+      Serial.println("[RSS] Refresh dropped: sources changed during fetch");
+      return false;
+    }
+    strlcpy(name, _sources[sourceIndex].name, sizeof(name));
+    // Only score feeds get the live refresh cadence; news headlines can trip
+    // game markers ("top", "end") without anything changing minute to minute.
+    live = live && _sources[sourceIndex].kind == RssSourceKind::Sport;
+    RssSourceSchedule previous = {};
+    if (_scheduler.entry(sourceIndex, previous) &&
+        _cache.hasItems(_sources[sourceIndex].url)) {
+      // The first check after boot compares against the cached record, so an
+      // unchanged feed keeps it and the no-repeat cycle built on it.
+      uint32_t previousHash = previous.contentHash;
+      if (previous.checks > 0 || hashCachedItems(sourceIndex, previousHash)) {
+        changed = previousHash != contentHash;
+      }
+    }
+    const bool scoreFeed = _sources[sourceIndex].kind == RssSourceKind::Sport;
+    if (changed && scoreFeed && !_scoreBoard.hasSnapshot(sourceIndex)) {
+      // First fetch since boot: diff against what the cache still holds.
+      seedScoreBoard(sourceIndex);
+    }
+    // Unchanged feeds skip the flash write entirely.
+    stored = !changed || _cache.store(_sources[sourceIndex].url,
+                                      _sources[sourceIndex].name, _fetchItems,
+                                      itemCount);
+    if (stored) {
+      if (changed && scoreFeed) {
+        diffScores(sourceIndex, itemCount);
+      }
+      _scheduler.recordSuccess(sourceIndex, millis(), contentHash, live);
+    } else {
+      _scheduler.recordFailure(sourceIndex, millis());
+    }
+    _scheduler.entry(sourceIndex, schedule);
+  }
+  Serial.print("[RSS] Refresh ");
+  Serial.print(!changed ? "unchanged " : (stored ? "stored " : "store failed "));
+  Serial.print("items=");
+  Serial.print(itemCount);
+  Serial.print(live ? " live" : "");
+  Serial.print(" next=");
+  Serial.print(static_cast<uint32_t>(schedule.dueMs - millis()) / 1000UL);
+  Serial.print("s source=");
+  Serial.println(name);
+  return stored;
 }
 
 bool RssRuntime::pickNextItemOrdered() {
@@ -438,32 +1038,31 @@ bool RssRuntime::pickNextItemOrdered() {
     }
     const size_t sourceIndex = _orderedSourceIndex;
 
-    // Mimic rssArduinoPlatform: refresh selected source at start of source cycle
-    // before traversing all its items.
-    if (_orderedItemIndex == 0) {
-      refreshSourceWithManagedRadio(sourceIndex);
-      _cacheReady = hasCachedContent();
+    // Mimic rssArduinoPlatform: refresh the selected source at the start of
+    // its cycle, but only when its schedule says it is due. The producer runs
+    // the fetch outside the state lock, then builds again.
+    if (_orderedItemIndex == 0 && _segmentNetworkEnabled &&
+        _scheduler.isDue(sourceIndex, millis())) {
+      _orderedRefreshRequested = true;
+      return false;
     }
 
     uint32_t count = 0;
     if (!_cache.itemCount(_sources[sourceIndex].url, count) || count == 0) {
-      _orderedSourceIndex = (_orderedSourceIndex + 1) % _sourceCount;
-      _orderedItemIndex = 0;
+      advanceOrderedSource();
       sourceAttempts++;
       continue;
     }
 
     if (_orderedItemIndex >= count) {
-      _orderedSourceIndex = (_orderedSourceIndex + 1) % _sourceCount;
-      _orderedItemIndex = 0;
+      advanceOrderedSource();
       sourceAttempts++;
       continue;
     }
 
     RssItem item = {};
     if (!_cache.loadItem(_sources[sourceIndex].url, _orderedItemIndex, item)) {
-      _orderedSourceIndex = (_orderedSourceIndex + 1) % _sourceCount;
-      _orderedItemIndex = 0;
+      advanceOrderedSource();
       sourceAttempts++;
       continue;
     }
@@ -485,8 +1084,7 @@ bool RssRuntime::pickNextItemOrdered() {
 
     _orderedItemIndex++;
     if (_orderedItemIndex >= count) {
-      _orderedSourceIndex = (_orderedSourceIndex + 1) % _sourceCount;
-      _orderedItemIndex = 0;
+      advanceOrderedSource();
     }
     return true;
   }
@@ -495,6 +1093,149 @@ bool RssRuntime::pickNextItemOrdered() {
   return false;
 }
 
+// Live priority weighting: replays live games from the score board between
+// regular picks without moving the ordered/random cursors.
+bool RssRuntime::pickLiveItem() {
+  size_t sourceIndex = 0;
+  uint32_t itemIndex = 0;
+  RssItem item = {};
+  if (!_scoreBoard.nextLive(sourceIndex, itemIndex) || sourceIndex >= _sourceCount ||
+      !_cache.loadItem(_sources[sourceIndex].url, itemIndex, item)) {
+    return false;
+  }
+
+  _currentItem = item;
+  _currentSourceIndex = sourceIndex;
+  _currentColorIndex = _colorRotationIndex++;
+  _haveCurrentItem = true;
+  _showTitleNext = true;
+  Serial.print("[RSS] Live pick source=");
+  Serial.print(_sources[sourceIndex].name);
+  Serial.print(" title=");
+  Serial.println(_currentItem.title);
+  return true;
+}
+
+void RssRuntime::logRefreshHeap(size_t largestBefore, uint32_t minFreeBefore) const {
+  Serial.print("[RSS] Heap largest_block=");
+  Serial.print(static_cast<uint32_t>(largestBefore));
+  Serial.print("->");
+  Serial.print(static_cast<uint32_t>(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)));
+  Serial.print(" min_free=");
+  Serial.print(minFreeBefore);
+  Serial.print("->");
+  Serial.print(ESP.getMinFreeHeap());
+  Serial.print(" scratch_used=");
+  Serial.print(static_cast<uint32_t>(_scratch.used()));
+  Serial.print(" scratch_peak=");
+  Serial.print(static_cast<uint32_t>(_scratch.highWater()));
+  Serial.print("/");
+  Serial.print(static_cast<uint32_t>(_scratch.capacity()));
+  Serial.print(" heap_fallbacks=");
+  Serial.println(_scratch.fallbackAllocs());
+}
+
+void RssRuntime::logFetchBody(const RssFetchResult& result) const {
+  Serial.print("[RSS] Body wire_bytes=");
+  Serial.print(result.wireBytes);
+  Serial.print(" decoded_bytes=");
+  Serial.print(result.bodyBytes);
+  Serial.print(result.compressed ? " gzip" : " identity");
+  Serial.print(result.digest ? " digest" : "");
+  if (result.sections > 0) {
+    Serial.print(" sections=");
+    Serial.print(result.sections);
+  }
+  Serial.println(result.truncated ? " truncated" : "");
+}
+
+bool RssRuntime::hashCachedItems(size_t sourceIndex, uint32_t& outHash) const {
+  uint32_t count = 0;
+  if (!_cache.itemCount(_sources[sourceIndex].url, count)) {
+    return false;
+  }
+  uint32_t hash = hashItemsBegin(count);
+  RssItem item = {};
+  for (uint32_t i = 0; i < count; i++) {
+    if (!_cache.loadItem(_sources[sourceIndex].url, i, item)) {
+      return false;
+    }
+    hash = hashItemAppend(hash, item);
+  }
+  outHash = hash;
+  return true;
+}
+
+void RssRuntime::seedScoreBoard(size_t sourceIndex) {
+  uint32_t count = 0;
+  if (!_cache.itemCount(_sources[sourceIndex].url, count)) {
+    return;
+  }
+  RssItem item = {};
+  for (uint32_t i = 0; i < count && i < APP_MAX_RSS_ITEMS; i++) {
+    if (_cache.loadItem(_sources[sourceIndex].url, i, item)) {
+      _scoreBoard.seedItem(sourceIndex, i, item);
+    }
+  }
+}
+
+void RssRuntime::diffScores(size_t sourceIndex, size_t itemCount) {
+  uint8_t changed[kMaxPendingScoreUpdates];
+  const size_t changedCount = _scoreBoard.update(
+      sourceIndex, _fetchItems, itemCount, changed, kMaxPendingScoreUpdates);
+  if (!_livePriorityEnabled) {
+    return;
+  }
+  for (size_t i = 0; i < changedCount; i++) {
+    Serial.print("[RSS] Score change source=");
+    Serial.print(_sources[sourceIndex].name);
+    Serial.print(" title=");
+    Serial.println(_fetchItems[changed[i]].title);
+    if (_pendingScoreCount >= kMaxPendingScoreUpdates) {
+      continue;
+    }
+    PendingScoreUpdate& pending = _pendingScores[_pendingScoreCount++];
+    pending.sourceIndex = static_cast<uint8_t>(sourceIndex);
+    pending.itemIndex = changed[i];
+  }
+  if (changedCount > 0 && _producerTask != nullptr) {
+    xTaskNotifyGive(_producerTask);
+  }
+}
+
+bool RssRuntime::buildScoreUpdate(String& outText, uint8_t& outR, uint8_t& outG,
+                                  uint8_t& outB) {
+  while (_pendingScoreCount > 0) {
+    const PendingScoreUpdate pending = _pendingScores[0];
+    _pendingScoreCount--;
+    memmove(_pendingScores, _pendingScores + 1,
+            _pendingScoreCount * sizeof(PendingScoreUpdate));
+
+    RssItem item = {};
+    if (pending.sourceIndex >= _sourceCount ||
+        !_cache.loadItem(_sources[pending.sourceIndex].url, pending.itemIndex, item)) {
+      continue;
+    }
+    outText = "SCORE UPDATE: ";
+    outText += item.title;
+    if (item.description[0] != '\0') {
+      outText += "  ";
+      outText += item.description;
+    }
+    outR = kScoreUpdateColor.r;
+    outG = kScoreUpdateColor.g;
+    outB = kScoreUpdateColor.b;
+    _scoreUpdates++;
+    return true;
+  }
+  return false;
+}
+
+void RssRuntime::advanceOrderedSource() {
+  _orderedSourceIndex = (_orderedSourceIndex + 1) % _sourceCount;
+  _orderedItemIndex = 0;
+}
+
 void RssRuntime::resetPlayback() {
   _haveCurrentItem = false;
   _showTitleNext = true;
@@ -504,16 +1245,70 @@ void RssRuntime::resetPlayback() {
   _currentColorIndex = 0;
   _orderedSourceIndex = 0;
   _orderedItemIndex = 0;
+  _orderedRefreshRequested = false;
   memset(&_currentItem, 0, sizeof(_currentItem));
+  if (_resumePending) {
+    resumePlayback();
+  }
+  invalidateLookahead();
+}
+
+uint32_t RssRuntime::sourcesHash() const {
+  uint32_t hash = 2166136261UL ^ static_cast<uint32_t>(_sourceCount);
+  for (size_t i = 0; i < _sourceCount; i++) {
+    hash = fnv1aAppend(hash, _sources[i].url);
+    hash = fnv1aAppend(hash, "\n");
+  }
+  return hash;
+}
+
+// Taken right after a segment is built, so it already counts that segment.
+void RssRuntime::capturePlayback(PlaybackCheckpoint& outCheckpoint) const {
+  memset(&outCheckpoint, 0, sizeof(outCheckpoint));
+  outCheckpoint.sourcesHash = sourcesHash();
+  outCheckpoint.orderedSourceIndex = static_cast<uint8_t>(_orderedSourceIndex);
+  outCheckpoint.orderedItemIndex = static_cast<uint8_t>(_orderedItemIndex);
+  outCheckpoint.interstitialCursor = _interstitialCursor;
+  outCheckpoint.itemsSinceInterstitial = static_cast<uint8_t>(
+      _itemsSinceInterstitial < UINT8_MAX ? _itemsSinceInterstitial : UINT8_MAX);
+  outCheckpoint.colorRotationIndex = _colorRotationIndex;
+  _cache.cycleSnapshot(outCheckpoint.cycle);
+}
+
+// Cursors only mean something against the same source list; the no-repeat
+// bits additionally need the cached records they were taken against.
+void RssRuntime::resumePlayback() {
+  _resumePending = false;
+  const PlaybackCheckpoint& checkpoint = _resumeCheckpoint;
+  if (checkpoint.sourcesHash != sourcesHash() ||
+      checkpoint.orderedSourceIndex >= _sourceCount) {
+    Serial.println("[PLAYBACK] Sources changed; starting from the top");
+    return;
+  }
+  _orderedSourceIndex = checkpoint.orderedSourceIndex;
+  _orderedItemIndex = checkpoint.orderedItemIndex;
+  _interstitialCursor = checkpoint.interstitialCursor % kInterstitialSlots;
+  _itemsSinceInterstitial = checkpoint.itemsSinceInterstitial;
+  _colorRotationIndex = checkpoint.colorRotationIndex;
+  const bool cycleRestored = _cache.restoreCycle(_sources, _sourceCount, checkpoint.cycle);
+  _playbackResumed = true;
+
+  Serial.print("[PLAYBACK] Resumed ordered=");
+  Serial.print(_orderedSourceIndex);
+  Serial.print("/");
+  Serial.print(_orderedItemIndex);
+  Serial.print(" interstitial=");
+  Serial.print(_interstitialCursor);
+  Serial.println(cycleRestored ? " cycle=restored" : " cycle=fresh");
 }
 
 bool RssRuntime::nextInterstitialSegment(String& outText, uint8_t& outR,
                                          uint8_t& outG, uint8_t& outB) {
   const AppSettings& settings = _settingsStore.settings();
-  constexpr uint8_t kSlotCount = static_cast<uint8_t>(APP_MAX_MESSAGES + 2);
-  for (uint8_t attempt = 0; attempt < kSlotCount; attempt++) {
+  for (uint8_t attempt = 0; attempt < kInterstitialSlots; attempt++) {
     const uint8_t slot = _interstitialCursor;
-    _interstitialCursor = static_cast<uint8_t>((_interstitialCursor + 1) % kSlotCount);
+    _interstitialCursor =
+        static_cast<uint8_t>((_interstitialCursor + 1) % kInterstitialSlots);
 
     if (slot == 0) {
       if (buildTimeMessage(outText)) {
@@ -573,17 +1368,9 @@ bool RssRuntime::nextInterstitialSegment(String& outText, uint8_t& outR,
 }
 
 bool RssRuntime::buildTimeMessage(String& outText) {
-  if (!_clockSynced && _wifiService.mode() == WifiRuntimeMode::StaConnected) {
-    trySyncClockFromNtp(true);
-  }
-
-  if (_clockSynced) {
-    time_t epoch = _clockSyncEpoch;
-    if (_clockSyncMillis != 0) {
-      const uint32_t elapsedMs = millis() - _clockSyncMillis;
-      epoch += static_cast<time_t>(elapsedMs / 1000UL);
-    }
-
+  _clock.poll();
+  if (_clock.synced()) {
+    const time_t epoch = _clock.now();
     struct tm tmLocal = {};
     localtime_r(&epoch, &tmLocal);
 
@@ -598,21 +1385,13 @@ bool RssRuntime::buildTimeMessage(String& outText) {
   return true;
 }
 
+// Weather is fetched ahead of time by prefetchNetworkWork().
 bool RssRuntime::buildWeatherMessage(String& outText) {
-  const uint32_t nowMs = millis();
-  const bool stale = !_weatherReady ||
-                     (_weatherLastFetchMs != 0 &&
-                      static_cast<uint32_t>(nowMs - _weatherLastFetchMs) >=
-                          kWeatherRefreshMs);
-  const bool retryAllowed =
-      (_lastWeatherFetchAttemptMs == 0) ||
-      (static_cast<uint32_t>(nowMs - _lastWeatherFetchAttemptMs) >= kWeatherRetryMs);
-
-  if (stale && retryAllowed) {
-    refreshWeatherWithManagedRadio();
+  if (!_weatherReady && !_segmentNetworkEnabled) {
+    return false;
   }
 
-  outText = _weatherReady ? _weatherMessage : String("Weather unavailable");
+  outText = _weatherReady ? String(_weatherMessage) : String("Weather unavailable");
   return true;
 }
 
@@ -626,8 +1405,11 @@ bool RssRuntime::refreshWeather() {
   }
 
   _lastWeatherFetchAttemptMs = millis();
-  WiFiClientSecure client;
-  client.setInsecure();
+  WiFiClient plainClient;
+  WiFiClientSecure secureClient;
+  secureClient.setInsecure();
+  WiFiClient& client =
+      strncmp(kWeatherApiUrl, "https://", 8) == 0 ? secureClient : plainClient;
 
   HTTPClient http;
   http.setTimeout(10000);
@@ -644,44 +1426,50 @@ bool RssRuntime::refreshWeather() {
     return false;
   }
 
-  String payload = http.getString();
+  // The body streams through the extractor in network-sized chunks; nothing
+  // but the wanted fields (and a small JSON body) is ever held.
+  WeatherExtractor extractor;
+  http.writeToStream(&extractor);
   http.end();
-  if (payload.length() == 0) {
+  if (extractor.received() == 0) {
     Serial.println("[WEATHER] Empty payload");
     return false;
   }
 
-  String city;
-  String temp;
-  String humidity;
-  String pressure;
-  String windSpeed;
-  String windDirection;
-  String clouds;
-  extractXmlAttribute(payload, "city", "name", city);
-  extractXmlAttribute(payload, "temperature", "value", temp);
-  extractXmlAttribute(payload, "humidity", "value", humidity);
-  extractXmlAttribute(payload, "pressure", "value", pressure);
-  extractXmlAttribute(payload, "speed", "value", windSpeed);
-  extractXmlAttribute(payload, "direction", "name", windDirection);
-  extractXmlAttribute(payload, "clouds", "name", clouds);
-
-  String message;
-  appendWeatherPart(message, "Weather for ", city, " Michigan ...The Prison City... ");
-  appendWeatherPart(message, "Current Tempurature: ", temp, "F ");
-  appendWeatherPart(message, "Humidity ", humidity, "% ");
-  appendWeatherPart(message, "Pressure ", pressure, " kpa ");
-  appendWeatherPart(message, "Wind ", windSpeed, " mph");
-  appendWeatherPart(message, " from the ", windDirection, "  ");
-  appendWeatherPart(message, " .... ", clouds, "....");
-
-  message.trim();
-  if (message.length() == 0) {
+  ScratchJsonAllocator allocator(_scratch);
+  const bool parsed = extractor.finish(_scratch.reserved() ? &allocator : nullptr);
+  _scratch.reset();
+  Serial.print("[WEATHER] Body bytes=");
+  Serial.print(extractor.received());
+  Serial.print(extractor.format() == WeatherExtractor::Format::Json ? " json" : " xml");
+  Serial.println(extractor.truncated() ? " truncated" : "");
+
+  char message[kWeatherMessageLen + 1] = {};
+  size_t used = 0;
+  appendWeatherPart(message, sizeof(message), used, "Weather for ",
+                    extractor.value(WeatherField::City), " Michigan ...The Prison City... ");
+  appendWeatherPart(message, sizeof(message), used, "Current Tempurature: ",
+                    extractor.value(WeatherField::Temperature), "F ");
+  appendWeatherPart(message, sizeof(message), used, "Humidity ",
+                    extractor.value(WeatherField::Humidity), "% ");
+  appendWeatherPart(message, sizeof(message), used, "Pressure ",
+                    extractor.value(WeatherField::Pressure), " kpa ");
+  appendWeatherPart(message, sizeof(message), used, "Wind ",
+                    extractor.value(WeatherField::WindSpeed), " mph");
+  appendWeatherPart(message, sizeof(message), used, " from the ",
+                    extractor.value(WeatherField::WindDirection), "  ");
+  appendWeatherPart(message, sizeof(message), used, " .... ",
+                    extractor.value(WeatherField::Clouds), "....");
+  while (used > 0 && message[used - 1] == ' ') {
+    message[--used] = '\0';
+  }
+  if (!parsed || used == 0) {
     Serial.println("[WEATHER] Parse failed");
     return false;
   }
 
-  _weatherMessage = message;
+  RecursiveLock lock(_stateMutex);
+  memcpy(_weatherMessage, message, used + 1);
   _weatherReady = true;
   _weatherLastFetchMs = millis();
   Serial.print("[WEATHER] Updated: ");
@@ -689,70 +1477,31 @@ bool RssRuntime::refreshWeather() {
   return true;
 }
 
-bool RssRuntime::refreshWeatherWithManagedRadio() {
-  if (!_radioControlEnabled) {
-    if (_wifiService.mode() != WifiRuntimeMode::StaConnected) {
-      return false;
-    }
-    return refreshWeather();
+uint32_t RssRuntime::weatherDeadlineMs(uint32_t nowMs) const {
+  if (_lastWeatherFetchAttemptMs == 0) {
+    return nowMs;
   }
-
-  const AppSettings& settings = _settingsStore.settings();
-  if (settings.wifiSsid[0] == '\0') {
-    return false;
+  const uint32_t retryMs = _lastWeatherFetchAttemptMs + kWeatherRetryMs;
+  if (!_weatherReady) {
+    return retryMs;
   }
+  return laterOf(_weatherLastFetchMs + kWeatherRefreshMs, retryMs);
+}
 
-  if (!_wifiService.connectSta(settings.wifiSsid, settings.wifiPassword, 8000, 2)) {
-    _wifiService.stopWifi();
-    return false;
+uint32_t RssRuntime::clockDeadlineMs(uint32_t nowMs) const {
+  if (!_clock.synced()) {
+    // Unsynced NTP rides along with other work first and only forces its own
+    // window after the coalescing horizon.
+    const uint32_t baseMs =
+        _lastClockSyncAttemptMs == 0 ? nowMs : _lastClockSyncAttemptMs;
+    return baseMs + RadioSessionBroker::kCoalesceMs;
   }
-  trySyncClockFromNtp(false);
-  const bool refreshed = refreshWeather();
-  _wifiService.stopWifi();
-  return refreshed;
+  return laterOf(nowMs + _clock.msUntilResync(nowMs),
+                 _lastClockSyncAttemptMs + kClockSyncRetryMs);
 }
 
 void RssRuntime::markItemDisplayed() { _itemsSinceInterstitial++; }
 
-void RssRuntime::trySyncClockFromNtp(bool force) {
-  if (_wifiService.mode() != WifiRuntimeMode::StaConnected) {
-    return;
-  }
-
-  const uint32_t nowMs = millis();
-  if (!force) {
-    if (_lastClockSyncAttemptMs != 0 &&
-        static_cast<uint32_t>(nowMs - _lastClockSyncAttemptMs) < kClockSyncRetryMs) {
-      return;
-    }
-    if (_clockSynced &&
-        static_cast<uint32_t>(nowMs - _clockSyncMillis) < kClockResyncMs) {
-      return;
-    }
-  }
-
-  _lastClockSyncAttemptMs = nowMs;
-  configTzTime(kEasternTz, kNtpServer1, kNtpServer2, kNtpServer3);
-
-  struct tm tmInfo = {};
-  if (!getLocalTime(&tmInfo, 2500)) {
-    Serial.println("[NTP] Sync failed");
-    return;
-  }
-
-  const time_t nowEpoch = time(nullptr);
-  if (nowEpoch <= 0) {
-    Serial.println("[NTP] Sync failed: invalid epoch");
-    return;
-  }
-
-  _clockSynced = true;
-  _clockSyncEpoch = nowEpoch;
-  _clockSyncMillis = millis();
-  Serial.print("[NTP] Sync ok epoch=");
-  Serial.println(static_cast<long>(_clockSyncEpoch));
-}
-
 void RssRuntime::colorForSource(size_t sourceIndex, uint8_t& outR, uint8_t& outG,
                                 uint8_t& outB) const {
   const ColorTriplet& c = kSourceColors[sourceIndex % (sizeof(kSourceColors) /
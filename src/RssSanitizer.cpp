@@ -2,6 +2,7 @@
 
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
 namespace {
 struct EntityMap {
@@ -29,20 +30,32 @@ constexpr EntityMap kEntityTable[] = {
     {"&deg;", "deg"},
 };
 
-String stripCdata(const String& input) {
-  String out = input;
-  out.replace("<![CDATA[", "");
-  out.replace("]]>", "");
-  return out;
+size_t stripCdata(char* text, size_t length) {
+  static const char kOpen[] = "<![CDATA[";
+  static const char kClose[] = "]]>";
+  size_t w = 0;
+  size_t i = 0;
+  while (i < length) {
+    if (length - i >= sizeof(kOpen) - 1 &&
+        memcmp(text + i, kOpen, sizeof(kOpen) - 1) == 0) {
+      i += sizeof(kOpen) - 1;
+      continue;
+    }
+    if (length - i >= sizeof(kClose) - 1 &&
+        memcmp(text + i, kClose, sizeof(kClose) - 1) == 0) {
+      i += sizeof(kClose) - 1;
+      continue;
+    }
+    text[w++] = text[i++];
+  }
+  return w;
 }
 
-String stripHtmlTags(const String& input) {
-  String out;
-  out.reserve(input.length());
-
+size_t stripHtmlTags(char* text, size_t length) {
+  size_t w = 0;
   bool inTag = false;
-  for (size_t i = 0; i < input.length(); i++) {
-    const char ch = input[i];
+  for (size_t i = 0; i < length; i++) {
+    const char ch = text[i];
     if (ch == '<') {
       inTag = true;
       continue;
@@ -52,123 +65,118 @@ String stripHtmlTags(const String& input) {
       continue;
     }
     if (!inTag) {
-      out += ch;
+      text[w++] = ch;
     }
   }
-  return out;
+  return w;
 }
 
-bool decodeNumericEntity(const String& entity, String& replacement) {
-  if (!entity.startsWith("&#") || !entity.endsWith(";")) {
-    return false;
+// `entity` spans "&...;" (entityLen bytes, not NUL-terminated).
+const char* decodeNumericEntity(const char* entity, size_t entityLen, char* scratch) {
+  if (entityLen < 4 || entity[1] != '#') {
+    return nullptr;
   }
 
-  String body = entity.substring(2, entity.length() - 1);
+  size_t pos = 2;
   int base = 10;
-  if (body.startsWith("x") || body.startsWith("X")) {
+  if (entity[pos] == 'x' || entity[pos] == 'X') {
     base = 16;
-    body.remove(0, 1);
+    pos++;
   }
-  if (body.length() == 0) {
-    return false;
+  char digits[12];
+  const size_t digitLen = entityLen - 1 - pos;
+  if (digitLen == 0 || digitLen >= sizeof(digits)) {
+    return nullptr;
   }
+  memcpy(digits, entity + pos, digitLen);
+  digits[digitLen] = '\0';
 
-  long codepoint = strtol(body.c_str(), nullptr, base);
+  const long codepoint = strtol(digits, nullptr, base);
   if (codepoint >= 32 && codepoint <= 126) {
-    replacement = static_cast<char>(codepoint);
-    return true;
+    scratch[0] = static_cast<char>(codepoint);
+    scratch[1] = '\0';
+    return scratch;
   }
 
   // Common UTF-8 punctuation codepoints mapped to display-safe ASCII.
   switch (codepoint) {
     case 0x2013:
     case 0x2014:
-      replacement = "-";
-      return true;
+      return "-";
     case 0x2018:
     case 0x2019:
-      replacement = "'";
-      return true;
+      return "'";
     case 0x201C:
     case 0x201D:
-      replacement = "\"";
-      return true;
+      return "\"";
     case 0x2022:
-      replacement = "*";
-      return true;
+      return "*";
     case 0x2026:
-      replacement = "...";
-      return true;
+      return "...";
     default:
-      replacement = "?";
-      return true;
+      return "?";
   }
 }
 
-String decodeEntities(const String& input) {
-  String out;
-  out.reserve(input.length());
-
+// Every replacement is shorter than its entity, so decoding works in place.
+size_t decodeEntities(char* text, size_t length) {
+  size_t w = 0;
   size_t i = 0;
-  while (i < input.length()) {
-    if (input[i] != '&') {
-      out += input[i++];
+  while (i < length) {
+    if (text[i] != '&') {
+      text[w++] = text[i++];
       continue;
     }
 
-    const int semi = input.indexOf(';', i);
-    if (semi < 0 || (semi - static_cast<int>(i)) > 12) {
-      out += input[i++];
+    const char* semi = static_cast<const char*>(memchr(text + i, ';', length - i));
+    const size_t entityLen = semi != nullptr ? static_cast<size_t>(semi - (text + i)) + 1 : 0;
+    if (semi == nullptr || entityLen > 13) {
+      text[w++] = text[i++];
       continue;
     }
 
-    const String candidate = input.substring(i, semi + 1);
-    String decoded;
-    bool matched = false;
-
+    const char* decoded = nullptr;
     for (const EntityMap& entry : kEntityTable) {
-      if (candidate.equals(entry.entity)) {
+      if (strlen(entry.entity) == entityLen &&
+          memcmp(entry.entity, text + i, entityLen) == 0) {
         decoded = entry.replacement;
-        matched = true;
         break;
       }
     }
-
-    if (!matched) {
-      matched = decodeNumericEntity(candidate, decoded);
+    char scratch[2];
+    if (decoded == nullptr) {
+      decoded = decodeNumericEntity(text + i, entityLen, scratch);
     }
 
-    if (matched) {
-      out += decoded;
-      i = static_cast<size_t>(semi + 1);
+    if (decoded != nullptr) {
+      i += entityLen;
+      while (*decoded != '\0') {
+        text[w++] = *decoded++;
+      }
     } else {
-      out += input[i++];
+      text[w++] = text[i++];
     }
   }
-
-  return out;
+  return w;
 }
 
-String utf8ToDisplayAscii(const String& input) {
-  String out;
-  out.reserve(input.length());
-
-  bool lastWasSpace = false;
-  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(input.c_str());
+size_t utf8ToDisplayAscii(char* text, size_t length) {
+  uint8_t* bytes = reinterpret_cast<uint8_t*>(text);
+  size_t w = 0;
   size_t i = 0;
-  const size_t len = input.length();
+  bool lastWasSpace = false;
 
-  while (i < len) {
+  while (i < length) {
     const uint8_t b0 = bytes[i];
 
     if (b0 >= 32 && b0 <= 126) {
       if (b0 == ' ') {
         if (!lastWasSpace) {
-          out += ' ';
+          text[w++] = ' ';
           lastWasSpace = true;
         }
       } else {
-        out += static_cast<char>(b0);
+        text[w++] = static_cast<char>(b0);
         lastWasSpace = false;
       }
       i++;
@@ -180,7 +188,7 @@ String utf8ToDisplayAscii(const String& input) {
       continue;
     }
 
-    int seqLen = 0;
+    size_t seqLen = 0;
     if ((b0 & 0xE0) == 0xC0) {
       seqLen = 2;
     } else if ((b0 & 0xF0) == 0xE0) {
@@ -192,41 +200,69 @@ String utf8ToDisplayAscii(const String& input) {
       continue;
     }
 
-    if (i + static_cast<size_t>(seqLen - 1) >= len) {
+    if (i + seqLen - 1 >= length) {
       break;
     }
 
     if (seqLen == 3 && b0 == 0xE2 && bytes[i + 1] == 0x80) {
       const uint8_t b2 = bytes[i + 2];
       if (b2 == 0x93 || b2 == 0x94) {
-        out += '-';
+        text[w++] = '-';
       } else if (b2 == 0x98 || b2 == 0x99) {
-        out += '\'';
+        text[w++] = '\'';
       } else if (b2 == 0x9C || b2 == 0x9D) {
-        out += '"';
+        text[w++] = '"';
       } else if (b2 == 0xA2) {
-        out += '*';
+        text[w++] = '*';
       } else if (b2 == 0xA6) {
-        out += "...";
+        // Three output bytes for a three-byte sequence: still in place.
+        text[w++] = '.';
+        text[w++] = '.';
+        text[w++] = '.';
       }
       lastWasSpace = false;
     }
 
-    i += static_cast<size_t>(seqLen);
+    i += seqLen;
   }
+  return w;
+}
 
-  out.trim();
-  return out;
+size_t trimSpaces(char* text, size_t length) {
+  size_t start = 0;
+  while (start < length && isspace(static_cast<unsigned char>(text[start]))) {
+    start++;
+  }
+  while (length > start && isspace(static_cast<unsigned char>(text[length - 1]))) {
+    length--;
+  }
+  if (start > 0) {
+    memmove(text, text + start, length - start);
+  }
+  return length - start;
 }
 }  // namespace
 
-String sanitizeRssText(const String& input) {
-  String out = stripCdata(input);
-  out = decodeEntities(out);
-  out = stripHtmlTags(out);
+size_t sanitizeRssTextInPlace(char* text, size_t length) {
+  if (text == nullptr) {
+    return 0;
+  }
+  length = stripCdata(text, length);
+  length = decodeEntities(text, length);
+  length = stripHtmlTags(text, length);
   // Run entity decode again in case stripping exposed nested encodings.
-  out = decodeEntities(out);
-  out = utf8ToDisplayAscii(out);
-  out.trim();
+  length = decodeEntities(text, length);
+  length = utf8ToDisplayAscii(text, length);
+  length = trimSpaces(text, length);
+  text[length] = '\0';
+  return length;
+}
+
+String sanitizeRssText(const String& input) {
+  String out = input;
+  if (out.length() == 0) {
+    return out;
+  }
+  out.remove(sanitizeRssTextInPlace(&out[0], out.length()));
   return out;
 }
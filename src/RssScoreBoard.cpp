@@ -0,0 +1,138 @@
+#include "RssScoreBoard.h"
+
+#include <string.h>
+
+namespace {
+constexpr uint32_t kFnvOffset = 2166136261UL;
+constexpr uint32_t kFnvPrime = 16777619UL;
+constexpr uint8_t kScoredStates = RssItemFlagLive | RssItemFlagFinal;
+}  // namespace
+
+RssScoreBoard::RssScoreBoard()
+    : _entries{}, _counts{}, _seeded{}, _liveSource(0), _liveItem(0) {}
+
+void RssScoreBoard::reset() {
+  memset(_counts, 0, sizeof(_counts));
+  memset(_seeded, 0, sizeof(_seeded));
+  _liveSource = 0;
+  _liveItem = 0;
+}
+
+bool RssScoreBoard::hasSnapshot(size_t sourceIndex) const {
+  return sourceIndex < APP_MAX_RSS_SOURCES && _seeded[sourceIndex];
+}
+
+void RssScoreBoard::seedItem(size_t sourceIndex, size_t itemIndex,
+                             const RssItem& item) {
+  if (sourceIndex >= APP_MAX_RSS_SOURCES || itemIndex >= APP_MAX_RSS_ITEMS) {
+    return;
+  }
+  Entry& e = _entries[sourceIndex][itemIndex];
+  hashTitle(item.title, e.game, e.score);
+  e.flags = item.flags;
+  if (itemIndex >= _counts[sourceIndex]) {
+    _counts[sourceIndex] = static_cast<uint8_t>(itemIndex + 1);
+  }
+  _seeded[sourceIndex] = true;
+}
+
+size_t RssScoreBoard::update(size_t sourceIndex, const RssItem* items,
+                             size_t itemCount, uint8_t* outChanged,
+                             size_t maxChanged) {
+  if (sourceIndex >= APP_MAX_RSS_SOURCES || items == nullptr) {
+    return 0;
+  }
+  if (itemCount > APP_MAX_RSS_ITEMS) {
+    itemCount = APP_MAX_RSS_ITEMS;
+  }
+
+  Entry* entries = _entries[sourceIndex];
+  const bool diff = _seeded[sourceIndex];
+  const size_t previousCount = _counts[sourceIndex];
+  Entry previous[APP_MAX_RSS_ITEMS];
+  memcpy(previous, entries, previousCount * sizeof(Entry));
+
+  size_t changed = 0;
+  for (size_t i = 0; i < itemCount; i++) {
+    Entry& e = entries[i];
+    hashTitle(items[i].title, e.game, e.score);
+    e.flags = items[i].flags;
+    if (!diff || (e.flags & kScoredStates) == 0 || changed >= maxChanged) {
+      continue;
+    }
+    // Feeds keep game order between fetches, so try the same slot first.
+    for (size_t n = 0; n < previousCount; n++) {
+      const Entry& old = previous[(i + n) % previousCount];
+      if (old.game == e.game) {
+        // A scheduled game's digits are its start time, not a score, so the
+        // first scored fetch of a game is not a change.
+        if ((old.flags & kScoredStates) != 0 && old.score != e.score) {
+          outChanged[changed++] = static_cast<uint8_t>(i);
+        }
+        break;
+      }
+    }
+  }
+  _counts[sourceIndex] = static_cast<uint8_t>(itemCount);
+  _seeded[sourceIndex] = true;
+  return changed;
+}
+
+bool RssScoreBoard::nextLive(size_t& outSourceIndex, uint32_t& outItemIndex) {
+  const size_t total = APP_MAX_RSS_SOURCES * APP_MAX_RSS_ITEMS;
+  size_t source = _liveSource;
+  size_t item = _liveItem;
+  for (size_t step = 0; step < total; step++) {
+    if (item >= _counts[source]) {
+      source = (source + 1) % APP_MAX_RSS_SOURCES;
+      item = 0;
+      continue;
+    }
+    const size_t current = item++;
+    if ((_entries[source][current].flags & RssItemFlagLive) != 0) {
+      outSourceIndex = source;
+      outItemIndex = static_cast<uint32_t>(current);
+      _liveSource = static_cast<uint8_t>(source);
+      _liveItem = static_cast<uint8_t>(item);
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t RssScoreBoard::liveCount() const {
+  size_t count = 0;
+  for (size_t s = 0; s < APP_MAX_RSS_SOURCES; s++) {
+    for (size_t i = 0; i < _counts[s]; i++) {
+      if ((_entries[s][i].flags & RssItemFlagLive) != 0) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+void RssScoreBoard::hashTitle(const char* title, uint32_t& outGame,
+                              uint32_t& outScore) {
+  uint32_t game = kFnvOffset;
+  uint32_t score = kFnvOffset;
+  for (const char* p = title; *p != '\0'; p++) {
+    // Color tags move to the leading score, so they are not part of either hash.
+    if (p[0] == '[' && p[1] == '[') {
+      const char* close = strstr(p + 2, "]]");
+      if (close == nullptr) {
+        break;
+      }
+      p = close + 1;
+      continue;
+    }
+    const uint8_t c = static_cast<uint8_t>(*p);
+    if (c >= '0' && c <= '9') {
+      score = (score ^ c) * kFnvPrime;
+    } else {
+      game = (game ^ c) * kFnvPrime;
+    }
+  }
+  outGame = game;
+  outScore = score;
+}
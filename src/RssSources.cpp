@@ -7,16 +7,17 @@ namespace {
 struct SportDef {
   const char* key;
   const char* label;
+  RssLeague league;
   bool AppSettings::*enabledField;
 };
 
 constexpr SportDef kSports[] = {
-    {"mlb", "MLB", &AppSettings::rssSportMlbEnabled},
-    {"nhl", "NHL", &AppSettings::rssSportNhlEnabled},
-    {"ncaaf", "NCAAF", &AppSettings::rssSportNcaafEnabled},
-    {"nfl", "NFL", &AppSettings::rssSportNflEnabled},
-    {"nba", "NBA", &AppSettings::rssSportNbaEnabled},
-    {"big10", "BIG10", &AppSettings::rssSportBig10Enabled},
+    {"mlb", "MLB", RssLeague::Mlb, &AppSettings::rssSportMlbEnabled},
+    {"nhl", "NHL", RssLeague::Nhl, &AppSettings::rssSportNhlEnabled},
+    {"ncaaf", "NCAAF", RssLeague::Ncaaf, &AppSettings::rssSportNcaafEnabled},
+    {"nfl", "NFL", RssLeague::Nfl, &AppSettings::rssSportNflEnabled},
+    {"nba", "NBA", RssLeague::Nba, &AppSettings::rssSportNbaEnabled},
+    {"big10", "BIG10", RssLeague::Big10, &AppSettings::rssSportBig10Enabled},
 };
 
 void safeCopy(char* dst, size_t dstLen, const char* src) {
@@ -49,11 +50,20 @@ bool containsPhpPath(const String& value) {
   return lower.indexOf(".php") >= 0;
 }
 
+// Custom feed URLs pointed at the scores backend still render as scores.
+RssDisplayMode displayModeForUrl(const char* url) {
+  String lower = url;
+  lower.toLowerCase();
+  return lower.indexOf("sport=") >= 0 ? RssDisplayMode::SingleSegment
+                                      : RssDisplayMode::TitleThenDescription;
+}
+
 void replaceAll(String& value, const char* from, const char* to) {
   value.replace(from, to);
 }
 
-bool buildSportsUrl(const AppSettings& settings, const char* sportKey,
+// Appends `<param>=<value>&format=json` to the normalized backend script URL.
+bool buildSportsUrl(const AppSettings& settings, const char* param, const String& value,
                     String& outUrl) {
   String base = trimCopy(settings.rssSportsBaseUrl);
   if (base.length() == 0) {
@@ -80,8 +90,9 @@ bool buildSportsUrl(const AppSettings& settings, const char* sportKey,
   } else {
     outUrl += "?";
   }
-  outUrl += "sport=";
-  outUrl += sportKey;
+  outUrl += param;
+  outUrl += "=";
+  outUrl += value;
   outUrl += "&format=json";
   return true;
 }
@@ -108,13 +119,17 @@ size_t buildRssSources(const AppSettings& settings, RssSource* outSources,
       }
 
       String sportUrl;
-      if (!buildSportsUrl(settings, sport.key, sportUrl)) {
+      if (!buildSportsUrl(settings, "sport", sport.key, sportUrl)) {
         continue;
       }
 
       safeCopy(outSources[count].name, sizeof(outSources[count].name), sport.label);
       safeCopy(outSources[count].url, sizeof(outSources[count].url), sportUrl.c_str());
       outSources[count].enabled = true;
+      outSources[count].kind = RssSourceKind::Sport;
+      outSources[count].league = sport.league;
+      outSources[count].displayMode = RssDisplayMode::SingleSegment;
+      outSources[count].batched = settings.rssSportsBatchEnabled;
       count++;
     }
   };
@@ -126,6 +141,10 @@ size_t buildRssSources(const AppSettings& settings, RssSource* outSources,
     safeCopy(outSources[count].name, sizeof(outSources[count].name), "NPR");
     safeCopy(outSources[count].url, sizeof(outSources[count].url), settings.rssUrl);
     outSources[count].enabled = true;
+    outSources[count].kind = RssSourceKind::News;
+    outSources[count].league = RssLeague::None;
+    outSources[count].displayMode = displayModeForUrl(settings.rssUrl);
+    outSources[count].batched = false;
     count++;
   };
 
@@ -146,3 +165,51 @@ bool hasEnabledRssSources(const AppSettings& settings) {
   RssSource sources[APP_MAX_RSS_SOURCES];
   return buildRssSources(settings, sources, APP_MAX_RSS_SOURCES) > 0;
 }
+
+bool buildRssSportsBatchUrl(const AppSettings& settings, const RssSource* sources,
+                            size_t sourceCount, char* outUrl, size_t outUrlLen) {
+  if (outUrl == nullptr || outUrlLen == 0) {
+    return false;
+  }
+  outUrl[0] = '\0';
+
+  String leagues;
+  for (size_t i = 0; i < sourceCount; i++) {
+    if (!sources[i].batched) {
+      continue;
+    }
+    if (leagues.length() > 0) {
+      leagues += ",";
+    }
+    leagues += rssLeagueKey(sources[i].league);
+  }
+
+  String url;
+  if (leagues.length() == 0 || !buildSportsUrl(settings, "sports", leagues, url) ||
+      url.length() >= outUrlLen) {
+    return false;
+  }
+  safeCopy(outUrl, outUrlLen, url.c_str());
+  return true;
+}
+
+const char* rssLeagueKey(RssLeague league) {
+  for (const SportDef& sport : kSports) {
+    if (sport.league == league) {
+      return sport.key;
+    }
+  }
+  return "";
+}
+
+const char* rssSourceKindName(RssSourceKind kind) {
+  switch (kind) {
+    case RssSourceKind::Sport:
+      return "sport";
+    case RssSourceKind::Weather:
+      return "weather";
+    case RssSourceKind::News:
+    default:
+      return "news";
+  }
+}
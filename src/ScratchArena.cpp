@@ -0,0 +1,167 @@
+#include "ScratchArena.h"
+
+#include <esp_heap_caps.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+constexpr size_t kAlign = 4;
+
+size_t alignUp(size_t value) { return (value + (kAlign - 1)) & ~(kAlign - 1); }
+}  // namespace
+
+ScratchArena::ScratchArena()
+    : _base(nullptr),
+      _capacity(0),
+      _used(0),
+      _last(0),
+      _highWater(0),
+      _fallbackAllocs(0) {}
+
+ScratchArena::~ScratchArena() {
+  if (_base != nullptr) {
+    heap_caps_free(_base);
+  }
+}
+
+bool ScratchArena::reserve(size_t capacity) {
+  if (_base != nullptr) {
+    return true;
+  }
+  _base = static_cast<uint8_t*>(heap_caps_malloc(capacity, MALLOC_CAP_8BIT));
+  if (_base == nullptr) {
+    return false;
+  }
+  _capacity = capacity;
+  reset();
+  return true;
+}
+
+bool ScratchArena::reserved() const { return _base != nullptr; }
+
+void* ScratchArena::allocate(size_t size) {
+  const size_t start = alignUp(_used);
+  if (_base == nullptr || size > _capacity || start > _capacity - size) {
+    return nullptr;
+  }
+  _last = start;
+  _used = start + size;
+  if (_used > _highWater) {
+    _highWater = _used;
+  }
+  return _base + start;
+}
+
+void* ScratchArena::reallocate(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return allocate(size);
+  }
+  const size_t offset = static_cast<size_t>(static_cast<uint8_t*>(ptr) - _base);
+  if (offset == _last) {
+    if (size > _capacity - offset) {
+      return nullptr;
+    }
+    _used = offset + size;
+    if (_used > _highWater) {
+      _highWater = _used;
+    }
+    return ptr;
+  }
+  // Older block: copy forward. Its old size is unknown, so copy at most what
+  // lies between the block and the arena top.
+  const size_t span = spanFrom(ptr);
+  void* moved = allocate(size);
+  if (moved != nullptr) {
+    memcpy(moved, ptr, size < span ? size : span);
+  }
+  return moved;
+}
+
+bool ScratchArena::owns(const void* ptr) const {
+  const uint8_t* p = static_cast<const uint8_t*>(ptr);
+  return _base != nullptr && p >= _base && p < _base + _capacity;
+}
+
+size_t ScratchArena::spanFrom(const void* ptr) const {
+  if (!owns(ptr)) {
+    return 0;
+  }
+  const size_t offset = static_cast<size_t>(static_cast<const uint8_t*>(ptr) - _base);
+  return offset < _used ? _used - offset : 0;
+}
+
+void ScratchArena::reset() {
+  _used = 0;
+  _last = 0;
+}
+
+size_t ScratchArena::mark() const { return _used; }
+
+void ScratchArena::rewind(size_t mark) {
+  if (mark < _used) {
+    _used = mark;
+    _last = mark;
+  }
+}
+
+char* ScratchArena::tail(size_t& outAvailable) {
+  const size_t start = alignUp(_used);
+  if (_base == nullptr || start >= _capacity) {
+    outAvailable = 0;
+    return nullptr;
+  }
+  outAvailable = _capacity - start;
+  return reinterpret_cast<char*>(_base + start);
+}
+
+void ScratchArena::commitTail(size_t used) {
+  size_t available = 0;
+  if (tail(available) == nullptr) {
+    return;
+  }
+  allocate(used < available ? used : available);
+}
+
+size_t ScratchArena::capacity() const { return _capacity; }
+
+size_t ScratchArena::used() const { return _used; }
+
+size_t ScratchArena::highWater() const { return _highWater; }
+
+uint32_t ScratchArena::fallbackAllocs() const { return _fallbackAllocs; }
+
+void ScratchArena::noteFallback() { _fallbackAllocs++; }
+
+ScratchJsonAllocator::ScratchJsonAllocator(ScratchArena& arena) : _arena(arena) {}
+
+void* ScratchJsonAllocator::allocate(size_t size) {
+  void* ptr = _arena.allocate(size);
+  if (ptr == nullptr) {
+    _arena.noteFallback();
+    ptr = malloc(size);
+  }
+  return ptr;
+}
+
+void ScratchJsonAllocator::deallocate(void* ptr) {
+  if (ptr != nullptr && !_arena.owns(ptr)) {
+    free(ptr);
+  }
+}
+
+void* ScratchJsonAllocator::reallocate(void* ptr, size_t newSize) {
+  if (ptr == nullptr || _arena.owns(ptr)) {
+    const size_t span = _arena.spanFrom(ptr);
+    void* moved = _arena.reallocate(ptr, newSize);
+    if (moved != nullptr) {
+      return moved;
+    }
+    _arena.noteFallback();
+    void* heap = malloc(newSize);
+    if (heap != nullptr && ptr != nullptr) {
+      memcpy(heap, ptr, span < newSize ? span : newSize);
+    }
+    return heap;
+  }
+  return realloc(ptr, newSize);
+}
@@ -1,7 +1,5 @@
 #include "Scroller.h"
 
-#include <FastLED.h>
-
 Scroller::Scroller(DisplayPanel& panel)
     : _panel(panel),
       _text(""),
@@ -46,7 +44,7 @@ void Scroller::tick() {
   _panel.show();
 
   if (_stepDelayMs > 0) {
-    FastLED.delay(_stepDelayMs);
+    _panel.delay(_stepDelayMs);
   }
 
   _x -= _pixelsPerTick;
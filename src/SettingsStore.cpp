@@ -7,9 +7,18 @@
 #include <Preferences.h>
 
 #include "AppConfig.h"
+#include "Crc32.h"
 
 namespace {
 const char* kSettingsPath = "/config/settings.json";
+const char* kSettingsTempPath = "/config/settings.json.tmp";
+const char* kSnapshotPath = "/config/settings.bin";
+const char* kSnapshotTempPath = "/config/settings.bin.tmp";
+constexpr uint32_t kSnapshotMagic = 0x5353434Du;  // "MCSS"
+// Bump when AppSettings fields change; older images then fall back to JSON.
+constexpr uint16_t kSnapshotLayout = 3;
+constexpr uint16_t kSnapshotVersion =
+    static_cast<uint16_t>((APP_SETTINGS_SCHEMA_VERSION << 8) | kSnapshotLayout);
 const char* kDefaultMessagesPath = "/config/default_messages.json";
 const char* kSettingsBackupNamespace = "ota_settings";
 const char* kBackupPendingKey = "pending";
@@ -27,6 +36,14 @@ void safeCopy(char* dst, size_t dstLen, const char* src) {
   strlcpy(dst, src, dstLen);
 }
 
+struct SettingsSnapshotHeader {
+  uint32_t magic;
+  uint16_t schemaVersion;
+  uint16_t payloadSize;
+  uint32_t jsonLoadUs;
+  uint32_t crc;
+};
+
 void clearSettingsBackup() {
   Preferences prefs;
   if (!prefs.begin(kSettingsBackupNamespace, false)) {
@@ -88,20 +105,65 @@ bool restoreSettingsFromBackupIfPending() {
 }
 }  // namespace
 
+SettingsStore::SettingsStore()
+    : _settings{},
+      _savePending(false),
+      _saveDueMs(0),
+      _flashWriteCount(0),
+      _commitCount(0),
+      _jsonLoadUs(0) {}
+
 bool SettingsStore::begin() {
+  const uint32_t startUs = micros();
   if (!LittleFS.begin(true, "/littlefs", 10, "littlefs")) {
     return false;
   }
+  const uint32_t mountUs = micros() - startUs;
 
-  restoreSettingsFromBackupIfPending();
+  if (restoreSettingsFromBackupIfPending()) {
+    // Restored JSON wins over any image written before the LittleFS flash.
+    LittleFS.remove(kSnapshotPath);
+  }
 
-  loadDefaults();
-  if (!load()) {
-    save();
+  const uint32_t loadStartUs = micros();
+  uint32_t snapshotJsonLoadUs = 0;
+  const bool fromSnapshot = loadSnapshot(snapshotJsonLoadUs);
+  if (fromSnapshot) {
+    _jsonLoadUs = snapshotJsonLoadUs;
+  } else {
+    loadDefaults();
+    if (!load()) {
+      _jsonLoadUs = micros() - loadStartUs;
+      save();
+    } else {
+      _jsonLoadUs = micros() - loadStartUs;
+      writeSnapshot();
+    }
+  }
+  const uint32_t loadUs = micros() - loadStartUs;
+
+  Serial.print("[BOOT] Settings mount=");
+  Serial.print(mountUs / 1000UL);
+  Serial.print(" ms load=");
+  Serial.print(loadUs / 1000UL);
+  Serial.print(" ms source=");
+  if (fromSnapshot) {
+    Serial.print("snapshot (json path ");
+    Serial.print(_jsonLoadUs / 1000UL);
+    Serial.println(" ms)");
+  } else {
+    Serial.println("json");
   }
   return true;
 }
 
+void SettingsStore::tick() {
+  if (!_savePending || static_cast<int32_t>(millis() - _saveDueMs) < 0) {
+    return;
+  }
+  flush();
+}
+
 AppSettings& SettingsStore::mutableSettings() { return _settings; }
 
 const AppSettings& SettingsStore::settings() const { return _settings; }
@@ -130,7 +192,9 @@ void SettingsStore::loadDefaults() {
   safeCopy(_settings.rssUrl, sizeof(_settings.rssUrl), "https://feeds.npr.org/1001/rss.xml");
   _settings.rssNprEnabled = true;
   _settings.rssRandomEnabled = false;
+  _settings.rssLivePriorityEnabled = true;
   _settings.rssSportsEnabled = true;
+  _settings.rssSportsBatchEnabled = false;
   safeCopy(_settings.rssSportsBaseUrl, sizeof(_settings.rssSportsBaseUrl),
            "charlie.servebeer.com/");
   _settings.rssSportMlbEnabled = true;
@@ -246,8 +310,12 @@ bool SettingsStore::load() {
   safeCopy(_settings.rssUrl, sizeof(_settings.rssUrl), doc["rss_url"] | defaults.rssUrl);
   _settings.rssNprEnabled = doc["rss_npr_enabled"] | defaults.rssNprEnabled;
   _settings.rssRandomEnabled = doc["rss_random_enabled"] | defaults.rssRandomEnabled;
+  _settings.rssLivePriorityEnabled =
+      doc["rss_live_priority_enabled"] | defaults.rssLivePriorityEnabled;
   _settings.rssSportsEnabled =
       doc["rss_sports_enabled"] | defaults.rssSportsEnabled;
+  _settings.rssSportsBatchEnabled =
+      doc["rss_sports_batch_enabled"] | defaults.rssSportsBatchEnabled;
   safeCopy(_settings.rssSportsBaseUrl, sizeof(_settings.rssSportsBaseUrl),
            doc["rss_sports_base_url"] | defaults.rssSportsBaseUrl);
   _settings.rssSportMlbEnabled =
@@ -270,7 +338,7 @@ bool SettingsStore::load() {
   return true;
 }
 
-bool SettingsStore::save() const {
+bool SettingsStore::writeJsonAtomic() {
   DynamicJsonDocument doc(8192);
   doc["schema_version"] = APP_SETTINGS_SCHEMA_VERSION;
 
@@ -295,7 +363,9 @@ bool SettingsStore::save() const {
   doc["rss_url"] = _settings.rssUrl;
   doc["rss_npr_enabled"] = _settings.rssNprEnabled;
   doc["rss_random_enabled"] = _settings.rssRandomEnabled;
+  doc["rss_live_priority_enabled"] = _settings.rssLivePriorityEnabled;
   doc["rss_sports_enabled"] = _settings.rssSportsEnabled;
+  doc["rss_sports_batch_enabled"] = _settings.rssSportsBatchEnabled;
   doc["rss_sports_base_url"] = _settings.rssSportsBaseUrl;
   doc["rss_sport_mlb_enabled"] = _settings.rssSportMlbEnabled;
   doc["rss_sport_nhl_enabled"] = _settings.rssSportNhlEnabled;
@@ -305,20 +375,146 @@ bool SettingsStore::save() const {
   doc["rss_sport_big10_enabled"] = _settings.rssSportBig10Enabled;
   doc["ota_manifest_url"] = _settings.otaManifestUrl;
 
-  File file = LittleFS.open(kSettingsPath, "w");
+  // Compact JSON into a temp file, then rename over the live file so a reset
+  // mid-write never leaves a truncated settings.json behind.
+  File file = LittleFS.open(kSettingsTempPath, "w");
+  if (!file) {
+    return false;
+  }
+
+  const bool ok = serializeJson(doc, file) > 0;
+  file.close();
+  if (!ok) {
+    LittleFS.remove(kSettingsTempPath);
+    return false;
+  }
+
+  if (!LittleFS.rename(kSettingsTempPath, kSettingsPath)) {
+    LittleFS.remove(kSettingsPath);
+    if (!LittleFS.rename(kSettingsTempPath, kSettingsPath)) {
+      LittleFS.remove(kSettingsTempPath);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// One save is one flash write in the counters, though it rewrites both the
+// JSON file and the snapshot that mirrors it.
+bool SettingsStore::save() {
+  const bool ok = writeJsonAtomic();
+  if (ok) {
+    _savePending = false;
+    _flashWriteCount++;
+    writeSnapshot();
+  }
+  return ok;
+}
+
+bool SettingsStore::loadSnapshot(uint32_t& outJsonLoadUs) {
+  if (!LittleFS.exists(kSnapshotPath)) {
+    return false;
+  }
+  File file = LittleFS.open(kSnapshotPath, "r");
   if (!file) {
     return false;
   }
 
-  bool ok = serializeJsonPretty(doc, file) > 0;
+  SettingsSnapshotHeader header = {};
+  const size_t headerLen =
+      file.readBytes(reinterpret_cast<char*>(&header), sizeof(header));
+  if (headerLen != sizeof(header) || header.magic != kSnapshotMagic ||
+      header.schemaVersion != kSnapshotVersion ||
+      header.payloadSize != sizeof(AppSettings)) {
+    file.close();
+    return false;
+  }
+
+  AppSettings image;
+  const size_t payloadLen =
+      file.readBytes(reinterpret_cast<char*>(&image), sizeof(image));
+  file.close();
+  if (payloadLen != sizeof(image) ||
+      crc32Compute(&image, sizeof(image)) != header.crc) {
+    return false;
+  }
+
+  _settings = image;
+  sanitize();
+  outJsonLoadUs = header.jsonLoadUs;
+  return true;
+}
+
+bool SettingsStore::writeSnapshot() {
+  SettingsSnapshotHeader header = {};
+  header.magic = kSnapshotMagic;
+  header.schemaVersion = kSnapshotVersion;
+  header.payloadSize = static_cast<uint16_t>(sizeof(AppSettings));
+  header.jsonLoadUs = _jsonLoadUs;
+  header.crc = crc32Compute(&_settings, sizeof(_settings));
+
+  File file = LittleFS.open(kSnapshotTempPath, "w");
+  if (!file) {
+    return false;
+  }
+  const bool ok =
+      file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) ==
+          sizeof(header) &&
+      file.write(reinterpret_cast<const uint8_t*>(&_settings),
+                 sizeof(_settings)) == sizeof(_settings);
   file.close();
+  if (!ok) {
+    LittleFS.remove(kSnapshotTempPath);
+    return false;
+  }
+
+  if (!LittleFS.rename(kSnapshotTempPath, kSnapshotPath)) {
+    LittleFS.remove(kSnapshotPath);
+    if (!LittleFS.rename(kSnapshotTempPath, kSnapshotPath)) {
+      LittleFS.remove(kSnapshotTempPath);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SettingsStore::commit(uint32_t debounceMs) {
+  _commitCount++;
+  _savePending = true;
+  _saveDueMs = millis() + debounceMs;
+}
+
+bool SettingsStore::flush() {
+  if (!_savePending) {
+    return true;
+  }
+  const bool ok = save();
+  Serial.print("[SETTINGS] ");
+  Serial.print(ok ? "Saved" : "Save failed");
+  Serial.print(" writes=");
+  Serial.print(_flashWriteCount);
+  Serial.print(" commits=");
+  Serial.println(_commitCount);
+  if (!ok) {
+    // Keep the edit pending and retry after another debounce window.
+    _saveDueMs = millis() + kCommitDebounceMs;
+  }
   return ok;
 }
 
+bool SettingsStore::hasPendingSave() const { return _savePending; }
+
+uint32_t SettingsStore::flashWriteCount() const { return _flashWriteCount; }
+
+uint32_t SettingsStore::commitCount() const { return _commitCount; }
+
 bool SettingsStore::factoryReset() {
   if (LittleFS.exists(kSettingsPath) && !LittleFS.remove(kSettingsPath)) {
     return false;
   }
+  LittleFS.remove(kSnapshotPath);
   loadDefaults();
   return save();
 }
@@ -0,0 +1,264 @@
+#include "WeatherExtractor.h"
+
+#include <ctype.h>
+#include <string.h>
+
+namespace {
+struct XmlTarget {
+  const char* tag;
+  const char* attr;
+  WeatherField field;
+};
+
+// First occurrence wins, like the old per-field indexOf() scans.
+constexpr XmlTarget kXmlTargets[] = {
+    {"city", "name", WeatherField::City},
+    {"temperature", "value", WeatherField::Temperature},
+    {"humidity", "value", WeatherField::Humidity},
+    {"pressure", "value", WeatherField::Pressure},
+    {"speed", "value", WeatherField::WindSpeed},
+    {"direction", "name", WeatherField::WindDirection},
+    {"clouds", "name", WeatherField::Clouds},
+};
+
+// JSON mode only reports wind.deg; use the names the XML mode would send.
+constexpr const char* kCompassNames[] = {
+    "North",     "North-northeast", "NorthEast", "East-northeast",
+    "East",      "East-southeast",  "SouthEast", "South-southeast",
+    "South",     "South-southwest", "SouthWest", "West-southwest",
+    "West",      "West-northwest",  "NorthWest", "North-northwest",
+};
+
+const char* compassName(float degrees) {
+  int sector = static_cast<int>((degrees + 11.25f) / 22.5f) % 16;
+  if (sector < 0) {
+    sector += 16;
+  }
+  return kCompassNames[sector];
+}
+}  // namespace
+
+WeatherExtractor::WeatherExtractor()
+    : _format(Format::Unknown),
+      _state(XmlState::Text),
+      _tag{},
+      _tagLen(0),
+      _attr{},
+      _attrLen(0),
+      _quote('"'),
+      _target(-1),
+      _pending{},
+      _pendingLen(0),
+      _values{},
+      _json{},
+      _jsonLen(0),
+      _received(0),
+      _truncated(false) {}
+
+size_t WeatherExtractor::write(uint8_t value) { return write(&value, 1); }
+
+size_t WeatherExtractor::write(const uint8_t* data, size_t size) {
+  _received += size;
+  size_t i = 0;
+  if (_format == Format::Unknown) {
+    while (i < size && isspace(data[i])) {
+      i++;
+    }
+    if (i == size) {
+      return size;
+    }
+    _format = data[i] == '{' ? Format::Json : Format::Xml;
+  }
+
+  if (_format == Format::Json) {
+    size_t copy = size - i;
+    if (copy > sizeof(_json) - _jsonLen) {
+      copy = sizeof(_json) - _jsonLen;
+      _truncated = true;
+    }
+    memcpy(_json + _jsonLen, data + i, copy);
+    _jsonLen += copy;
+    return size;
+  }
+
+  for (; i < size; i++) {
+    feedXml(static_cast<char>(data[i]));
+  }
+  return size;
+}
+
+bool WeatherExtractor::finish(ArduinoJson::Allocator* allocator) {
+  if (_format == Format::Json) {
+    if (allocator != nullptr) {
+      JsonDocument filter(allocator);
+      JsonDocument doc(allocator);
+      parseJson(filter, doc);
+    } else {
+      JsonDocument filter;
+      JsonDocument doc;
+      parseJson(filter, doc);
+    }
+  }
+  for (size_t i = 0; i < static_cast<size_t>(WeatherField::Count); i++) {
+    if (_values[i][0] != '\0') {
+      return true;
+    }
+  }
+  return false;
+}
+
+WeatherExtractor::Format WeatherExtractor::format() const { return _format; }
+
+size_t WeatherExtractor::received() const { return _received; }
+
+bool WeatherExtractor::truncated() const { return _truncated; }
+
+const char* WeatherExtractor::value(WeatherField field) const {
+  return field < WeatherField::Count ? _values[static_cast<size_t>(field)] : "";
+}
+
+bool WeatherExtractor::parseJson(JsonDocument& filter, JsonDocument& doc) {
+  filter["name"] = true;
+  filter["main"]["temp"] = true;
+  filter["main"]["humidity"] = true;
+  filter["main"]["pressure"] = true;
+  filter["wind"]["speed"] = true;
+  filter["wind"]["deg"] = true;
+  filter["weather"][0]["description"] = true;
+
+  const DeserializationError err =
+      deserializeJson(doc, _json, _jsonLen, DeserializationOption::Filter(filter));
+  if (err) {
+    return false;
+  }
+
+  setJsonValue(WeatherField::City, doc["name"]);
+  setJsonValue(WeatherField::Temperature, doc["main"]["temp"]);
+  setJsonValue(WeatherField::Humidity, doc["main"]["humidity"]);
+  setJsonValue(WeatherField::Pressure, doc["main"]["pressure"]);
+  setJsonValue(WeatherField::WindSpeed, doc["wind"]["speed"]);
+  setJsonValue(WeatherField::Clouds, doc["weather"][0]["description"]);
+  JsonVariantConst degrees = doc["wind"]["deg"];
+  if (degrees.is<float>()) {
+    setValue(WeatherField::WindDirection, compassName(degrees.as<float>()));
+  }
+  return true;
+}
+
+void WeatherExtractor::setJsonValue(WeatherField field, JsonVariantConst value) {
+  if (value.isNull()) {
+    return;
+  }
+  if (value.is<const char*>()) {
+    setValue(field, value.as<const char*>());
+    return;
+  }
+  char text[kValueLen + 1];
+  const size_t length = serializeJson(value, text, sizeof(text));
+  storeValue(field, text, length);
+}
+
+// Tag and attribute names longer than any target are cut short and simply
+// never match; everything outside a tag is skipped.
+void WeatherExtractor::feedXml(char c) {
+  const bool space = isspace(static_cast<unsigned char>(c)) != 0;
+  switch (_state) {
+    case XmlState::Text:
+      if (c == '<') {
+        _tagLen = 0;
+        _state = XmlState::TagName;
+      }
+      break;
+    case XmlState::TagName:
+      if (c == '>') {
+        _state = XmlState::Text;
+      } else if (space || (c == '/' && _tagLen > 0)) {
+        _tag[_tagLen < sizeof(_tag) ? _tagLen : sizeof(_tag) - 1] = '\0';
+        _state = XmlState::Attributes;
+      } else if (_tagLen < sizeof(_tag)) {
+        _tag[_tagLen++] = c;
+      }
+      break;
+    case XmlState::Attributes:
+      if (c == '>') {
+        _state = XmlState::Text;
+      } else if (!space && c != '/' && c != '?') {
+        _attrLen = 0;
+        _attr[_attrLen++] = c;
+        _state = XmlState::AttrName;
+      }
+      break;
+    case XmlState::AttrName:
+      if (c == '>') {
+        _state = XmlState::Text;
+      } else if (c == '=' || space) {
+        endAttrName();
+        _state = XmlState::Equals;
+      } else if (_attrLen < sizeof(_attr)) {
+        _attr[_attrLen++] = c;
+      }
+      break;
+    case XmlState::Equals:
+      if (c == '"' || c == '\'') {
+        _quote = c;
+        _pendingLen = 0;
+        _state = _target >= 0 ? XmlState::Value : XmlState::SkipValue;
+      } else if (c == '>') {
+        _state = XmlState::Text;
+      } else if (c != '=' && !space) {
+        // Valueless attribute; this byte starts the next name.
+        _attrLen = 0;
+        _attr[_attrLen++] = c;
+        _state = XmlState::AttrName;
+      }
+      break;
+    case XmlState::Value:
+      if (c == _quote) {
+        storeValue(static_cast<WeatherField>(_target), _pending, _pendingLen);
+        _state = XmlState::Attributes;
+      } else if (_pendingLen < kValueLen) {
+        _pending[_pendingLen++] = c;
+      }
+      break;
+    case XmlState::SkipValue:
+      if (c == _quote) {
+        _state = XmlState::Attributes;
+      }
+      break;
+  }
+}
+
+void WeatherExtractor::endAttrName() {
+  _target = -1;
+  if (_tagLen >= sizeof(_tag) || _attrLen >= sizeof(_attr)) {
+    return;
+  }
+  _attr[_attrLen] = '\0';
+  for (const XmlTarget& target : kXmlTargets) {
+    if (strcmp(_tag, target.tag) == 0 && strcmp(_attr, target.attr) == 0 &&
+        _values[static_cast<size_t>(target.field)][0] == '\0') {
+      _target = static_cast<int8_t>(target.field);
+      return;
+    }
+  }
+}
+
+void WeatherExtractor::storeValue(WeatherField field, const char* text, size_t length) {
+  while (length > 0 && isspace(static_cast<unsigned char>(*text))) {
+    text++;
+    length--;
+  }
+  while (length > 0 && isspace(static_cast<unsigned char>(text[length - 1]))) {
+    length--;
+  }
+  if (length > kValueLen) {
+    length = kValueLen;
+  }
+  char* out = _values[static_cast<size_t>(field)];
+  memcpy(out, text, length);
+  out[length] = '\0';
+}
+
+void WeatherExtractor::setValue(WeatherField field, const char* text) {
+  storeValue(field, text, strlen(text));
+}
@@ -4,13 +4,18 @@
 #include <WebServer.h>
 
 #include "AppConfig.h"
+#include "DisplayPanel.h"
 #include "OtaService.h"
+#include "RadioSessionBroker.h"
 #include "RssRuntime.h"
+#include "RssSources.h"
 
 namespace {
 const char* kUiPath = "/web/index.html";
 constexpr int kBrightnessMin = 0;
 constexpr int kBrightnessMax = 255;
+// Long enough for one RSS fetch with its retries to wind down.
+constexpr uint32_t kOtaProducerWaitMs = 30000;
 }
 
 WebService::WebService(SettingsStore& store, WifiService& wifiService)
@@ -19,6 +24,8 @@ WebService::WebService(SettingsStore& store, WifiService& wifiService)
       _wifiService(wifiService),
       _rssRuntime(nullptr),
       _otaService(nullptr),
+      _radioBroker(nullptr),
+      _displayPanel(nullptr),
       _onSettingsChanged(nullptr),
       _onWifiConnectRequested(nullptr),
       _onFactoryResetRequested(nullptr),
@@ -77,6 +84,14 @@ void WebService::setRssRuntime(RssRuntime* rssRuntime) { _rssRuntime = rssRuntim
 
 void WebService::setOtaService(OtaService* otaService) { _otaService = otaService; }
 
+void WebService::setRadioBroker(RadioSessionBroker* radioBroker) {
+  _radioBroker = radioBroker;
+}
+
+void WebService::setDisplayPanel(DisplayPanel* displayPanel) {
+  _displayPanel = displayPanel;
+}
+
 void WebService::registerRoutes() {
   _server->on("/", HTTP_GET, [this]() { handleRoot(); });
   _server->on("/favicon.ico", HTTP_GET, [this]() { _server->send(204, "text/plain", ""); });
@@ -162,15 +177,23 @@ void WebService::handleStatus() const {
   doc["panel_cols"] = s.panelCols;
   doc["wifi_mode"] = _wifiService.modeString();
   doc["ip"] = _wifiService.ip();
+  doc["wifi_last_connect_ms"] = _wifiService.lastConnectMs();
+  doc["wifi_cached_bssid"] = _wifiService.hasCachedBssid();
+  doc["wifi_reused_lease"] = _wifiService.lastConnectReusedLease();
   doc["wifi_ssid"] = s.wifiSsid;
   doc["wifi_password"] = s.wifiPassword;
   doc["ota_manifest_url"] = s.otaManifestUrl;
+  doc["settings_save_pending"] = _store.hasPendingSave();
+  doc["settings_flash_writes"] = _store.flashWriteCount();
+  doc["settings_commits"] = _store.commitCount();
 
   doc["rss_enabled"] = s.rssEnabled;
   doc["rss_url"] = s.rssUrl;
   doc["rss_npr_enabled"] = s.rssNprEnabled;
   doc["rss_random_enabled"] = s.rssRandomEnabled;
+  doc["rss_live_priority_enabled"] = s.rssLivePriorityEnabled;
   doc["rss_sports_enabled"] = s.rssSportsEnabled;
+  doc["rss_sports_batch_enabled"] = s.rssSportsBatchEnabled;
   doc["rss_sports_base_url"] = s.rssSportsBaseUrl;
   JsonObject sports = doc.createNestedObject("rss_sports");
   sports["mlb"] = s.rssSportMlbEnabled;
@@ -189,16 +212,123 @@ void WebService::handleStatus() const {
       source["name"] = sources[i].name;
       source["url"] = sources[i].url;
       source["enabled"] = sources[i].enabled;
+      source["kind"] = rssSourceKindName(sources[i].kind);
+      source["single_segment"] =
+          sources[i].displayMode == RssDisplayMode::SingleSegment;
+      source["batched"] = sources[i].batched;
 
       RssCacheMetadata meta = {};
       const bool hasMeta = _rssRuntime->sourceMetadata(i, meta);
       source["cache_valid"] = hasMeta && meta.valid;
       source["cache_item_count"] = hasMeta ? meta.itemCount : 0;
       source["cache_updated_epoch"] = hasMeta ? meta.updatedEpoch : 0;
+
+      RssSourceSchedule schedule = {};
+      if (_rssRuntime->sourceSchedule(i, schedule)) {
+        const int32_t dueInMs = static_cast<int32_t>(schedule.dueMs - millis());
+        source["refresh_interval_s"] = schedule.intervalMs / 1000UL;
+        source["next_refresh_s"] = dueInMs > 0 ? dueInMs / 1000 : 0;
+        source["refresh_checks"] = schedule.checks;
+        source["refresh_changes"] = schedule.changes;
+        source["refresh_failures"] = schedule.failures;
+        source["live"] = schedule.live;
+      }
+    }
+
+    RssPipelineStats pipeline = {};
+    _rssRuntime->pipelineStats(pipeline);
+    JsonObject lookahead = doc.createNestedObject("rss_pipeline");
+    lookahead["queued"] = pipeline.queued;
+    lookahead["capacity"] = pipeline.capacity;
+    lookahead["served"] = pipeline.served;
+    lookahead["underruns"] = pipeline.underruns;
+    lookahead["last_dequeue_us"] = pipeline.lastDequeueUs;
+    lookahead["max_dequeue_us"] = pipeline.maxDequeueUs;
+    lookahead["last_build_ms"] = pipeline.lastBuildMs;
+    lookahead["max_build_ms"] = pipeline.maxBuildMs;
+    lookahead["live_items"] = pipeline.liveItems;
+    lookahead["pending_score_updates"] = pipeline.pendingScoreUpdates;
+    lookahead["score_updates"] = pipeline.scoreUpdates;
+    lookahead["retry_budget_left"] = pipeline.retryBudgetLeft;
+    lookahead["breaker_skips"] = pipeline.breakerSkips;
+
+    JsonArray hosts = doc.createNestedArray("rss_hosts");
+    for (size_t i = 0; i < _rssRuntime->hostBreakerCount(); i++) {
+      RssHostBreakerEntry breaker = {};
+      if (!_rssRuntime->hostBreakerEntry(i, breaker)) {
+        continue;
+      }
+      JsonObject host = hosts.createNestedObject();
+      host["host"] = breaker.host;
+      host["state"] = RssHostBreaker::stateName(breaker.state);
+      host["failures"] = breaker.failures;
+      host["trips"] = breaker.trips;
+      const uint32_t openForMs = millis() - breaker.openedMs;
+      host["retry_in_s"] = breaker.state == RssBreakerState::Open &&
+                                   openForMs < breaker.cooldownMs
+                               ? (breaker.cooldownMs - openForMs) / 1000UL
+                               : 0;
     }
+
+    RssCacheStats cacheStats = {};
+    _rssRuntime->cacheStats(cacheStats);
+    JsonObject cache = doc.createNestedObject("rss_cache");
+    cache["hits"] = cacheStats.hits;
+    cache["misses"] = cacheStats.misses;
+    cache["evictions"] = cacheStats.evictions;
+    cache["hot_sources"] = cacheStats.hotSources;
+    cache["hot_bytes"] = cacheStats.hotBytes;
+    cache["budget_bytes"] = cacheStats.budgetBytes;
+    cache["psram"] = cacheStats.psram;
+    cache["log_bytes"] = cacheStats.logBytes;
+    cache["dead_bytes"] = cacheStats.deadBytes;
+    cache["compactions"] = cacheStats.compactions;
+
+    ClockStats clockStats = {};
+    _rssRuntime->clockStats(clockStats);
+    JsonObject clock = doc.createNestedObject("clock");
+    clock["synced"] = clockStats.synced;
+    clock["restored"] = clockStats.restored;
+    clock["waiting"] = clockStats.waiting;
+    clock["syncs"] = clockStats.syncs;
+    clock["last_sync_epoch"] = clockStats.lastSyncEpoch;
+    clock["last_offset_ms"] = clockStats.lastOffsetMs;
+    clock["drift_ppm"] = clockStats.driftPpm;
+    clock["resync_interval_s"] = clockStats.resyncIntervalMs / 1000UL;
+
+    PlaybackStats playbackStats = {};
+    _rssRuntime->playbackStats(playbackStats);
+    JsonObject playback = doc.createNestedObject("playback");
+    playback["restored_from"] =
+        playbackStats.restoredFrom == PlaybackOrigin::Rtc     ? "rtc"
+        : playbackStats.restoredFrom == PlaybackOrigin::Flash ? "flash"
+                                                              : "none";
+    playback["resumed"] = playbackStats.resumed;
+    playback["flash_writes"] = playbackStats.flashWrites;
   } else {
     doc["rss_source_count"] = 0;
     doc.createNestedArray("rss_sources");
+    doc.createNestedArray("rss_hosts");
+  }
+
+  if (_radioBroker != nullptr) {
+    _radioBroker->appendStatus(doc.createNestedObject("radio"));
+  }
+
+  if (_displayPanel != nullptr) {
+    DisplayFrameStats frames = {};
+    _displayPanel->frameStats(frames);
+    JsonObject display = doc.createNestedObject("display");
+    display["output_task"] = frames.outputTask;
+    display["outputs"] = frames.outputs;
+    display["frames"] = frames.frames;
+    display["last_output_us"] = frames.lastOutputUs;
+    display["avg_output_us"] = frames.avgOutputUs;
+    display["max_output_us"] = frames.maxOutputUs;
+    display["expected_output_us"] = frames.expectedOutputUs;
+    display["slow_frames"] = frames.slowFrames;
+    display["show_waits"] = frames.showWaits;
+    display["max_show_wait_us"] = frames.maxShowWaitUs;
   }
 
   JsonObject ota = doc.createNestedObject("ota");
@@ -251,7 +381,7 @@ void WebService::handleMessages() {
     i++;
   }
 
-  _store.save();
+  _store.commit();
   if (_onSettingsChanged) _onSettingsChanged(s);
   sendStatusMessage("Messages updated");
 }
@@ -272,7 +402,7 @@ void WebService::handleText() {
   AppSettings& s = _store.mutableSettings();
   strlcpy(s.messages[0].text, text, sizeof(s.messages[0].text));
   s.messages[0].enabled = true;
-  _store.save();
+  _store.commit();
   if (_onSettingsChanged) _onSettingsChanged(s);
   sendStatusMessage("Text updated");
 }
@@ -293,7 +423,7 @@ void WebService::handleColor() {
   s.messages[0].r = static_cast<uint8_t>(doc["r"] | s.messages[0].r);
   s.messages[0].g = static_cast<uint8_t>(doc["g"] | s.messages[0].g);
   s.messages[0].b = static_cast<uint8_t>(doc["b"] | s.messages[0].b);
-  _store.save();
+  _store.commit();
   if (_onSettingsChanged) _onSettingsChanged(s);
   sendStatusMessage("Color updated");
 }
@@ -318,7 +448,7 @@ void WebService::handleSpeed() {
 
   AppSettings& s = _store.mutableSettings();
   s.speed = static_cast<uint8_t>(speed);
-  _store.save();
+  _store.commit();
   if (_onSettingsChanged) _onSettingsChanged(s);
   sendStatusMessage("Speed updated");
 }
@@ -343,7 +473,7 @@ void WebService::handleBrightness() {
 
   AppSettings& s = _store.mutableSettings();
   s.brightness = static_cast<uint8_t>(brightness);
-  _store.save();
+  _store.commit();
   if (_onSettingsChanged) _onSettingsChanged(s);
   sendStatusMessage("Brightness updated");
 }
@@ -391,7 +521,7 @@ void WebService::handleAppearance() {
     return;
   }
 
-  _store.save();
+  _store.commit();
   if (_onSettingsChanged) _onSettingsChanged(s);
   sendStatusMessage("Appearance updated");
 }
@@ -458,9 +588,13 @@ void WebService::handleRss() {
   if (!doc["rss_npr_enabled"].isNull()) s.rssNprEnabled = doc["rss_npr_enabled"] | s.rssNprEnabled;
   if (!doc["random_enabled"].isNull()) s.rssRandomEnabled = doc["random_enabled"] | s.rssRandomEnabled;
   if (!doc["rss_random_enabled"].isNull()) s.rssRandomEnabled = doc["rss_random_enabled"] | s.rssRandomEnabled;
+  if (!doc["live_priority_enabled"].isNull()) s.rssLivePriorityEnabled = doc["live_priority_enabled"] | s.rssLivePriorityEnabled;
+  if (!doc["rss_live_priority_enabled"].isNull()) s.rssLivePriorityEnabled = doc["rss_live_priority_enabled"] | s.rssLivePriorityEnabled;
 
   if (!doc["sports_enabled"].isNull()) s.rssSportsEnabled = doc["sports_enabled"] | s.rssSportsEnabled;
   if (!doc["rss_sports_enabled"].isNull()) s.rssSportsEnabled = doc["rss_sports_enabled"] | s.rssSportsEnabled;
+  if (!doc["sports_batch_enabled"].isNull()) s.rssSportsBatchEnabled = doc["sports_batch_enabled"] | s.rssSportsBatchEnabled;
+  if (!doc["rss_sports_batch_enabled"].isNull()) s.rssSportsBatchEnabled = doc["rss_sports_batch_enabled"] | s.rssSportsBatchEnabled;
 
   if (!doc["sports_base_url"].isNull()) {
     strlcpy(s.rssSportsBaseUrl, doc["sports_base_url"] | s.rssSportsBaseUrl, sizeof(s.rssSportsBaseUrl));
@@ -575,7 +709,25 @@ void WebService::handleOtaUpdate() {
     sendError("No pending OTA update available", 400);
     return;
   }
+  // Debounced edits must hit flash before the settings backup and reboot.
+  _store.flush();
+  // The RSS producer appends to the cache log and checkpoints playback; it
+  // must be parked before a LittleFS install unmounts the filesystem.
+  if (_rssRuntime != nullptr) {
+    _rssRuntime->setSegmentNetworkEnabled(false);
+    _rssRuntime->setSuspended(true);
+    if (!_rssRuntime->waitProducerIdle(kOtaProducerWaitMs)) {
+      _rssRuntime->setSuspended(false);
+      _rssRuntime->setSegmentNetworkEnabled(true);
+      sendError("RSS refresh still running; try again", 503);
+      return;
+    }
+  }
   if (!_otaService->installAvailableUpdate()) {
+    if (_rssRuntime != nullptr) {
+      _rssRuntime->setSuspended(false);
+      _rssRuntime->setSegmentNetworkEnabled(true);
+    }
     sendError(_otaService->lastError(), 400);
     return;
   }
@@ -1,20 +1,136 @@
 #include "WifiService.h"
 
 #include <DNSServer.h>
-#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "Crc32.h"
 
 namespace {
 constexpr byte kDnsPort = 53;
+constexpr EventBits_t kBitGotIp = 1 << 0;
+constexpr EventBits_t kBitDisconnected = 1 << 1;
+constexpr uint32_t kRetryDelayMs = 250;
+// A directed join to a known BSSID/channel skips the scan and normally
+// completes in a few hundred ms; give up on the hint well before a full timeout.
+constexpr uint32_t kHintedAttemptTimeoutMs = 4000;
+constexpr uint32_t kConnectWaitSliceMs = 100;
+// Joins on a reused lease skip DHCP; renew it for real every so often so the
+// router still sees the lease in use, and well inside a typical lease time.
+constexpr uint8_t kMaxLeaseReuses = 48;
+constexpr uint32_t kMaxLeaseAgeS = 2UL * 60UL * 60UL;
+constexpr uint32_t kLeaseMagic = 0x3153454C;  // "LES1"
+constexpr const char* kLinkNamespace = "wifi_link";
+constexpr const char* kLinkKey = "link";
+constexpr uint8_t kLinkCacheVersion = 1;
+
+WifiService* sInstance = nullptr;
+
+// Reuse bookkeeping for the NVS lease. The system time and this record ride
+// through software resets but not power loss, so the first join after
+// power-on always goes through DHCP, and a reboot loop still counts reuses.
+struct LeaseRecord {
+  uint32_t magic;
+  uint32_t ip;
+  uint32_t acquiredS;  // system time of the DHCP join
+  uint32_t reuses;
+  uint32_t crc;
+};
+
+RTC_NOINIT_ATTR LeaseRecord gLeaseRecord;
+
+uint32_t leaseCrc(const LeaseRecord& record) {
+  return crc32Compute(&record, offsetof(LeaseRecord, crc));
+}
+
+uint32_t systemSeconds() {
+  struct timeval tv = {};
+  gettimeofday(&tv, nullptr);
+  return static_cast<uint32_t>(tv.tv_sec);
+}
+
+// An NTP step makes the lease look old, which only costs one DHCP join.
+bool leaseReusable(uint32_t ip) {
+  const LeaseRecord& record = gLeaseRecord;
+  if (record.magic != kLeaseMagic || record.crc != leaseCrc(record) || record.ip != ip ||
+      record.reuses >= kMaxLeaseReuses) {
+    return false;
+  }
+  const uint32_t nowS = systemSeconds();
+  return nowS >= record.acquiredS && nowS - record.acquiredS < kMaxLeaseAgeS;
+}
+
+void recordLease(uint32_t ip, bool reused) {
+  if (reused) {
+    gLeaseRecord.reuses++;
+  } else {
+    gLeaseRecord.magic = kLeaseMagic;
+    gLeaseRecord.ip = ip;
+    gLeaseRecord.acquiredS = systemSeconds();
+    gLeaseRecord.reuses = 0;
+  }
+  gLeaseRecord.crc = leaseCrc(gLeaseRecord);
+}
+
+bool dueBy(uint32_t dueMs, uint32_t nowMs) {
+  return static_cast<int32_t>(nowMs - dueMs) >= 0;
+}
 }  // namespace
 
 WifiService::WifiService()
-    : _mode(WifiRuntimeMode::Off), _dns(nullptr), _dnsRunning(false) {}
+    : _mode(WifiRuntimeMode::Off),
+      _dns(nullptr),
+      _dnsRunning(false),
+      _events(nullptr),
+      _ssid{},
+      _password{},
+      _connectStartMs(0),
+      _attemptStartMs(0),
+      _attemptTimeoutMs(0),
+      _retryAtMs(0),
+      _attempt(0),
+      _maxRetries(0),
+      _retryPending(false),
+      _attemptUsedHint(false),
+      _attemptUsedLease(false),
+      _staticIpApplied(false),
+      _onConnectDone(nullptr),
+      _connectContext(nullptr),
+      _lastConnectMs(0),
+      _link{},
+      _linkValid(false),
+      _leaseValid(false),
+      _eventBssid{},
+      _eventChannel(0),
+      _eventIp(0),
+      _eventGateway(0),
+      _eventNetmask(0),
+      _disconnectReason(0) {}
 
-WifiService::~WifiService() { stopCaptiveDns(); }
+WifiService::~WifiService() {
+  stopCaptiveDns();
+  if (sInstance == this) {
+    sInstance = nullptr;
+  }
+}
 
-void WifiService::begin() { WiFi.persistent(false); }
+void WifiService::begin() {
+  WiFi.persistent(false);
+  if (_events == nullptr) {
+    _events = xEventGroupCreate();
+  }
+  if (sInstance == nullptr) {
+    sInstance = this;
+    WiFi.onEvent(onWifiEvent);
+  }
+  loadLinkCache();
+}
 
 void WifiService::tick() {
+  advanceConnect();
   if (_dnsRunning && _dns != nullptr) {
     _dns->processNextRequest();
   }
@@ -32,36 +148,165 @@ bool WifiService::startForSettings(const AppSettings& settings) {
   return connected;
 }
 
-bool WifiService::connectSta(const char* ssid, const char* password,
-                             uint32_t timeoutMs, uint8_t maxRetries) {
-  if (ssid == nullptr || ssid[0] == '\0') {
+bool WifiService::beginConnectSta(const char* ssid, const char* password,
+                                  uint32_t timeoutMs, uint8_t maxRetries,
+                                  ConnectCallback onDone, void* context) {
+  if (ssid == nullptr || ssid[0] == '\0' || _events == nullptr) {
     return false;
   }
 
   stopCaptiveDns();
   WiFi.mode(WIFI_STA);
   _mode = WifiRuntimeMode::StaConnecting;
+  strlcpy(_ssid, ssid, sizeof(_ssid));
+  strlcpy(_password, password != nullptr ? password : "", sizeof(_password));
+  _attemptTimeoutMs = timeoutMs;
+  _maxRetries = maxRetries > 0 ? maxRetries : 1;
+  _attempt = 0;
+  _retryPending = false;
+  _onConnectDone = onDone;
+  _connectContext = context;
+  _connectStartMs = millis();
+  startAttempt();
+  return true;
+}
 
-  uint8_t attempt = 0;
-  while (attempt < maxRetries) {
-    WiFi.begin(ssid, password);
-    uint32_t started = millis();
-    while (WiFi.status() != WL_CONNECTED && (millis() - started) < timeoutMs) {
-      delay(250);
-    }
+bool WifiService::connectSta(const char* ssid, const char* password,
+                             uint32_t timeoutMs, uint8_t maxRetries) {
+  if (!beginConnectSta(ssid, password, timeoutMs, maxRetries)) {
+    return false;
+  }
+  while (_mode == WifiRuntimeMode::StaConnecting) {
+    xEventGroupWaitBits(_events, kBitGotIp | kBitDisconnected, pdFALSE, pdFALSE,
+                        pdMS_TO_TICKS(kConnectWaitSliceMs));
+    advanceConnect();
+  }
+  return _mode == WifiRuntimeMode::StaConnected;
+}
 
-    if (WiFi.status() == WL_CONNECTED) {
-      _mode = WifiRuntimeMode::StaConnected;
-      return true;
+// Runs in the WiFi event task: record what happened, let advanceConnect() act.
+void WifiService::onWifiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  WifiService* self = sInstance;
+  if (self == nullptr || self->_events == nullptr) {
+    return;
+  }
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+      for (size_t i = 0; i < sizeof(self->_link.bssid); i++) {
+        self->_eventBssid[i] = info.wifi_sta_connected.bssid[i];
+      }
+      self->_eventChannel = info.wifi_sta_connected.channel;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      self->_eventIp = info.got_ip.ip_info.ip.addr;
+      self->_eventGateway = info.got_ip.ip_info.gw.addr;
+      self->_eventNetmask = info.got_ip.ip_info.netmask.addr;
+      xEventGroupSetBits(self->_events, kBitGotIp);
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      self->_disconnectReason = info.wifi_sta_disconnected.reason;
+      xEventGroupSetBits(self->_events, kBitDisconnected);
+      break;
+    default:
+      break;
+  }
+}
+
+void WifiService::advanceConnect() {
+  if (_mode != WifiRuntimeMode::StaConnecting || _events == nullptr) {
+    return;
+  }
+
+  const EventBits_t bits = xEventGroupClearBits(_events, kBitGotIp | kBitDisconnected);
+  if ((bits & kBitGotIp) != 0) {
+    rememberLink();
+    _mode = WifiRuntimeMode::StaConnected;
+    finishConnect(true);
+    return;
+  }
+
+  const uint32_t nowMs = millis();
+  if (_retryPending) {
+    if (dueBy(_retryAtMs, nowMs)) {
+      _retryPending = false;
+      startAttempt();
     }
+    return;
+  }
 
-    WiFi.disconnect(true, true);
-    attempt++;
-    delay(250);
+  // Without a hint, disconnects mid-attempt are left to the driver's own
+  // reconnect until the attempt times out, as before.
+  const uint32_t limitMs = _attemptUsedHint && kHintedAttemptTimeoutMs < _attemptTimeoutMs
+                               ? kHintedAttemptTimeoutMs
+                               : _attemptTimeoutMs;
+  const bool hintRejected = _attemptUsedHint && (bits & kBitDisconnected) != 0;
+  if (!hintRejected && static_cast<uint32_t>(nowMs - _attemptStartMs) < limitMs) {
+    return;
   }
 
-  _mode = WifiRuntimeMode::Off;
-  return false;
+  WiFi.disconnect(true, true);
+  if (_attemptUsedHint) {
+    // The AP moved or changed channel: forget the hint and scan normally.
+    // This attempt does not count against the caller's retries.
+    Serial.print("[WIFI] Cached BSSID join failed (reason ");
+    Serial.print(_disconnectReason);
+    Serial.println("); scanning");
+    _linkValid = false;
+    _leaseValid = false;
+  } else {
+    _attempt++;
+  }
+  if (_attempt >= _maxRetries) {
+    _mode = WifiRuntimeMode::Off;
+    finishConnect(false);
+    return;
+  }
+  _retryPending = true;
+  _retryAtMs = nowMs + kRetryDelayMs;
+}
+
+void WifiService::startAttempt() {
+  xEventGroupClearBits(_events, kBitGotIp | kBitDisconnected);
+  _attemptUsedHint = _linkValid && strcmp(_link.ssid, _ssid) == 0;
+  _attemptUsedLease = _attemptUsedHint && _leaseValid && leaseReusable(_link.ip);
+  if (_attemptUsedLease) {
+    WiFi.config(IPAddress(_link.ip), IPAddress(_link.gateway), IPAddress(_link.netmask),
+                IPAddress(_link.dns));
+    _staticIpApplied = true;
+  } else if (_staticIpApplied) {
+    // All-zero config switches the STA interface back to DHCP.
+    WiFi.config(IPAddress(static_cast<uint32_t>(0)), IPAddress(static_cast<uint32_t>(0)),
+                IPAddress(static_cast<uint32_t>(0)));
+    _staticIpApplied = false;
+  }
+  if (_attemptUsedHint) {
+    WiFi.begin(_ssid, _password, _link.channel, _link.bssid);
+  } else {
+    WiFi.begin(_ssid, _password);
+  }
+  _attemptStartMs = millis();
+}
+
+void WifiService::finishConnect(bool connected) {
+  _lastConnectMs = millis() - _connectStartMs;
+  Serial.print("[WIFI] STA ");
+  Serial.print(connected ? "connected in " : "connect failed after ");
+  Serial.print(_lastConnectMs);
+  Serial.print(" ms");
+  if (connected && _attemptUsedHint) {
+    Serial.print(" (cached BSSID, ch ");
+    Serial.print(_link.channel);
+    Serial.print(_attemptUsedLease ? ", reused lease)" : ")");
+  }
+  Serial.println();
+
+  const ConnectCallback callback = _onConnectDone;
+  void* context = _connectContext;
+  _onConnectDone = nullptr;
+  _connectContext = nullptr;
+  if (callback != nullptr) {
+    callback(connected, context);
+  }
 }
 
 void WifiService::startAp(const char* ssid, const char* password) {
@@ -72,15 +317,22 @@ void WifiService::startAp(const char* ssid, const char* password) {
 }
 
 void WifiService::stopWifi() {
+  // Cancels a pending connect without firing its callback.
+  _onConnectDone = nullptr;
+  _connectContext = nullptr;
+  _retryPending = false;
   stopCaptiveDns();
   WiFi.disconnect(true, true);
   WiFi.mode(WIFI_OFF);
   _mode = WifiRuntimeMode::Off;
 }
 
+// Non-blocking: the loop keeps running (and tick() drives the join) while STA
+// connects; a failed join falls back to the setup AP.
 bool WifiService::enterConfigMode(const AppSettings& settings) {
   if (settings.wifiSsid[0] != '\0' &&
-      connectSta(settings.wifiSsid, settings.wifiPassword)) {
+      beginConnectSta(settings.wifiSsid, settings.wifiPassword, 15000, 3,
+                      onConfigConnectDone, this)) {
     return true;
   }
 
@@ -88,6 +340,12 @@ bool WifiService::enterConfigMode(const AppSettings& settings) {
   return true;
 }
 
+void WifiService::onConfigConnectDone(bool connected, void* context) {
+  if (!connected) {
+    static_cast<WifiService*>(context)->startAp();
+  }
+}
+
 void WifiService::exitConfigMode(bool radioOffAfterExit) {
   if (radioOffAfterExit) {
     stopWifi();
@@ -98,6 +356,70 @@ WifiRuntimeMode WifiService::mode() const { return _mode; }
 
 bool WifiService::isConnected() const { return WiFi.status() == WL_CONNECTED; }
 
+bool WifiService::connectInProgress() const {
+  return _mode == WifiRuntimeMode::StaConnecting;
+}
+
+uint32_t WifiService::lastConnectMs() const { return _lastConnectMs; }
+
+bool WifiService::hasCachedBssid() const { return _linkValid; }
+
+bool WifiService::lastConnectReusedLease() const {
+  return _mode == WifiRuntimeMode::StaConnected && _attemptUsedLease;
+}
+
+void WifiService::loadLinkCache() {
+  Preferences prefs;
+  if (!prefs.begin(kLinkNamespace, true)) {
+    return;
+  }
+  LinkCache stored = {};
+  const bool loaded = prefs.getBytesLength(kLinkKey) == sizeof(stored) &&
+                      prefs.getBytes(kLinkKey, &stored, sizeof(stored)) == sizeof(stored);
+  prefs.end();
+  if (!loaded || stored.version != kLinkCacheVersion || stored.channel == 0) {
+    return;
+  }
+  stored.ssid[sizeof(stored.ssid) - 1] = '\0';
+  _link = stored;
+  _linkValid = true;
+  _leaseValid = _link.ip != 0;
+}
+
+// Called only when the record changed, so steady-state joins never write NVS.
+void WifiService::persistLinkCache() {
+  Preferences prefs;
+  if (!prefs.begin(kLinkNamespace, false)) {
+    return;
+  }
+  prefs.putBytes(kLinkKey, &_link, sizeof(_link));
+  prefs.end();
+}
+
+void WifiService::rememberLink() {
+  LinkCache learned = _link;
+  learned.version = kLinkCacheVersion;
+  strlcpy(learned.ssid, _ssid, sizeof(learned.ssid));
+  for (size_t i = 0; i < sizeof(learned.bssid); i++) {
+    learned.bssid[i] = _eventBssid[i];
+  }
+  learned.channel = _eventChannel;
+  if (!_attemptUsedLease) {
+    learned.ip = _eventIp;
+    learned.gateway = _eventGateway;
+    learned.netmask = _eventNetmask;
+    learned.dns = static_cast<uint32_t>(WiFi.dnsIP(0));
+  }
+  recordLease(learned.ip, _attemptUsedLease);
+
+  _linkValid = learned.channel != 0;
+  _leaseValid = learned.ip != 0;
+  if (_linkValid && memcmp(&learned, &_link, sizeof(learned)) != 0) {
+    _link = learned;
+    persistLinkCache();
+  }
+}
+
 String WifiService::ip() const {
   if (_mode == WifiRuntimeMode::AP) {
     return WiFi.softAPIP().toString();
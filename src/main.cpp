@@ -5,6 +5,7 @@
 #include "ContentScheduler.h"
 #include "DisplayPanel.h"
 #include "OtaService.h"
+#include "RadioSessionBroker.h"
 #include "RssRuntime.h"
 #include "Scroller.h"
 #include "SettingsStore.h"
@@ -20,19 +21,38 @@ constexpr uint8_t kConfigButtonPin = 0;  // BOOT button on ESP32 DevKit
 constexpr uint8_t kServiceButtonPin = 25;  // External service button (active-low)
 constexpr uint32_t kButtonDebounceMs = 250;
 constexpr uint32_t kConfigPromptRefreshMs = 2000;
-constexpr uint32_t kBootRefreshTaskStackWords = 6144;
-constexpr BaseType_t kBootRefreshTaskPriority = 1;
+constexpr uint32_t kBootTaskStackWords = 6144;
+constexpr BaseType_t kBootTaskPriority = 1;
+constexpr BaseType_t kBootTaskCore = 0;  // keep network work off the scroll loop core
 constexpr const char* kBootLoadingText = "Now Loading...";
+constexpr const char* kBootCheckingUpdatesText = "Checking for updates...";
 constexpr const char* kBootOtaUpdatingText = "Updating Firmware ";
 constexpr const char* kBootOtaUpdatingLittleFsText = "Updating Filesystem ";
-constexpr uint32_t kBootOtaStaTimeoutMs = 8000;
-constexpr uint8_t kBootOtaStaRetries = 2;
+constexpr uint32_t kBootOtaProducerWaitMs = 5000;
+
+enum class BootStage : uint8_t {
+  Idle,
+  ConnectingWifi,
+  CheckingOta,
+  InstallingFirmware,
+  InstallingLittleFs,
+  Refreshing,
+  Done,
+};
+
+// A config-mode switch waits for the RSS producer to leave the radio.
+enum class ConfigTransition : uint8_t {
+  None,
+  Entering,
+  Exiting,
+};
 }
 
 SettingsStore gSettingsStore;
 WifiService gWifiService;
 OtaService gOtaService(gWifiService);
-RssRuntime gRssRuntime(gSettingsStore, gWifiService);
+RadioSessionBroker gRadioBroker(gSettingsStore, gWifiService);
+RssRuntime gRssRuntime(gSettingsStore, gWifiService, gRadioBroker);
 DisplayPanel gDisplay(APP_MATRIX_WIDTH, APP_MATRIX_HEIGHT);
 Scroller gScroller(gDisplay);
 ContentScheduler gScheduler(gScroller, gDisplay);
@@ -44,6 +64,7 @@ uint8_t gBrightness = APP_DEFAULT_BRIGHTNESS;
 uint8_t gScrollSpeed = APP_SCROLL_SPEED_DEFAULT;
 uint8_t gPixelStep = APP_SCROLL_PIXEL_STEP_DEFAULT;
 bool gConfigMode = false;
+ConfigTransition gConfigTransition = ConfigTransition::None;
 bool gManualModeOverride = false;
 ContentMode gManualMode = ContentMode::Messages;
 String gLastConfigPrompt;
@@ -56,20 +77,62 @@ uint32_t gLastServiceButtonChangeMs = 0;
 
 volatile bool gExitConfigRequested = false;
 
+uint32_t gBootStartMs = 0;
 bool gBootLoadingMode = false;
+bool gBootRefreshPlanned = false;
+volatile bool gBootTaskRunning = false;
 volatile bool gBootRefreshComplete = false;
 volatile bool gBootRefreshSuccess = false;
-TaskHandle_t gBootRefreshTaskHandle = nullptr;
+volatile BootStage gBootStage = BootStage::Idle;
+volatile bool gBootOtaBannerShown = false;
+BootStage gBootStageSeen = BootStage::Idle;
+TaskHandle_t gBootTaskHandle = nullptr;
 
 void printStatus();
 void showStaticRepeatingText(const char* text, uint8_t r, uint8_t g, uint8_t b);
-void runBootOtaIfAvailable();
+bool runBootOtaIfAvailable();
 
-void bootRefreshTask(void* /*param*/) {
-  const bool refreshed = gRssRuntime.refreshAllNow();
-  gBootRefreshSuccess = refreshed;
+void logBootStage(const char* stage) {
+  Serial.print("[BOOT] +");
+  Serial.print(millis() - gBootStartMs);
+  Serial.print(" ms ");
+  Serial.println(stage);
+}
+
+void setBootStage(BootStage stage, const char* label) {
+  gBootStage = stage;
+  logBootStage(label);
+}
+
+bool bootOtaJob(bool connected, void* /*context*/) {
+  if (!connected) {
+    Serial.println("[OTA] Boot check skipped: WiFi connect failed");
+    return false;
+  }
+  setBootStage(BootStage::CheckingOta, "ota check");
+  const bool installed = runBootOtaIfAvailable();
+  if (gBootRefreshPlanned) {
+    setBootStage(BootStage::Refreshing, "rss refresh");
+  }
+  return installed;
+}
+
+// Background boot work while loop() keeps scrolling cached content. The OTA
+// check is queued with the radio broker first, so the RSS refresh window
+// (sources, weather, NTP) runs it in the same STA session.
+void bootTask(void* /*param*/) {
+  setBootStage(BootStage::ConnectingWifi, "wifi connect");
+  gRadioBroker.submit("ota", bootOtaJob, nullptr, millis());
+  if (gBootRefreshPlanned) {
+    gBootRefreshSuccess = gRssRuntime.refreshAllNow();
+  } else {
+    gRadioBroker.runWindow();
+  }
+
+  setBootStage(BootStage::Done, "background tasks done");
   gBootRefreshComplete = true;
-  gBootRefreshTaskHandle = nullptr;
+  gBootTaskRunning = false;
+  gBootTaskHandle = nullptr;
   vTaskDelete(nullptr);
 }
 
@@ -179,33 +242,79 @@ bool shouldRunBootRefresh() {
   return gRssRuntime.hasEnabledSources();
 }
 
-void beginBootLoadingRefresh() {
-  if (!shouldRunBootRefresh()) {
-    gBootLoadingMode = false;
-    return;
-  }
-
-  gBootLoadingMode = true;
+void beginBootTasks() {
+  gBootTaskRunning = true;
   gBootRefreshComplete = false;
   gBootRefreshSuccess = false;
-  gScheduler.setConfigPromptText(kBootLoadingText);
+  if (gBootLoadingMode) {
+    gScheduler.setConfigPromptText(kBootLoadingText);
+  }
   applySchedulerMode();
 
-  if (xTaskCreatePinnedToCore(bootRefreshTask, "boot_refresh",
-                              kBootRefreshTaskStackWords, nullptr,
-                              kBootRefreshTaskPriority, &gBootRefreshTaskHandle,
-                              tskNO_AFFINITY) != pdPASS) {
+  if (xTaskCreatePinnedToCore(bootTask, "boot_tasks", kBootTaskStackWords,
+                              nullptr, kBootTaskPriority, &gBootTaskHandle,
+                              kBootTaskCore) != pdPASS) {
     gBootLoadingMode = false;
+    gBootTaskRunning = false;
     gBootRefreshComplete = true;
     gBootRefreshSuccess = false;
-    gBootRefreshTaskHandle = nullptr;
+    gBootTaskHandle = nullptr;
+    gRssRuntime.setSegmentNetworkEnabled(true);
     gScheduler.setConfigPromptText("Config mode active");
     applySchedulerMode();
-    Serial.println("Boot refresh task start failed");
+    Serial.println("Boot task start failed");
+    return;
+  }
+
+  logBootStage("background tasks started");
+}
+
+bool bootOtaInstallActive() {
+  const BootStage stage = gBootStage;
+  return stage == BootStage::InstallingFirmware ||
+         stage == BootStage::InstallingLittleFs;
+}
+
+// Mirrors background boot progress onto the panel from the loop task, which
+// owns the scheduler and display.
+void serviceBootProgress() {
+  const BootStage stage = gBootStage;
+  if (stage == gBootStageSeen) {
     return;
   }
+  const BootStage previous = gBootStageSeen;
+  gBootStageSeen = stage;
 
-  Serial.println("Boot refresh started");
+  if (stage == BootStage::InstallingFirmware ||
+      stage == BootStage::InstallingLittleFs) {
+    showStaticRepeatingText(stage == BootStage::InstallingFirmware
+                                ? kBootOtaUpdatingText
+                                : kBootOtaUpdatingLittleFsText,
+                            255, 195, 0);
+    gBootOtaBannerShown = true;
+    return;
+  }
+
+  if (previous == BootStage::InstallingFirmware ||
+      previous == BootStage::InstallingLittleFs) {
+    // Install failed; resume scrolling from a fresh segment.
+    gBootOtaBannerShown = false;
+    gScheduler.advanceNow();
+  }
+
+  if (gBootLoadingMode) {
+    gScheduler.setConfigPromptText(stage == BootStage::CheckingOta
+                                       ? kBootCheckingUpdatesText
+                                       : kBootLoadingText);
+    return;
+  }
+
+  if (stage == BootStage::Done) {
+    gRssRuntime.setSegmentNetworkEnabled(true);
+    gRssRuntime.queueStartupWeather();
+    Serial.print("Boot refresh done: ");
+    Serial.println(gBootRefreshSuccess ? "fresh content updated" : "using cache/fallback");
+  }
 }
 
 void completeBootLoadingIfReady(bool cycleComplete) {
@@ -214,6 +323,7 @@ void completeBootLoadingIfReady(bool cycleComplete) {
   }
 
   gBootLoadingMode = false;
+  gRssRuntime.setSegmentNetworkEnabled(true);
   gRssRuntime.queueStartupWeather();
   gScheduler.setConfigPromptText("Config mode active");
   applySchedulerMode();
@@ -241,56 +351,60 @@ void showStaticRepeatingText(const char* text, uint8_t r, uint8_t g, uint8_t b)
   gDisplay.show();
 }
 
-void runBootOtaIfAvailable() {
+// Runs on the boot task with STA already connected. Returns false when no
+// update was installed; a successful install reboots and does not return.
+bool runBootOtaIfAvailable() {
   const AppSettings& settings = gSettingsStore.settings();
-  if (settings.wifiSsid[0] == '\0') {
-    Serial.println("[OTA] Boot check skipped: no WiFi credentials");
-    return;
-  }
-
-  if (!gWifiService.connectSta(settings.wifiSsid, settings.wifiPassword,
-                               kBootOtaStaTimeoutMs, kBootOtaStaRetries)) {
-    Serial.println("[OTA] Boot check skipped: WiFi connect failed");
-    gWifiService.stopWifi();
-    return;
-  }
-
   if (!gOtaService.checkForUpdate(settings.otaManifestUrl)) {
     Serial.print("[OTA] Check failed: ");
     Serial.println(gOtaService.lastError());
-    gWifiService.stopWifi();
-    return;
+    return false;
   }
 
   if (!gOtaService.hasPendingUpdate()) {
     Serial.println("[OTA] No update available");
-    gWifiService.stopWifi();
-    return;
+    return false;
   }
 
   const bool firmwareUpdate = gOtaService.hasPendingFirmwareUpdate();
-  const bool littleFsUpdate = gOtaService.hasPendingLittleFsUpdate();
   if (firmwareUpdate) {
     Serial.print("[OTA] Installing firmware update version ");
     Serial.println(gOtaService.availableVersion());
-  } else if (littleFsUpdate) {
+  } else {
     Serial.print("[OTA] Installing littlefs update version ");
     Serial.println(gOtaService.availableLittleFsVersion());
   }
 
-  showStaticRepeatingText(
-      firmwareUpdate ? kBootOtaUpdatingText : kBootOtaUpdatingLittleFsText,
-      255, 195, 0);
+  setBootStage(firmwareUpdate ? BootStage::InstallingFirmware
+                              : BootStage::InstallingLittleFs,
+               "ota install");
+  // Wait for loop() to park the panel on the static banner so no frames are
+  // pushed while flash is being written.
+  while (!gBootOtaBannerShown) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  // Segment network is already off for the boot task; also keep the producer
+  // away from the cache and checkpoint files while LittleFS may be unmounted.
+  gRssRuntime.setSuspended(true);
+  if (!gRssRuntime.waitProducerIdle(kBootOtaProducerWaitMs)) {
+    gRssRuntime.setSuspended(false);
+    Serial.println("[OTA] Install skipped: RSS producer still busy");
+    setBootStage(BootStage::CheckingOta, "ota install failed");
+    return false;
+  }
+
   if (!gOtaService.installAvailableUpdate()) {
+    gRssRuntime.setSuspended(false);
     Serial.print("[OTA] Install failed: ");
     Serial.println(gOtaService.lastError());
-    gWifiService.stopWifi();
-    return;
+    setBootStage(BootStage::CheckingOta, "ota install failed");
+    return false;
   }
 
   Serial.println("[OTA] Update installed, rebooting");
-  delay(300);
+  Serial.flush();
   ESP.restart();
+  return true;
 }
 
 bool provideRssSegment(String& text, uint8_t& r, uint8_t& g, uint8_t& b) {
@@ -316,6 +430,32 @@ void printStatus() {
   Serial.print(gRssRuntime.sourceCount());
   Serial.print(" RSSCache=");
   Serial.print(gRssRuntime.hasCachedContent() ? "ready" : "empty");
+  RssPipelineStats pipeline = {};
+  gRssRuntime.pipelineStats(pipeline);
+  Serial.print(" RSSQueue=");
+  Serial.print(pipeline.queued);
+  Serial.print("/");
+  Serial.print(pipeline.capacity);
+  Serial.print(" Underruns=");
+  Serial.print(pipeline.underruns);
+  Serial.print(" MaxDequeueUs=");
+  Serial.print(pipeline.maxDequeueUs);
+  DisplayFrameStats frames = {};
+  gDisplay.frameStats(frames);
+  Serial.print(" FrameUs=");
+  Serial.print(frames.avgOutputUs);
+  Serial.print("/");
+  Serial.print(frames.maxOutputUs);
+  Serial.print(" SlowFrames=");
+  Serial.print(frames.slowFrames);
+  RadioWindowReport radioWindow = {};
+  if (gRadioBroker.recentWindow(0, radioWindow)) {
+    Serial.print(" LastRadioWindow=");
+    Serial.print(radioWindow.jobs);
+    Serial.print("@");
+    Serial.print(radioWindow.awakeMs);
+    Serial.print("ms");
+  }
   Serial.print(" Mode=");
   switch (gScheduler.mode()) {
     case ContentMode::Messages:
@@ -351,14 +491,14 @@ void printSerialHelp() {
 void saveAndApplySettings() {
   gSettingsStore.mutableSettings().brightness = gBrightness;
   gSettingsStore.mutableSettings().speed = gScrollSpeed;
-  gSettingsStore.save();
+  gSettingsStore.commit();
   applyRuntimeFromSettings(gSettingsStore.settings());
 }
 
 void applyScrollSpeed() {
   gScheduler.setMessageDelayMs(appScrollDelayForSpeed(gScrollSpeed));
   gSettingsStore.mutableSettings().speed = gScrollSpeed;
-  gSettingsStore.save();
+  gSettingsStore.commit();
   Serial.print("Speed now ");
   Serial.print(gScrollSpeed);
   Serial.print(" (delay ");
@@ -372,23 +512,14 @@ void applyPixelStep() {
   Serial.println(gPixelStep);
 }
 
-void enterConfigMode() {
-  if (gConfigMode) return;
-  if (gBootLoadingMode && !gBootRefreshComplete) {
-    Serial.println("Boot refresh still running; wait for Now Loading... to finish");
-    return;
-  }
-  if (gBootLoadingMode) {
-    gBootLoadingMode = false;
-    gScheduler.setConfigPromptText("Config mode active");
-  }
+void finishEnterConfigMode() {
   gConfigMode = true;
+  gRadioBroker.setRadioControlEnabled(false);
   gWifiService.enterConfigMode(gSettingsStore.settings());
   if (!gWebService.isRunning()) {
     gWebService.begin();
   }
-  gRssRuntime.setSuspended(false);
-  gRssRuntime.setRadioControlEnabled(false);
+  gRssRuntime.setSegmentNetworkEnabled(true);
   gRssRuntime.forceRefreshSoon();
   refreshConfigPromptText(true);
   applySchedulerMode();
@@ -396,18 +527,57 @@ void enterConfigMode() {
   printStatus();
 }
 
-void exitConfigMode() {
-  if (!gConfigMode) return;
-  gConfigMode = false;
-  gWebService.stop();
+void finishExitConfigMode() {
   gWifiService.exitConfigMode(true);
-  gRssRuntime.setRadioControlEnabled(true);
-  gRssRuntime.setSuspended(true);
+  gRadioBroker.setRadioControlEnabled(true);
+  gRssRuntime.setSegmentNetworkEnabled(true);
   applySchedulerMode();
   Serial.println("Exited config mode");
   printStatus();
 }
 
+// Completes a pending config-mode switch once no RSS window holds the radio.
+// Polled from loop(), so the panel keeps scrolling while a fetch winds down.
+void serviceConfigTransition() {
+  if (gConfigTransition == ConfigTransition::None || !gRssRuntime.networkIdle()) {
+    return;
+  }
+  const ConfigTransition transition = gConfigTransition;
+  gConfigTransition = ConfigTransition::None;
+  if (transition == ConfigTransition::Entering) {
+    finishEnterConfigMode();
+  } else {
+    finishExitConfigMode();
+  }
+}
+
+void enterConfigMode() {
+  if (gConfigMode || gConfigTransition != ConfigTransition::None) return;
+  if (gBootTaskRunning) {
+    Serial.println("Boot tasks still running; wait for startup refresh to finish");
+    return;
+  }
+  if (gBootLoadingMode) {
+    gBootLoadingMode = false;
+    gScheduler.setConfigPromptText("Config mode active");
+  }
+  // WiFi switches to AP/STA once an in-flight RSS window stops after its
+  // current job.
+  gRssRuntime.setSegmentNetworkEnabled(false);
+  gConfigTransition = ConfigTransition::Entering;
+  serviceConfigTransition();
+}
+
+void exitConfigMode() {
+  if (!gConfigMode || gConfigTransition != ConfigTransition::None) return;
+  gConfigMode = false;
+  gSettingsStore.flush();
+  gWebService.stop();
+  gRssRuntime.setSegmentNetworkEnabled(false);
+  gConfigTransition = ConfigTransition::Exiting;
+  serviceConfigTransition();
+}
+
 void onSettingsChanged(const AppSettings& settings) {
   applyRuntimeFromSettings(settings);
 }
@@ -516,8 +686,8 @@ void handleConfigButton() {
 }
 
 void setup() {
+  gBootStartMs = millis();
   Serial.begin(115200);
-  delay(300);
   Serial.println();
   Serial.println("ManCaveScrollerArduinoIDE");
   Serial.println("RSS/cache runtime integration build");
@@ -539,6 +709,7 @@ void setup() {
       delay(1000);
     }
   }
+  logBootStage("settings loaded");
 
   if (!gDisplay.begin()) {
     Serial.println("Display init failed");
@@ -546,6 +717,7 @@ void setup() {
       delay(1000);
     }
   }
+  logBootStage("display ready");
 
   gWebService.setOnSettingsChanged(onSettingsChanged);
   gWebService.setOnWifiConnectRequested(onWifiConnectRequested);
@@ -553,18 +725,29 @@ void setup() {
   gWebService.setOnExitConfigRequested(onExitConfigRequested);
   gWebService.setRssRuntime(&gRssRuntime);
   gWebService.setOtaService(&gOtaService);
+  gWebService.setRadioBroker(&gRadioBroker);
+  gWebService.setDisplayPanel(&gDisplay);
+
+  const bool hasSavedWifi = gSettingsStore.settings().wifiSsid[0] != '\0';
+  if (hasSavedWifi) {
+    // Boot task owns the radio until it finishes; segments play cache only.
+    // Set before begin() so the RSS producer never starts a fetch of its own.
+    gRssRuntime.setSegmentNetworkEnabled(false);
+  }
 
   gWifiService.begin();
+  gRadioBroker.begin();
   gOtaService.begin(APP_FIRMWARE_VERSION);
   if (!gRssRuntime.begin()) {
     Serial.println("RSS runtime init failed");
   }
+  logBootStage("runtime ready");
 
-  const bool hasSavedWifi = gSettingsStore.settings().wifiSsid[0] != '\0';
-  const bool bootRefreshPlanned = hasSavedWifi && shouldRunBootRefresh();
-  gBootLoadingMode = bootRefreshPlanned;
+  gBootRefreshPlanned = hasSavedWifi && shouldRunBootRefresh();
+  // Cached content scrolls right away; the loading banner is only for a cold cache.
+  gBootLoadingMode = gBootRefreshPlanned && !gRssRuntime.cacheReady();
 
-  if (bootRefreshPlanned) {
+  if (gBootLoadingMode) {
     gScheduler.setConfigPromptText(kBootLoadingText);
     gScheduler.setMode(ContentMode::ConfigPrompt);
   } else {
@@ -572,12 +755,12 @@ void setup() {
   }
 
   applyRuntimeFromSettings(gSettingsStore.settings());
-  runBootOtaIfAvailable();
   gScheduler.setRssPlaceholder("Loading RSS feed cache", "Using message fallback");
   gScheduler.setRssSegmentProvider(provideRssSegment);
   gScheduler.setFallbackText("RSS unavailable fallback");
   gScheduler.begin(gScheduledMessages, APP_MAX_MESSAGES,
                    appScrollDelayForSpeed(gScrollSpeed), gPixelStep);
+  logBootStage("first segment started");
 
   // Performance mode: run WiFi/web only in config mode.
   // Boot directly into AP/config mode only when no WiFi credentials exist.
@@ -585,44 +768,44 @@ void setup() {
     gWifiService.startAp();
     gConfigMode = true;
     gWebService.begin();
-    gRssRuntime.setSuspended(false);
-    gRssRuntime.setRadioControlEnabled(false);
+    gRadioBroker.setRadioControlEnabled(false);
     gRssRuntime.forceRefreshSoon();
     refreshConfigPromptText(true);
     applySchedulerMode();
   } else {
-    // Normal scrolling mode: WiFi off and RSS refresh suspended for max smoothness.
+    // Normal scrolling mode: WiFi stays off outside radio-broker windows.
     gWifiService.stopWifi();
-    gRssRuntime.setRadioControlEnabled(true);
-    gRssRuntime.setSuspended(true);
-    if (bootRefreshPlanned) {
-      beginBootLoadingRefresh();
-    } else {
-      applySchedulerMode();
-    }
+    gRadioBroker.setRadioControlEnabled(true);
+    beginBootTasks();
   }
 
   printSerialHelp();
 }
 
 void loop() {
+  serviceBootProgress();
+  if (bootOtaInstallActive()) {
+    // Panel holds the static update banner while the boot task flashes.
+    delay(10);
+    return;
+  }
+
   handleSerialInput();
   handleConfigButton();
   if (gExitConfigRequested) {
     gExitConfigRequested = false;
     exitConfigMode();
   }
+  serviceConfigTransition();
+  gSettingsStore.tick();
 
+  // RSS refresh runs on the producer task in every mode.
   if (gConfigMode) {
-    gRssRuntime.setSuspended(false);
-    gRssRuntime.tick();
     gWifiService.tick();
     gWebService.tick();
     if ((millis() - gLastConfigPromptMs) > kConfigPromptRefreshMs) {
       refreshConfigPromptText(false);
     }
-  } else {
-    gRssRuntime.setSuspended(true);
   }
 
   gScroller.tick();